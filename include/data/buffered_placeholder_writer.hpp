@@ -23,29 +23,44 @@ SOFTWARE.
 #pragma once
 
 #include <atomic>
+#include <condition_variable>
 #include <switch/types.h>
 #include <memory>
+#include <mutex>
 
 #include "nx/ncm.hpp"
 #include "nx/nca_writer.h"
 
 namespace tin::data
 {
-    static const size_t BUFFER_SEGMENT_DATA_SIZE = 0x800000; // Approximately 8MB
-    extern int NUM_BUFFER_SEGMENTS;
+    static const size_t APPLET_BUFFER_MEMORY_BUDGET = 0x1000000; // 16MB
+    static const size_t FULL_BUFFER_MEMORY_BUDGET = 0x40000000; // 1GB
+
+    // Upper bound on segment memory for a single writer, lowered when running as an applet
+    extern size_t BUFFER_MEMORY_BUDGET;
+
+    // Where the data comes from, used to pick how deep the segment pipeline should be
+    enum class BufferSourceProfile
+    {
+        USB,
+        HTTP,
+    };
 
     struct BufferSegment
     {
         std::atomic_bool isFinalized = false;
         u64 writeOffset = 0;
-        u8 data[BUFFER_SEGMENT_DATA_SIZE] = {0};
+        u8* data = NULL; // Page aligned slice of the shared segment block
     };
 
-    // Receives data in a circular buffer split into 8MB segments
+    // Receives data in a circular buffer split into segments. The segment memory
+    // is sized per writer and reused between NCAs (see ReleaseSegmentMemory).
     class BufferedPlaceholderWriter
     {
         private:
             size_t m_totalDataSize = 0;
+            size_t m_segmentSize = 0;
+            u32 m_numSegments = 0;
             size_t m_sizeBuffered = 0;
             size_t m_sizeWrittenToPlaceholder = 0;
 
@@ -57,20 +72,50 @@ namespace tin::data
             BufferSegment* m_currentSegmentToWritePtr = NULL;
 
             std::unique_ptr<BufferSegment[]> m_bufferSegments;
+            u8* m_segmentMemory = NULL;
+            size_t m_segmentMemorySize = 0;
 
             std::shared_ptr<nx::ncm::ContentStorage> m_contentStorage;
             NcmContentId m_ncaId;
 			NcaWriter m_writer;
 
+            // Producers wait on m_canAppendCond, the placeholder writer waits on m_canWriteCond
+            std::mutex m_waitMutex;
+            std::condition_variable m_canAppendCond;
+            std::condition_variable m_canWriteCond;
+            bool m_aborted = false;
+
+            void NotifyWaiters(std::condition_variable& cond);
+
         public:
-            BufferedPlaceholderWriter(std::shared_ptr<nx::ncm::ContentStorage>& contentStorage, NcmContentId ncaId, size_t totalDataSize);
+            BufferedPlaceholderWriter(std::shared_ptr<nx::ncm::ContentStorage>& contentStorage, NcmContentId ncaId, size_t totalDataSize, BufferSourceProfile profile);
+            ~BufferedPlaceholderWriter();
+
+            // Frees the segment memory kept for the next writer
+            static void ReleaseSegmentMemory();
 
             void AppendData(void* source, size_t length);
             bool CanAppendData(size_t length);
 
+            // Zero-copy alternative to WaitForAppendSpace() + AppendData(). Blocks until the
+            // current free segment is available and returns the writable span inside it,
+            // capped to the data still expected. Returns false if aborted.
+            bool ReserveAppendSpan(u8** outPtr, size_t* outSize);
+            // Marks length bytes of the span returned by ReserveAppendSpan() as buffered
+            void CommitAppendSpan(size_t length);
+
             void WriteSegmentToPlaceholder();
             bool CanWriteSegmentToPlaceholder();
 
+            // Blocks until data of this size can be appended. Returns false if aborted.
+            bool WaitForAppendSpace(size_t length);
+            // Blocks until a finalized segment is ready to be written. Returns false if
+            // aborted or if the placeholder is already complete.
+            bool WaitForSegmentToWrite();
+            // Wakes all waiting producers and consumers, causing their waits to fail
+            void Abort();
+            bool IsAborted();
+
             // Determine the number of segments required to fit data of this size
             u32 CalcNumSegmentsRequired(size_t size);
 
@@ -83,6 +128,8 @@ namespace tin::data
             size_t GetTotalDataSize();
             size_t GetSizeBuffered();
             size_t GetSizeWrittenToPlaceholder();
+            size_t GetSegmentSize();
+            u32 GetNumSegments();
 
             void DebugPrintBuffers();
 
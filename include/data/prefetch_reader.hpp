@@ -0,0 +1,78 @@
+/*
+Copyright (c) 2017-2018 Adubbz
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <switch/types.h>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tin::data
+{
+    // Reads a byte range on a background thread into a ring of aligned buffers,
+    // so the consumer can process one chunk while the following ones are read
+    class PrefetchReader
+    {
+        public:
+            using ReadFunc = std::function<void (void* buf, u64 offset, size_t size)>;
+
+            PrefetchReader(ReadFunc readFunc, u64 offset, u64 size, u32 depth, size_t chunkSize);
+            ~PrefetchReader();
+
+            // Waits for the next chunk in order and releases the previous one back to the ring.
+            // Returns false once the whole range has been consumed. Rethrows errors from readFunc.
+            bool Next(const u8*& data, size_t& size);
+
+            // Stops the reader thread early. Safe to call more than once.
+            void Stop();
+
+        private:
+            void ReadThreadFunc();
+
+            ReadFunc m_readFunc;
+            u64 m_offset;
+            u64 m_size;
+            size_t m_chunkSize;
+
+            std::vector<u8*> m_buffers;
+            std::vector<size_t> m_bufferSizes;
+
+            std::mutex m_mutex;
+            std::condition_variable m_canRead;
+            std::condition_variable m_canConsume;
+            size_t m_numFilled = 0;     // Includes the chunk held by the consumer
+            size_t m_nextReadSlot = 0;
+            size_t m_nextConsumeSlot = 0;
+            u64 m_sizeConsumed = 0;
+            bool m_holdingChunk = false;
+            bool m_readDone = false;
+            bool m_stop = false;
+            std::exception_ptr m_readError = nullptr;
+
+            std::thread m_thread;
+    };
+}
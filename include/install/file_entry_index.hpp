@@ -0,0 +1,59 @@
+/*
+Copyright (c) 2017-2018 Adubbz
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <switch/types.h>
+#include "nx/ncm.hpp"
+
+namespace tin::install
+{
+    // Name, NCA id and extension lookups over the entries of a PFS0/HFS0 header, built once per header
+    class FileEntryIndex
+    {
+        private:
+            struct NcaEntry
+            {
+                u32 index;
+                u32 priority;
+            };
+
+            std::unordered_map<std::string, u32> m_byName;
+            std::unordered_map<std::string, NcaEntry> m_byNcaId;
+            std::unordered_map<std::string, std::vector<u32>> m_byExtension;
+
+        public:
+            static constexpr u32 NOT_FOUND = 0xFFFFFFFF;
+
+            void Build(u32 numFiles, const char* stringTable, size_t stringTableSize, const std::function<u32(u32)>& getStringTableOffset);
+            void Clear();
+
+            u32 FindByName(const std::string& name) const;
+            u32 FindByNcaId(const NcmContentId& ncaId) const;
+            const std::vector<u32>& FindByExtension(const std::string& extension) const;
+    };
+}
\ No newline at end of file
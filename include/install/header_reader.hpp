@@ -0,0 +1,53 @@
+/*
+Copyright (c) 2017-2018 Adubbz
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include <switch/types.h>
+
+namespace tin::install
+{
+    // Serves container header reads from one speculative read-ahead window, so the base header,
+    // file table and string table normally cost a single round trip to the source
+    class HeaderReader
+    {
+        private:
+            std::function<void (void* buf, off_t offset, size_t size)> m_bufferFunc;
+            size_t m_windowSize;
+            std::vector<u8> m_window;
+            u64 m_windowOffset = 0;
+            u32 m_roundTrips = 0;
+
+            void Fetch(void* buf, u64 offset, size_t size);
+
+        public:
+            HeaderReader(std::function<void (void* buf, off_t offset, size_t size)> bufferFunc, size_t windowSize);
+
+            void Read(void* buf, u64 offset, size_t size);
+            u32 GetRoundTrips() const;
+
+            static size_t GetConfiguredWindowSize();
+    };
+}
\ No newline at end of file
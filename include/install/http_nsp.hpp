@@ -24,18 +24,34 @@ SOFTWARE.
 
 #include "install/nsp.hpp"
 #include <memory>
+#include <vector>
 
 namespace tin::install::nsp
 {
     class HTTPNSP : public NSP
     {
+        private:
+            struct PrefetchedRange
+            {
+                u64 offset;
+                std::vector<u8> data;
+            };
+
+            // Only written before the NSP is handed to an installer, so reads need no locking
+            std::vector<PrefetchedRange> m_prefetchedRanges;
+
         public:
             tin::network::HTTPDownload m_download;
             std::string m_displayName;
+            std::string m_sourceName = "http";
 
             HTTPNSP(std::string url);
 
             virtual void StreamToPlaceholder(std::shared_ptr<nx::ncm::ContentStorage>& contentStorage, NcmContentId placeholderId) override;
             virtual void BufferData(void* buf, off_t offset, size_t size) override;
+            virtual std::string GetSourceName() override;
+
+            // Downloads a range now so a later BufferData inside it is served from memory
+            void PrefetchRange(u64 offset, size_t size);
     };
 }
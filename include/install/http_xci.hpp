@@ -32,10 +32,12 @@ namespace tin::install::xci
     {
         public:
             tin::network::HTTPDownload m_download;
+            std::string m_sourceName = "http";
 
             HTTPXCI(std::string url);
 
             virtual void StreamToPlaceholder(std::shared_ptr<nx::ncm::ContentStorage>& contentStorage, NcmContentId placeholderId) override;
             virtual void BufferData(void* buf, off_t offset, size_t size) override;
+            virtual std::string GetSourceName() override;
     };
 }
\ No newline at end of file
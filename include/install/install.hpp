@@ -42,12 +42,18 @@ namespace tin::install
     class Install
     {
         protected:
+            // Meta NCAs up to this size are read into memory to parse their cnmt
+            static constexpr size_t MAX_IN_MEMORY_CNMT_NCA_SIZE = 0x1000000; // 16MB
+
             const NcmStorageId m_destStorageId;
             bool m_ignoreReqFirmVersion = false;
             bool m_declinedValidation = false;
+            bool m_ncasPrevalidated = false;
 
             std::vector<nx::ncm::ContentMeta> m_contentMeta;
             std::vector<NcmContentId> m_sessionInstalledNcas;
+            // Meta NCAs not in content storage yet, installed by Begin() with the other NCAs
+            std::vector<NcmContentId> m_pendingCnmtNcas;
 
             Install(NcmStorageId destStorageId, bool ignoreReqFirmVersion);
 
@@ -57,9 +63,16 @@ namespace tin::install
             void CleanupSessionInstalledNcas();
 
             virtual void InstallContentMetaRecords(tin::data::ByteBuffer& installContentMetaBuf, int i);
+            void CommitContentMetaRecords(std::vector<tin::data::ByteBuffer>& installContentMetaBufs);
             virtual void InstallApplicationRecord(int i);
             virtual void InstallTicketCert() = 0;
             virtual void InstallNCA(const NcmContentId &ncaId) = 0;
+            virtual void ValidateNCA(const NcmContentId &ncaId);
+
+            virtual bool CanInstallNcasConcurrently();
+            virtual bool IsCompressedNca(const NcmContentId &ncaId);
+            virtual u64 GetNcaSize(const NcmContentId &ncaId);
+            void InstallNcasConcurrently(const std::vector<NcmContentId>& ncaIds, u32 workerCount);
 
         public:
             virtual ~Install();
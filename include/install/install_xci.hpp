@@ -38,6 +38,10 @@ namespace tin::install::xci
         protected:
             std::vector<std::tuple<nx::ncm::ContentMeta, NcmContentInfo>> ReadCNMT() override;
             void InstallNCA(const NcmContentId& ncaId) override;
+            void ValidateNCA(const NcmContentId& ncaId) override;
+            bool CanInstallNcasConcurrently() override;
+            bool IsCompressedNca(const NcmContentId& ncaId) override;
+            u64 GetNcaSize(const NcmContentId& ncaId) override;
             void InstallTicketCert() override;
 
         public:
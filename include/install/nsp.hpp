@@ -23,9 +23,11 @@ SOFTWARE.
 #pragma once
 
 #include <functional>
+#include <string>
 #include <vector>
 
 #include <switch/types.h>
+#include "install/file_entry_index.hpp"
 #include "install/pfs0.hpp"
 #include "nx/ncm.hpp"
 #include "util/network_util.hpp"
@@ -36,14 +38,20 @@ namespace tin::install::nsp
     {
         protected:
             std::vector<u8> m_headerBytes;
+            FileEntryIndex m_fileIndex;
+            bool m_headerRetrieved = false;
 
             NSP();
 
         public:
             virtual void StreamToPlaceholder(std::shared_ptr<nx::ncm::ContentStorage>& contentStorage, NcmContentId placeholderId) = 0;
             virtual void BufferData(void* buf, off_t offset, size_t size) = 0;
+            virtual bool CanStreamConcurrently();
+            // Where the container is read from (sd, hdd, usb, http, shop), used to label diagnostics
+            virtual std::string GetSourceName();
 
             virtual void RetrieveHeader();
+            bool HasHeader();
             virtual const PFS0BaseHeader* GetBaseHeader();
             virtual u64 GetDataOffset();
 
@@ -22,6 +22,7 @@ SOFTWARE.
 
 #pragma once
 
+#include <mutex>
 #include "install/nsp.hpp"
 
 namespace tin::install::nsp
@@ -29,12 +30,16 @@ namespace tin::install::nsp
     class SDMCNSP : public NSP
     {
     public:
-        SDMCNSP(std::string path);
+        SDMCNSP(std::string path, std::string sourceName = "sd");
         ~SDMCNSP();
 
         virtual void StreamToPlaceholder(std::shared_ptr<nx::ncm::ContentStorage>& contentStorage, NcmContentId ncaId) override;
         virtual void BufferData(void* buf, off_t offset, size_t size) override;
+        virtual bool CanStreamConcurrently() override;
+        virtual std::string GetSourceName() override;
     private:
+        std::string m_sourceName;
         FILE* m_nspFile;
+        std::mutex m_fileMutex;
     };
 }
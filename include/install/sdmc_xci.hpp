@@ -22,6 +22,7 @@ SOFTWARE.
 
 #pragma once
 
+#include <mutex>
 #include "install/xci.hpp"
 
 namespace tin::install::xci
@@ -29,12 +30,16 @@ namespace tin::install::xci
     class SDMCXCI : public XCI
     {
     public:
-        SDMCXCI(std::string path);
+        SDMCXCI(std::string path, std::string sourceName = "sd");
         ~SDMCXCI();
 
         virtual void StreamToPlaceholder(std::shared_ptr<nx::ncm::ContentStorage>& contentStorage, NcmContentId ncaId) override;
         virtual void BufferData(void* buf, off_t offset, size_t size) override;
+        virtual bool CanStreamConcurrently() override;
+        virtual std::string GetSourceName() override;
     private:
+        std::string m_sourceName;
         FILE* m_xciFile;
+        std::mutex m_fileMutex;
     };
 }
\ No newline at end of file
@@ -37,5 +37,6 @@ namespace tin::install::nsp
 
             virtual void StreamToPlaceholder(std::shared_ptr<nx::ncm::ContentStorage>& contentStorage, NcmContentId placeholderId) override;
             virtual void BufferData(void* buf, off_t offset, size_t size) override;
+            virtual std::string GetSourceName() override;
     };
 }
\ No newline at end of file
@@ -23,9 +23,11 @@ SOFTWARE.
 #pragma once
 
 #include <functional>
+#include <string>
 #include <vector>
 
 #include <switch/types.h>
+#include "install/file_entry_index.hpp"
 #include "install/hfs0.hpp"
 #include "nx/ncm.hpp"
 #include <memory>
@@ -37,12 +39,16 @@ namespace tin::install::xci
         protected:
             u64 m_secureHeaderOffset;
             std::vector<u8> m_secureHeaderBytes;
+            FileEntryIndex m_fileIndex;
 
             XCI();
 
         public:
             virtual void StreamToPlaceholder(std::shared_ptr<nx::ncm::ContentStorage>& contentStorage, NcmContentId placeholderId) = 0;
             virtual void BufferData(void* buf, off_t offset, size_t size) = 0;
+            virtual bool CanStreamConcurrently();
+            // Where the container is read from (sd, hdd, usb, http, shop), used to label diagnostics
+            virtual std::string GetSourceName();
 
             virtual void RetrieveHeader();
             virtual const HFS0BaseHeader* GetSecureHeader();
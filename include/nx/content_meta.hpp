@@ -60,14 +60,22 @@ namespace nx::ncm
         private:
             tin::data::ByteBuffer m_bytes;
 
+            // Parsed once on construction, the raw bytes are only kept for reference
+            PackagedContentMetaHeader m_header;
+            std::vector<u8> m_extendedHeader;
+            std::vector<NcmContentInfo> m_contentInfos;
+            u32 m_extendedDataSize = 0;
+
+            void Parse();
+
         public:
             ContentMeta();
             ContentMeta(u8* data, size_t size);
 
-            PackagedContentMetaHeader GetPackagedContentMetaHeader();
-            NcmContentMetaKey GetContentMetaKey();
-            std::vector<NcmContentInfo> GetContentInfos();
+            PackagedContentMetaHeader GetPackagedContentMetaHeader() const;
+            NcmContentMetaKey GetContentMetaKey() const;
+            const std::vector<NcmContentInfo>& GetContentInfos() const;
 
-            void GetInstallContentMeta(tin::data::ByteBuffer& installContentMetaBuffer, NcmContentInfo& cnmtContentInfo, bool ignoreReqFirmVersion);
+            void GetInstallContentMeta(tin::data::ByteBuffer& installContentMetaBuffer, NcmContentInfo& cnmtContentInfo, bool ignoreReqFirmVersion) const;
     };
 }
\ No newline at end of file
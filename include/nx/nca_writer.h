@@ -48,10 +48,14 @@ private:
 // Simple call-back Writer with no life-cycle methods
 using WriterFn = void(const u8* data, u64 size);
 
+class PlaceholderWriteQueue;
+
 class NcaBodyWriter : public CloseableWriter, public std::enable_shared_from_this<NcaBodyWriter>
 {
 public:
 	static constexpr u64 CONTENT_BUFFER_SIZE = 0x800000; // 8MB
+	// Most one writer holds at once: content buffer, two queued placeholder writes and the staging buffer they are coalesced into
+	static constexpr u64 MAX_BUFFERED_SIZE = CONTENT_BUFFER_SIZE * 5;
 
 	NcaBodyWriter(const NcmContentId& ncaId, u64 offset, std::shared_ptr<nx::ncm::ContentStorage>& contentStorage);
 	~NcaBodyWriter() override;
@@ -86,6 +90,9 @@ protected:
 	NcmContentId m_ncaId;
 
 	u64 m_offset;
+
+	// Writes flushed buffers to the placeholder on its own thread
+	std::unique_ptr<PlaceholderWriteQueue> m_writeQueue;
 };
 
 class NcaWriter : public CloseableWriter
@@ -98,6 +105,9 @@ public:
 	void write(const  u8* ptr, u64 sz) override;
 	void flushHeader();
 
+	// Frees the ZSTD contexts kept for reuse between NCZs; call once the install session ends
+	static void ReleaseDecompressionContexts();
+
 protected:
 	NcmContentId m_ncaId;
 	std::shared_ptr<nx::ncm::ContentStorage> m_contentStorage;
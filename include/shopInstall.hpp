@@ -37,6 +37,7 @@ namespace shopInstStuff {
 
     std::vector<ShopItem> FetchShop(const std::string& shopUrl, const std::string& user, const std::string& pass, std::string& error, const ShopFetchProgressCallback& progressCb = ShopFetchProgressCallback());
     std::vector<ShopSection> FetchShopSections(const std::string& shopUrl, const std::string& user, const std::string& pass, std::string& error, bool* outUsedLegacyFallback = nullptr, const ShopFetchProgressCallback& progressCb = ShopFetchProgressCallback());
+    bool LoadCachedShopSections(const std::string& shopUrl, const std::string& user, const std::string& pass, std::vector<ShopSection>& outSections);
     std::string FetchShopMotd(const std::string& shopUrl, const std::string& user, const std::string& pass);
     void installTitleShop(const std::vector<ShopItem>& items, int storage, const std::string& sourceLabel);
 }
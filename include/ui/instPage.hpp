@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <cstdint>
 #include <chrono>
 #include <pu/Plutonium>
@@ -53,6 +54,8 @@ namespace inst::ui {
             static void requestInstallCancel();
             static bool isInstallCancelRequested();
             static void clearInstallCancel();
+            static void setProgressMutedOnThisThread(bool muted);
+            static void setProgressSinkOnThisThread(std::atomic<double>* sink);
         private:
             bool touchWakeActive = false;
             Rectangle::Ref infoRect;
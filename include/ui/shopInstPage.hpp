@@ -24,6 +24,7 @@ namespace inst::ui {
             PU_SMART_CTOR(shopInstPage)
             void startShop(bool forceRefresh = false);
             void startInstall();
+            void stopCatalogRevalidation();
             void onInput(u64 Down, u64 Up, u64 Held, pu::ui::Touch Pos);
             TextBlock::Ref pageInfoText;
             TextBlock::Ref loadingProgressText;
@@ -77,6 +78,13 @@ namespace inst::ui {
             bool catalogCacheUsedLegacyFallback = false;
             std::string catalogCacheKey;
             std::vector<shopInstStuff::ShopSection> catalogCacheSections;
+            std::thread catalogRevalidateThread;
+            std::atomic<bool> catalogRevalidateDone{false};
+            bool catalogRevalidateOk = false;
+            bool catalogRevalidateSuperseded = false;
+            bool catalogRevalidateUsedLegacyFallback = false;
+            std::string catalogRevalidateKey;
+            std::vector<shopInstStuff::ShopSection> catalogRevalidateSections;
             BrowseSortMode browseSortMode = BrowseSortMode::Default;
             BottomHintTouchState bottomHintTouch;
             std::vector<BottomHintSegment> bottomHintSegments;
@@ -241,6 +249,8 @@ namespace inst::ui {
             void queueIconDownload(const shopInstStuff::ShopItem& item, const std::string& filePath);
             void refreshImageLoadingText(bool showCompleted = false);
             void iconDownloadThreadMain();
+            void startCatalogRevalidation(const std::string& shopUrl, const std::string& cacheKey);
+            void finishCatalogRevalidation();
             bool buildInstalledSnapshot();
             void ensureInstalledSectionPlaceholder();
             bool ensureInstalledSectionBuilt();
@@ -47,6 +47,17 @@ namespace inst::config {
     extern bool shopStartGridMode;
     extern bool offlineDbAutoCheckOnStartup;
     extern bool verboseInstallLogging;
+    extern int nczDecompressThreads;
+    extern int httpRangeConnections;
+    extern int localReadAheadDepth;
+    extern int localReadChunkMb;
+    extern int concurrentNcaInstalls;
+    extern int zstdOutputWindowMb;
+    extern int bufferSegmentMb;
+    extern int headerReadAheadKb;
+    extern int shopPrefetchDepth;
+    extern bool shopCatalogCache;
+    extern bool shopCatalogStaleWhileRevalidate;
 
     struct ShopProfile {
         std::string fileName;
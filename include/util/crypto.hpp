@@ -151,4 +151,13 @@ namespace Crypto
     protected:
         Aes128XtsContext ctx;
     };
+
+    /* The NCA header key is derived through spl once per install session; callers get a copy of the prepared XTS context. */
+    AesXtr GetHeaderDecryptor();
+    AesXtr GetHeaderEncryptor();
+    /* Must be called before spl is shut down so the next session derives the key again. */
+    void InvalidateHeaderKey();
+
+    /* Unwraps one key of an NCA key area with the key area key selected by kaekIndex and keyGeneration. */
+    void DecryptNcaKeyAreaKey(u8 kaekIndex, u8 keyGeneration, const u8* encryptedKey, u8* outKey);
 }
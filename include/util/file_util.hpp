@@ -32,5 +32,7 @@ namespace tin::util
 {
     NcmContentInfo CreateNSPCNMTContentRecord(const std::string& nspPath);
     nx::ncm::ContentMeta GetContentMetaFromNCA(const std::string& ncaPath);
+    // Parses the cnmt out of a meta NCA held in memory, without installing or mounting it
+    nx::ncm::ContentMeta GetContentMetaFromNCAData(const u8* ncaData, size_t ncaSize);
     std::vector<std::string> GetNSPList();
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace inst::diag {
@@ -20,6 +21,7 @@ namespace inst::diag {
     void NoteTransferReceived(const std::string& item);
     void NoteInstallStarted(const std::string& item);
     void NoteStep(const std::string& step, bool verboseOnly = true);
+    void NoteThroughput(const std::string& source, const std::string& item, std::uint64_t bytes, double seconds);
     void RecordSuccess(const std::string& item);
 
     InstallFailure ClassifyFailure(const std::string& errorText);
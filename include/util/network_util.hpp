@@ -29,6 +29,7 @@ SOFTWARE.
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <functional>
 #include <map>
 #include <memory>
@@ -79,19 +80,30 @@ namespace tin::network
             bool m_isJbod = false;
             size_t m_jbodSize = 0;
             std::vector<JbodSegment> m_jbodSegments;
+            const std::atomic<bool>* m_abortFlag = nullptr;
 
             static size_t ParseHTMLData(char* bytes, size_t size, size_t numItems, void* userData);
 
         public:
             HTTPDownload(std::string url);
+
+            // While the flag is set, range reads stop at the next received chunk or retry and fail.
+            // The flag must outlive the download or be cleared again with nullptr.
+            void SetAbortFlag(const std::atomic<bool>* abortFlag);
     
             void BufferDataRange(void* buffer, size_t offset, size_t size, std::function<void (size_t sizeRead)> progressFunc);
             int StreamDataRange(size_t offset, size_t size, std::function<size_t (u8* bytes, size_t size)> streamFunc, std::function<bool()> retryConfirmFunc = nullptr);
+            // Fetches the range as parts over several connections, but still calls streamFunc strictly in order.
+            // Falls back to StreamDataRange for a single connection or small ranges.
+            int StreamDataRangeParallel(size_t offset, size_t size, u32 connectionCount, std::function<size_t (u8* bytes, size_t size)> streamFunc, std::function<bool()> retryConfirmFunc = nullptr);
     };
 
     void SetBasicAuth(const std::string& user, const std::string& pass);
     void ClearBasicAuth();
 
+    // Closes pooled keep-alive range connections and drops cached request headers
+    void CloseHttpRangeSession();
+
     void NSULDrop(std::string url);
 
     size_t WaitReceiveNetworkData(int sockfd, void* buf, size_t len);
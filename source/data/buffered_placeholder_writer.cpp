@@ -23,29 +23,117 @@ SOFTWARE.
 #include "data/buffered_placeholder_writer.hpp"
 
 #include <climits>
-#include <math.h>
+#include <malloc.h>
 #include <algorithm>
 #include <exception>
+#include "util/config.hpp"
 #include "util/error.hpp"
 #include "util/debug.h"
 
 namespace tin::data
 {
-    int NUM_BUFFER_SEGMENTS;
+    size_t BUFFER_MEMORY_BUDGET = APPLET_BUFFER_MEMORY_BUDGET;
 
-    BufferedPlaceholderWriter::BufferedPlaceholderWriter(std::shared_ptr<nx::ncm::ContentStorage>& contentStorage, NcmContentId ncaId, size_t totalDataSize) :
+    // USB tops out well below what the SD card can absorb, so a shallow pipeline is
+    // enough there. HTTP is burstier and benefits from a deeper one.
+    static const size_t USB_PROFILE_MEMORY_BUDGET = 0x4000000; // 64MB
+    static const size_t HTTP_PROFILE_MEMORY_BUDGET = 0x20000000; // 512MB
+
+    // The segment block of the previous writer is kept so consecutive NCAs can reuse
+    // it instead of allocating again
+    static std::mutex g_segmentMemoryMutex;
+    static u8* g_segmentMemory = NULL;
+    static size_t g_segmentMemorySize = 0;
+
+    static u8* AcquireSegmentMemory(size_t size, size_t* outSize)
+    {
+        u8* stale = NULL;
+        {
+            std::lock_guard<std::mutex> lock(g_segmentMemoryMutex);
+            // Reuse the cached block unless it is too small or far larger than needed
+            if (g_segmentMemory && g_segmentMemorySize >= size && g_segmentMemorySize / 4 <= size)
+            {
+                u8* mem = g_segmentMemory;
+                *outSize = g_segmentMemorySize;
+                g_segmentMemory = NULL;
+                g_segmentMemorySize = 0;
+                return mem;
+            }
+
+            stale = g_segmentMemory;
+            g_segmentMemory = NULL;
+            g_segmentMemorySize = 0;
+        }
+
+        // Drop the unsuitable block before allocating so both never coexist
+        free(stale);
+
+        u8* mem = (u8*)memalign(0x1000, size);
+        if (mem == NULL)
+            THROW_FORMAT("Failed to allocate %zu bytes of buffer segments!\n", size);
+
+        *outSize = size;
+        return mem;
+    }
+
+    static void RecycleSegmentMemory(u8* mem, size_t size)
+    {
+        u8* stale = NULL;
+        {
+            std::lock_guard<std::mutex> lock(g_segmentMemoryMutex);
+            stale = g_segmentMemory;
+            g_segmentMemory = mem;
+            g_segmentMemorySize = size;
+        }
+        free(stale);
+    }
+
+    void BufferedPlaceholderWriter::ReleaseSegmentMemory()
+    {
+        RecycleSegmentMemory(NULL, 0);
+    }
+
+    BufferedPlaceholderWriter::BufferedPlaceholderWriter(std::shared_ptr<nx::ncm::ContentStorage>& contentStorage, NcmContentId ncaId, size_t totalDataSize, BufferSourceProfile profile) :
         m_totalDataSize(totalDataSize), m_contentStorage(contentStorage), m_ncaId(ncaId), m_writer(ncaId, contentStorage)
     {
-        // Though currently the number of segments is fixed, we want them allocated on the heap, not the stack
-        m_bufferSegments = std::make_unique<BufferSegment[]>(NUM_BUFFER_SEGMENTS);
+        m_segmentSize = (size_t)std::clamp(inst::config::bufferSegmentMb, 1, 16) * 0x100000;
+
+        // Never allocate more segments than the NCA can fill, but keep at least two
+        // so receiving and writing can overlap
+        const size_t profileBudget = profile == BufferSourceProfile::USB ? USB_PROFILE_MEMORY_BUDGET : HTTP_PROFILE_MEMORY_BUDGET;
+        const size_t budget = std::min(BUFFER_MEMORY_BUDGET, profileBudget);
+        // Two segments must fit in the budget, so shrink them (page aligned) when it is tight
+        if (budget / 2 < m_segmentSize)
+            m_segmentSize = std::max<size_t>((budget / 2) & ~(size_t)0xFFF, 0x1000);
+        const size_t segmentsNeeded = std::max<size_t>((totalDataSize + m_segmentSize - 1) / m_segmentSize, 1);
+        const size_t segmentsAllowed = std::max<size_t>(budget / m_segmentSize, 2);
+        m_numSegments = (u32)std::min(segmentsNeeded, segmentsAllowed);
+
+        m_bufferSegments = std::make_unique<BufferSegment[]>(m_numSegments);
+        m_segmentMemory = AcquireSegmentMemory(m_segmentSize * m_numSegments, &m_segmentMemorySize);
 
-        if (m_bufferSegments == nullptr)
-            THROW_FORMAT("Failed to allocated buffer segments!\n");
+        for (u32 i = 0; i < m_numSegments; i++)
+            m_bufferSegments[i].data = m_segmentMemory + m_segmentSize * i;
 
         m_currentFreeSegmentPtr = &m_bufferSegments[m_currentFreeSegment];
         m_currentSegmentToWritePtr = &m_bufferSegments[m_currentSegmentToWrite];
     }
 
+    BufferedPlaceholderWriter::~BufferedPlaceholderWriter()
+    {
+        RecycleSegmentMemory(m_segmentMemory, m_segmentMemorySize);
+    }
+
+    void BufferedPlaceholderWriter::NotifyWaiters(std::condition_variable& cond)
+    {
+        // Waiters evaluate their predicate under the mutex, so taking it here before
+        // notifying guarantees the state change above can't slip between their check and wait
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+        }
+        cond.notify_all();
+    }
+
     void BufferedPlaceholderWriter::AppendData(void* source, size_t length)
     {
         if (m_sizeBuffered + length > m_totalDataSize)
@@ -53,10 +141,11 @@ namespace tin::data
 
         size_t dataSizeRemaining = length;
         u64 sourceOffset = 0;
+        bool segmentFinalized = false;
 
         while (dataSizeRemaining > 0)
         {
-            size_t bufferSegmentSizeRemaining = BUFFER_SEGMENT_DATA_SIZE - m_currentFreeSegmentPtr->writeOffset;
+            size_t bufferSegmentSizeRemaining = m_segmentSize - m_currentFreeSegmentPtr->writeOffset;
 
             if (m_currentFreeSegmentPtr->isFinalized)
                 THROW_FORMAT("Current buffer segment is already finalized!\n");
@@ -75,8 +164,9 @@ namespace tin::data
                 sourceOffset += bufferSegmentSizeRemaining;
                 m_currentFreeSegmentPtr->writeOffset += bufferSegmentSizeRemaining;
                 m_currentFreeSegmentPtr->isFinalized = true;
+                segmentFinalized = true;
 
-                m_currentFreeSegment = (m_currentFreeSegment + 1) % NUM_BUFFER_SEGMENTS;
+                m_currentFreeSegment = (m_currentFreeSegment + 1) % m_numSegments;
                 m_currentFreeSegmentPtr = &m_bufferSegments[m_currentFreeSegment];
             }
         }
@@ -86,7 +176,60 @@ namespace tin::data
         if (m_sizeBuffered == m_totalDataSize)
         {
             m_currentFreeSegmentPtr->isFinalized = true;
+            segmentFinalized = true;
+        }
+
+        if (segmentFinalized)
+            this->NotifyWaiters(m_canWriteCond);
+    }
+
+    bool BufferedPlaceholderWriter::ReserveAppendSpan(u8** outPtr, size_t* outSize)
+    {
+        if (m_sizeBuffered >= m_totalDataSize)
+            THROW_FORMAT("Cannot reserve append space as all data has been buffered.\n");
+
+        {
+            std::unique_lock<std::mutex> lock(m_waitMutex);
+            m_canAppendCond.wait(lock, [&]() { return m_aborted || !m_currentFreeSegmentPtr->isFinalized; });
+            if (m_aborted)
+                return false;
         }
+
+        size_t bufferSegmentSizeRemaining = m_segmentSize - m_currentFreeSegmentPtr->writeOffset;
+        *outPtr = m_currentFreeSegmentPtr->data + m_currentFreeSegmentPtr->writeOffset;
+        *outSize = std::min(bufferSegmentSizeRemaining, m_totalDataSize - m_sizeBuffered);
+        return true;
+    }
+
+    void BufferedPlaceholderWriter::CommitAppendSpan(size_t length)
+    {
+        if (m_sizeBuffered + length > m_totalDataSize)
+            THROW_FORMAT("Cannot append data as it would exceed the expected total.\n");
+
+        if (m_currentFreeSegmentPtr->isFinalized || m_currentFreeSegmentPtr->writeOffset + length > m_segmentSize)
+            THROW_FORMAT("Committed length exceeds the reserved span!\n");
+
+        bool segmentFinalized = false;
+        m_currentFreeSegmentPtr->writeOffset += length;
+        m_sizeBuffered += length;
+
+        if (m_currentFreeSegmentPtr->writeOffset == m_segmentSize)
+        {
+            m_currentFreeSegmentPtr->isFinalized = true;
+            segmentFinalized = true;
+
+            m_currentFreeSegment = (m_currentFreeSegment + 1) % m_numSegments;
+            m_currentFreeSegmentPtr = &m_bufferSegments[m_currentFreeSegment];
+        }
+
+        if (m_sizeBuffered == m_totalDataSize)
+        {
+            m_currentFreeSegmentPtr->isFinalized = true;
+            segmentFinalized = true;
+        }
+
+        if (segmentFinalized)
+            this->NotifyWaiters(m_canWriteCond);
     }
 
     bool BufferedPlaceholderWriter::CanAppendData(size_t length)
@@ -110,14 +253,18 @@ namespace tin::data
 
         // NOTE: The final segment will have leftover data from previous writes, however
         // this will be accounted for by this size
-        size_t sizeToWriteToPlaceholder = std::min(m_totalDataSize - m_sizeWrittenToPlaceholder, BUFFER_SEGMENT_DATA_SIZE);
+        size_t sizeToWriteToPlaceholder = std::min(m_totalDataSize - m_sizeWrittenToPlaceholder, m_segmentSize);
         m_writer.write(m_currentSegmentToWritePtr->data, sizeToWriteToPlaceholder);
 
-        m_currentSegmentToWritePtr->isFinalized = false;
+        // Reset the write offset before releasing the segment, producers treat a
+        // non-finalized segment as free
         m_currentSegmentToWritePtr->writeOffset = 0;
-        m_currentSegmentToWrite = (m_currentSegmentToWrite + 1) % NUM_BUFFER_SEGMENTS;
+        m_currentSegmentToWritePtr->isFinalized = false;
+        m_currentSegmentToWrite = (m_currentSegmentToWrite + 1) % m_numSegments;
         m_currentSegmentToWritePtr = &m_bufferSegments[m_currentSegmentToWrite];
         m_sizeWrittenToPlaceholder += sizeToWriteToPlaceholder;
+
+        this->NotifyWaiters(m_canAppendCond);
     }
 
     bool BufferedPlaceholderWriter::CanWriteSegmentToPlaceholder()
@@ -131,32 +278,64 @@ namespace tin::data
         return true;
     }
 
+    bool BufferedPlaceholderWriter::WaitForAppendSpace(size_t length)
+    {
+        if (m_sizeBuffered + length > m_totalDataSize)
+            THROW_FORMAT("Cannot append data as it would exceed the expected total.\n");
+
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        m_canAppendCond.wait(lock, [&]() { return m_aborted || this->IsSizeAvailable(length); });
+        return !m_aborted;
+    }
+
+    bool BufferedPlaceholderWriter::WaitForSegmentToWrite()
+    {
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        m_canWriteCond.wait(lock, [&]() {
+            return m_aborted || m_sizeWrittenToPlaceholder >= m_totalDataSize || m_currentSegmentToWritePtr->isFinalized;
+        });
+        return !m_aborted && this->CanWriteSegmentToPlaceholder();
+    }
+
+    void BufferedPlaceholderWriter::Abort()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+            m_aborted = true;
+        }
+        m_canAppendCond.notify_all();
+        m_canWriteCond.notify_all();
+    }
+
+    bool BufferedPlaceholderWriter::IsAborted()
+    {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        return m_aborted;
+    }
+
     u32 BufferedPlaceholderWriter::CalcNumSegmentsRequired(size_t size)
     {
         if (m_currentFreeSegmentPtr->isFinalized)
             return INT_MAX;
 
-        size_t bufferSegmentSizeRemaining = BUFFER_SEGMENT_DATA_SIZE - m_currentFreeSegmentPtr->writeOffset;
+        size_t bufferSegmentSizeRemaining = m_segmentSize - m_currentFreeSegmentPtr->writeOffset;
 
         if (size <= bufferSegmentSizeRemaining) return 1;
-        else 
-        {
-            double numSegmentsReq = 1 + (double)(size - bufferSegmentSizeRemaining) / (double)BUFFER_SEGMENT_DATA_SIZE;
-            return ceil(numSegmentsReq);
-        }
+
+        return 1 + (size - bufferSegmentSizeRemaining + m_segmentSize - 1) / m_segmentSize;
     }
 
     bool BufferedPlaceholderWriter::IsSizeAvailable(size_t size)
     {
         u32 numSegmentsRequired = this->CalcNumSegmentsRequired(size);
 
-        if ((int)numSegmentsRequired > NUM_BUFFER_SEGMENTS)
+        if (numSegmentsRequired > m_numSegments)
             return false;
 
         for (unsigned int i = 0; i < numSegmentsRequired; i++)
         {
             unsigned int segmentIndex = m_currentFreeSegment + i;
-            BufferSegment* bufferSegment = &m_bufferSegments[segmentIndex % NUM_BUFFER_SEGMENTS];
+            BufferSegment* bufferSegment = &m_bufferSegments[segmentIndex % m_numSegments];
 
             if (bufferSegment->isFinalized)
                 return false;
@@ -199,6 +378,16 @@ namespace tin::data
         return m_sizeWrittenToPlaceholder;
     }
 
+    size_t BufferedPlaceholderWriter::GetSegmentSize()
+    {
+        return m_segmentSize;
+    }
+
+    u32 BufferedPlaceholderWriter::GetNumSegments()
+    {
+        return m_numSegments;
+    }
+
     void BufferedPlaceholderWriter::close()
     {
         m_writer.close();
@@ -208,10 +397,10 @@ namespace tin::data
     {
         LOG_DEBUG("BufferedPlaceholderWriter Buffers: \n");
 
-        for (int i = 0; i < NUM_BUFFER_SEGMENTS; i++)
+        for (u32 i = 0; i < m_numSegments; i++)
         {
             LOG_DEBUG("Buffer %u:\n", i);
-            printBytes(m_bufferSegments[i].data, BUFFER_SEGMENT_DATA_SIZE, true);
+            printBytes(m_bufferSegments[i].data, m_segmentSize, true);
         }
     }
 }
\ No newline at end of file
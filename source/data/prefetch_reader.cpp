@@ -0,0 +1,152 @@
+/*
+Copyright (c) 2017-2018 Adubbz
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#include "data/prefetch_reader.hpp"
+
+#include <algorithm>
+#include <malloc.h>
+#include "util/error.hpp"
+#include "util/debug.h"
+
+namespace tin::data
+{
+    PrefetchReader::PrefetchReader(ReadFunc readFunc, u64 offset, u64 size, u32 depth, size_t chunkSize) :
+        m_readFunc(readFunc), m_offset(offset), m_size(size), m_chunkSize(chunkSize)
+    {
+        if (!m_readFunc)
+            THROW_FORMAT("PrefetchReader: ReadFunc cannot be null\n");
+        if (m_chunkSize == 0)
+            THROW_FORMAT("PrefetchReader: chunk size cannot be zero\n");
+
+        // One buffer is held by the consumer, so at least two are needed to overlap
+        depth = std::max<u32>(depth, 2);
+        for (u32 i = 0; i < depth; i++)
+        {
+            u8* buf = (u8*)memalign(0x1000, m_chunkSize);
+            if (buf == nullptr)
+            {
+                for (u8* allocated : m_buffers)
+                    free(allocated);
+                THROW_FORMAT("PrefetchReader: failed to allocate read buffers\n");
+            }
+            m_buffers.push_back(buf);
+        }
+        m_bufferSizes.resize(depth, 0);
+
+        m_thread = std::thread([this]() { this->ReadThreadFunc(); });
+    }
+
+    PrefetchReader::~PrefetchReader()
+    {
+        this->Stop();
+
+        for (u8* buf : m_buffers)
+            free(buf);
+    }
+
+    void PrefetchReader::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_canRead.notify_all();
+
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+    void PrefetchReader::ReadThreadFunc()
+    {
+        u64 sizeRead = 0;
+
+        try
+        {
+            while (sizeRead < m_size)
+            {
+                size_t slot = 0;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_canRead.wait(lock, [&]() { return m_stop || m_numFilled < m_buffers.size(); });
+                    if (m_stop)
+                        break;
+                    slot = m_nextReadSlot;
+                }
+
+                // The slot is free, so it can be filled without holding the lock
+                const size_t readSize = (size_t)std::min<u64>(m_chunkSize, m_size - sizeRead);
+                m_readFunc(m_buffers[slot], m_offset + sizeRead, readSize);
+                sizeRead += readSize;
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_bufferSizes[slot] = readSize;
+                    m_nextReadSlot = (m_nextReadSlot + 1) % m_buffers.size();
+                    m_numFilled++;
+                }
+                m_canConsume.notify_one();
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_readError = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_readDone = true;
+        }
+        m_canConsume.notify_one();
+    }
+
+    bool PrefetchReader::Next(const u8*& data, size_t& size)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if (m_holdingChunk)
+        {
+            m_holdingChunk = false;
+            m_nextConsumeSlot = (m_nextConsumeSlot + 1) % m_buffers.size();
+            m_numFilled--;
+            m_canRead.notify_one();
+        }
+
+        if (m_sizeConsumed >= m_size)
+            return false;
+
+        m_canConsume.wait(lock, [&]() { return m_numFilled > 0 || m_readDone; });
+        if (m_numFilled == 0)
+        {
+            if (m_readError)
+                std::rethrow_exception(m_readError);
+            THROW_FORMAT("PrefetchReader: reader stopped before the end of the range\n");
+        }
+
+        data = m_buffers[m_nextConsumeSlot];
+        size = m_bufferSizes[m_nextConsumeSlot];
+        m_sizeConsumed += size;
+        m_holdingChunk = true;
+        return true;
+    }
+}
@@ -0,0 +1,111 @@
+/*
+Copyright (c) 2017-2018 Adubbz
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "install/file_entry_index.hpp"
+
+#include <cstring>
+#include "util/title_util.hpp"
+
+namespace tin::install
+{
+    namespace
+    {
+        // Same preference order the linear lookups used
+        const char* const NCA_SUFFIXES[] = { ".nca", ".cnmt.nca", ".ncz", ".cnmt.ncz" };
+        constexpr size_t NCA_ID_STRING_LENGTH = 32;
+
+        bool IsLowerHex(const std::string& str, size_t length)
+        {
+            for (size_t i = 0; i < length; i++)
+            {
+                const char c = str[i];
+                if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f')))
+                    return false;
+            }
+
+            return true;
+        }
+    }
+
+    void FileEntryIndex::Build(u32 numFiles, const char* stringTable, size_t stringTableSize, const std::function<u32(u32)>& getStringTableOffset)
+    {
+        this->Clear();
+        m_byName.reserve(numFiles);
+        m_byNcaId.reserve(numFiles);
+
+        for (u32 i = 0; i < numFiles; i++)
+        {
+            const u32 offset = getStringTableOffset(i);
+            if (offset >= stringTableSize)
+                continue;
+
+            std::string name(stringTable + offset, strnlen(stringTable + offset, stringTableSize - offset));
+
+            // Duplicate names resolve to the first entry, like the linear scan did
+            m_byName.emplace(name, i);
+
+            const size_t dot = name.find('.');
+            m_byExtension[name.substr(dot + 1)].push_back(i);
+
+            if (name.size() <= NCA_ID_STRING_LENGTH || !IsLowerHex(name, NCA_ID_STRING_LENGTH))
+                continue;
+
+            for (u32 priority = 0; priority < sizeof(NCA_SUFFIXES) / sizeof(NCA_SUFFIXES[0]); priority++)
+            {
+                if (name.compare(NCA_ID_STRING_LENGTH, std::string::npos, NCA_SUFFIXES[priority]) != 0)
+                    continue;
+
+                auto result = m_byNcaId.emplace(name.substr(0, NCA_ID_STRING_LENGTH), NcaEntry{i, priority});
+                if (!result.second && priority < result.first->second.priority)
+                    result.first->second = NcaEntry{i, priority};
+                break;
+            }
+        }
+    }
+
+    void FileEntryIndex::Clear()
+    {
+        m_byName.clear();
+        m_byNcaId.clear();
+        m_byExtension.clear();
+    }
+
+    u32 FileEntryIndex::FindByName(const std::string& name) const
+    {
+        auto it = m_byName.find(name);
+        return it != m_byName.end() ? it->second : NOT_FOUND;
+    }
+
+    u32 FileEntryIndex::FindByNcaId(const NcmContentId& ncaId) const
+    {
+        auto it = m_byNcaId.find(tin::util::GetNcaIdString(ncaId));
+        return it != m_byNcaId.end() ? it->second.index : NOT_FOUND;
+    }
+
+    const std::vector<u32>& FileEntryIndex::FindByExtension(const std::string& extension) const
+    {
+        static const std::vector<u32> empty;
+
+        auto it = m_byExtension.find(extension);
+        return it != m_byExtension.end() ? it->second : empty;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+/*
+Copyright (c) 2017-2018 Adubbz
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "install/header_reader.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include "util/config.hpp"
+#include "util/error.hpp"
+
+namespace tin::install
+{
+    HeaderReader::HeaderReader(std::function<void (void* buf, off_t offset, size_t size)> bufferFunc, size_t windowSize) :
+        m_bufferFunc(bufferFunc), m_windowSize(windowSize)
+    {
+    }
+
+    void HeaderReader::Fetch(void* buf, u64 offset, size_t size)
+    {
+        m_roundTrips++;
+        m_bufferFunc(buf, offset, size);
+    }
+
+    void HeaderReader::Read(void* buf, u64 offset, size_t size)
+    {
+        const u64 windowEnd = m_windowOffset + m_window.size();
+
+        // Fully inside the window
+        if (offset >= m_windowOffset && offset + size <= windowEnd)
+        {
+            memcpy(buf, m_window.data() + (offset - m_windowOffset), size);
+            return;
+        }
+
+        // Starts inside the window but overflows it, only fetch the missing tail
+        if (!m_window.empty() && offset >= m_windowOffset && offset < windowEnd)
+        {
+            const size_t tailSize = offset + size - windowEnd;
+            m_window.resize(m_window.size() + tailSize);
+            this->Fetch(m_window.data() + (windowEnd - m_windowOffset), windowEnd, tailSize);
+            memcpy(buf, m_window.data() + (offset - m_windowOffset), size);
+            return;
+        }
+
+        // Outside the window, speculatively read a new one from here
+        const size_t speculativeSize = std::max(m_windowSize, size);
+        std::vector<u8> window(speculativeSize);
+        try
+        {
+            this->Fetch(window.data(), offset, speculativeSize);
+        }
+        catch (std::exception& e)
+        {
+            // The source may end before the window does, retry with the exact range and stop speculating
+            LOG_DEBUG("Speculative header read of 0x%lx bytes at 0x%lx failed, reading exact range: %s\n", speculativeSize, offset, e.what());
+            m_windowSize = 0;
+            window.resize(size);
+            this->Fetch(window.data(), offset, size);
+        }
+
+        m_window = std::move(window);
+        m_windowOffset = offset;
+        memcpy(buf, m_window.data(), size);
+    }
+
+    u32 HeaderReader::GetRoundTrips() const
+    {
+        return m_roundTrips;
+    }
+
+    size_t HeaderReader::GetConfiguredWindowSize()
+    {
+        return (size_t)std::clamp(inst::config::headerReadAheadKb, 64, 1024) * 0x400;
+    }
+}
\ No newline at end of file
@@ -22,8 +22,10 @@ SOFTWARE.
 
 #include "install/http_nsp.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdio>
+#include <cstring>
 #include <switch.h>
 #include <threads.h>
 #include "data/buffered_placeholder_writer.hpp"
@@ -32,6 +34,7 @@ SOFTWARE.
 #include "util/debug.h"
 #include "util/util.hpp"
 #include "util/lang.hpp"
+#include "util/config.hpp"
 #include "ui/instPage.hpp"
 #include "ui/MainApplication.hpp"
 
@@ -91,6 +94,11 @@ namespace tin::install::nsp
 
     }
 
+    std::string HTTPNSP::GetSourceName()
+    {
+        return m_sourceName;
+    }
+
     struct RetryConfirmState
     {
         std::atomic<bool> pending{false};
@@ -103,6 +111,7 @@ namespace tin::install::nsp
         tin::data::BufferedPlaceholderWriter* bufferedPlaceholderWriter;
         u64 pfs0Offset;
         u64 ncaSize;
+        u32 connectionCount;
         RetryConfirmState retryConfirm;
     };
 
@@ -114,15 +123,20 @@ namespace tin::install::nsp
             {
                 if (inst::ui::instPage::isInstallCancelRequested())
                     return 0;
-                while (true)
+                // Parts can be larger than a segment, so fill them one span at a time
+                size_t copied = 0;
+                while (copied < streamBufSize)
                 {
-                    if (inst::ui::instPage::isInstallCancelRequested())
+                    u8* span = NULL;
+                    size_t spanSize = 0;
+                    if (!args->bufferedPlaceholderWriter->ReserveAppendSpan(&span, &spanSize))
                         return 0;
-                    if (args->bufferedPlaceholderWriter->CanAppendData(streamBufSize))
-                        break;
-                }
 
-                args->bufferedPlaceholderWriter->AppendData(streamBuf, streamBufSize);
+                    const size_t chunk = std::min(spanSize, streamBufSize - copied);
+                    memcpy(span, streamBuf + copied, chunk);
+                    args->bufferedPlaceholderWriter->CommitAppendSpan(chunk);
+                    copied += chunk;
+                }
                 return streamBufSize;
             };
 
@@ -133,11 +147,14 @@ namespace tin::install::nsp
                 return !stopThreadsHttpNsp && args->retryConfirm.approved.load();
             };
 
-            if (args->download->StreamDataRange(args->pfs0Offset, args->ncaSize, streamFunc, retryConfirmFunc) == 1)
+            if (args->download->StreamDataRangeParallel(args->pfs0Offset, args->ncaSize, args->connectionCount, streamFunc, retryConfirmFunc) == 1) {
                 stopThreadsHttpNsp = true;
+                args->bufferedPlaceholderWriter->Abort();
+            }
         }
         catch (...) {
             stopThreadsHttpNsp = true;
+            args->bufferedPlaceholderWriter->Abort();
         }
         return 0;
     }
@@ -146,18 +163,19 @@ namespace tin::install::nsp
     {
         StreamFuncArgs* args = reinterpret_cast<StreamFuncArgs*>(in);
         try {
-            while (!args->bufferedPlaceholderWriter->IsPlaceholderComplete() && !stopThreadsHttpNsp)
+            while (!stopThreadsHttpNsp && args->bufferedPlaceholderWriter->WaitForSegmentToWrite())
             {
                 if (inst::ui::instPage::isInstallCancelRequested()) {
                     stopThreadsHttpNsp = true;
+                    args->bufferedPlaceholderWriter->Abort();
                     break;
                 }
-                if (args->bufferedPlaceholderWriter->CanWriteSegmentToPlaceholder())
-                    args->bufferedPlaceholderWriter->WriteSegmentToPlaceholder();
+                args->bufferedPlaceholderWriter->WriteSegmentToPlaceholder();
             }
         }
         catch (...) {
             stopThreadsHttpNsp = true;
+            args->bufferedPlaceholderWriter->Abort();
         }
 
         return 0;
@@ -172,12 +190,14 @@ namespace tin::install::nsp
         LOG_DEBUG("Retrieving %s\n", displayFileName.c_str());
         size_t ncaSize = fileEntry->fileSize;
 
-        tin::data::BufferedPlaceholderWriter bufferedPlaceholderWriter(contentStorage, placeholderId, ncaSize);
+        tin::data::BufferedPlaceholderWriter bufferedPlaceholderWriter(contentStorage, placeholderId, ncaSize, tin::data::BufferSourceProfile::HTTP);
         StreamFuncArgs args;
         args.download = &m_download;
         args.bufferedPlaceholderWriter = &bufferedPlaceholderWriter;
         args.pfs0Offset = this->GetDataOffset() + fileEntry->dataOffset;
         args.ncaSize = ncaSize;
+        // Out of order parts need extra buffering, so stay on one connection with the minimal applet buffer
+        args.connectionCount = tin::data::BUFFER_MEMORY_BUDGET > tin::data::APPLET_BUFFER_MEMORY_BUDGET ? (u32)std::clamp(inst::config::httpRangeConnections, 1, 8) : 1;
         thrd_t curlThread;
         thrd_t writeThread;
 
@@ -197,6 +217,7 @@ namespace tin::install::nsp
                 args.retryConfirm.approved.store(false);
                 args.retryConfirm.pending.store(false);
                 stopThreadsHttpNsp = true;
+                bufferedPlaceholderWriter.Abort();
                 break;
             }
 
@@ -261,6 +282,7 @@ namespace tin::install::nsp
                 args.retryConfirm.approved.store(false);
                 args.retryConfirm.pending.store(false);
                 stopThreadsHttpNsp = true;
+                bufferedPlaceholderWriter.Abort();
                 break;
             }
             int installProgress = (int)(((double)bufferedPlaceholderWriter.GetSizeWrittenToPlaceholder() / (double)bufferedPlaceholderWriter.GetTotalDataSize()) * 100.0);
@@ -275,6 +297,8 @@ namespace tin::install::nsp
         inst::ui::instPage::setInstBarPerc(100);
         inst::ui::instPage::setProgressDetailText("Installing 100%");
 
+        if (stopThreadsHttpNsp)
+            bufferedPlaceholderWriter.Abort();
         thrd_join(curlThread, NULL);
         thrd_join(writeThread, NULL);
         bufferedPlaceholderWriter.close();
@@ -285,6 +309,24 @@ namespace tin::install::nsp
 
     void HTTPNSP::BufferData(void* buf, off_t offset, size_t size)
     {
+        for (auto& range : m_prefetchedRanges)
+        {
+            if ((u64)offset >= range.offset && (u64)offset + size <= range.offset + range.data.size())
+            {
+                memcpy(buf, range.data.data() + ((u64)offset - range.offset), size);
+                return;
+            }
+        }
+
         m_download.BufferDataRange(buf, offset, size, nullptr);
     }
+
+    void HTTPNSP::PrefetchRange(u64 offset, size_t size)
+    {
+        PrefetchedRange range;
+        range.offset = offset;
+        range.data.resize(size);
+        m_download.BufferDataRange(range.data.data(), offset, size, nullptr);
+        m_prefetchedRanges.push_back(std::move(range));
+    }
 }
@@ -22,10 +22,14 @@ SOFTWARE.
 
 #include "install/http_xci.hpp"
 
+#include <algorithm>
+#include <exception>
+#include "data/buffered_placeholder_writer.hpp"
 #include "nx/nca_writer.h"
 #include "util/error.hpp"
 #include "util/util.hpp"
 #include "util/lang.hpp"
+#include "util/config.hpp"
 #include "ui/instPage.hpp"
 
 namespace tin::install::xci
@@ -36,6 +40,11 @@ namespace tin::install::xci
 
     }
 
+    std::string HTTPXCI::GetSourceName()
+    {
+        return m_sourceName;
+    }
+
     void HTTPXCI::StreamToPlaceholder(std::shared_ptr<nx::ncm::ContentStorage>& contentStorage, NcmContentId ncaId)
     {
         const HFS0FileEntry* fileEntry = this->GetFileEntryByNcaId(ncaId);
@@ -45,33 +54,46 @@ namespace tin::install::xci
         size_t ncaSize = fileEntry->fileSize;
 
         NcaWriter writer(ncaId, contentStorage);
-        float progress = 0.0f;
         u64 fileStart = GetDataOffset() + fileEntry->dataOffset;
         u64 fileOff = 0;
-        size_t readSize = 0x400000;
-        auto readBuffer = std::make_unique<u8[]>(readSize);
+        u64 lastProgressOff = 0;
+        std::exception_ptr writeError = nullptr;
+        const u32 connectionCount = tin::data::BUFFER_MEMORY_BUDGET > tin::data::APPLET_BUFFER_MEMORY_BUDGET ? (u32)std::clamp(inst::config::httpRangeConnections, 1, 8) : 1;
+
+        auto streamFunc = [&](u8* streamBuf, size_t streamBufSize) -> size_t
+        {
+            if (inst::ui::instPage::isInstallCancelRequested())
+                return 0;
+
+            try {
+                writer.write(streamBuf, streamBufSize);
+            } catch (...) {
+                writeError = std::current_exception();
+                return 0;
+            }
+            fileOff += streamBufSize;
+
+            if (fileOff - lastProgressOff >= 0x400000 * 3 || fileOff == ncaSize) {
+                lastProgressOff = fileOff;
+                float progress = (float)fileOff / (float)ncaSize;
+                LOG_DEBUG("> Progress: %lu/%lu MB (%d%s)\r", (fileOff / 1000000), (ncaSize / 1000000), (int)(progress * 100.0), "%");
+                inst::ui::instPage::setInstBarPerc((double)(progress * 100.0));
+            }
+            return streamBufSize;
+        };
 
         try {
             inst::ui::instPage::setInstInfoText("inst.info_page.top_info0"_lang + ncaFileName + "...");
             inst::ui::instPage::setInstBarPerc(0);
-            while (fileOff < ncaSize) {
-                if (inst::ui::instPage::isInstallCancelRequested()) {
-                    THROW_FORMAT("Installation canceled.");
-                }
-                progress = (float)fileOff / (float)ncaSize;
-
-                if (fileOff % (0x400000 * 3) == 0) {
-                    LOG_DEBUG("> Progress: %lu/%lu MB (%d%s)\r", (fileOff / 1000000), (ncaSize / 1000000), (int)(progress * 100.0), "%");
-                    inst::ui::instPage::setInstBarPerc((double)(progress * 100.0));
-                }
-
-                if (fileOff + readSize >= ncaSize)
-                    readSize = ncaSize - fileOff;
-
-                this->BufferData(readBuffer.get(), fileOff + fileStart, readSize);
-                writer.write(readBuffer.get(), readSize);
-                fileOff += readSize;
-            }
+
+            const int rc = m_download.StreamDataRangeParallel(fileStart, ncaSize, connectionCount, streamFunc);
+            if (writeError)
+                std::rethrow_exception(writeError);
+            if (inst::ui::instPage::isInstallCancelRequested())
+                THROW_FORMAT("Installation canceled.");
+            if (rc != 0 || fileOff != ncaSize)
+                THROW_FORMAT("HTTP range read failed (rc=%d)\n", rc);
+
             inst::ui::instPage::setInstBarPerc(100);
         } catch (std::exception& e) {
             LOG_DEBUG("something went wrong: %s\n", e.what());
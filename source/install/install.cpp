@@ -23,15 +23,24 @@ SOFTWARE.
 #include "install/install.hpp"
 
 #include <switch.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
 #include <algorithm>
 #include "util/error.hpp"
 #include "util/install_diagnostics.hpp"
 #include "ui/instPage.hpp"
 
 #include "nx/ncm.hpp"
+#include "nx/nca_writer.h"
 #include "util/config.hpp"
+#include "util/lang.hpp"
 #include "util/title_util.hpp"
 
 
@@ -39,6 +48,28 @@ SOFTWARE.
 // TODO: Check tik/cert is present
 namespace tin::install
 {
+    namespace {
+        // Working memory that concurrently installing NCAs may hold at once. At the default read-ahead
+        // this admits two NCZ or three NCA installs side by side.
+        constexpr u64 kConcurrentNcaMemoryBudget = 192ULL * 1024ULL * 1024ULL;
+
+        u64 EstimateNcaInstallMemory(bool compressed)
+        {
+            const u64 readAhead = static_cast<u64>(std::clamp(inst::config::localReadAheadDepth, 2, 8)) *
+                static_cast<u64>(std::clamp(inst::config::localReadChunkMb, 1, 16)) * 0x100000ULL;
+            u64 cost = readAhead + NcaBodyWriter::MAX_BUFFERED_SIZE;
+            if (compressed)
+                cost += 0x2000000ULL;
+            return cost;
+        }
+
+        struct NcaIdLess {
+            bool operator()(const NcmContentId& a, const NcmContentId& b) const {
+                return std::memcmp(&a, &b, sizeof(NcmContentId)) < 0;
+            }
+        };
+    }
+
     Install::Install(NcmStorageId destStorageId, bool ignoreReqFirmVersion) :
         m_destStorageId(destStorageId), m_ignoreReqFirmVersion(ignoreReqFirmVersion), m_contentMeta()
     {
@@ -104,6 +135,28 @@ namespace tin::install
         serviceClose(&contentMetaDatabase.s);
     }
 
+    void Install::CommitContentMetaRecords(std::vector<tin::data::ByteBuffer>& installContentMetaBufs)
+    {
+        NcmContentMetaDatabase contentMetaDatabase;
+
+        try
+        {
+            ASSERT_OK(ncmOpenContentMetaDatabase(&contentMetaDatabase, m_destStorageId), "Failed to open content meta database");
+            for (size_t i = 0; i < installContentMetaBufs.size(); i++) {
+                NcmContentMetaKey contentMetaKey = m_contentMeta[i].GetContentMetaKey();
+                ASSERT_OK(ncmContentMetaDatabaseSet(&contentMetaDatabase, &contentMetaKey, (NcmContentMetaHeader*)installContentMetaBufs[i].GetData(), installContentMetaBufs[i].GetSize()), "Failed to set content records");
+            }
+            ASSERT_OK(ncmContentMetaDatabaseCommit(&contentMetaDatabase), "Failed to commit content records");
+        }
+        catch (std::runtime_error& e)
+        {
+            serviceClose(&contentMetaDatabase.s);
+            THROW_FORMAT(e.what());
+        }
+
+        serviceClose(&contentMetaDatabase.s);
+    }
+
     void Install::InstallApplicationRecord(int i)
     {
         const u64 baseTitleId = tin::util::GetBaseTitleId(this->GetTitleId(i), this->GetContentMetaType(i));
@@ -126,7 +179,11 @@ namespace tin::install
             inst::diag::NoteStep("Prepare phase: reading CNMT records");
             std::vector<std::tuple<nx::ncm::ContentMeta, NcmContentInfo>> tupelList = this->ReadCNMT();
             inst::diag::NoteStep("Prepare phase: discovered " + std::to_string(tupelList.size()) + " CNMT record(s)");
-            
+
+            nx::ncm::ContentStorage contentStorage(m_destStorageId);
+            std::vector<tin::data::ByteBuffer> installContentMetaBufs;
+            installContentMetaBufs.reserve(tupelList.size());
+
             for (size_t i = 0; i < tupelList.size(); i++) {
                 if (inst::ui::instPage::isInstallCancelRequested())
                     THROW_FORMAT("Installation canceled.");
@@ -135,14 +192,12 @@ namespace tin::install
                 m_contentMeta.push_back(std::get<0>(cnmtTuple));
                 NcmContentInfo cnmtContentRecord = std::get<1>(cnmtTuple);
 
-                nx::ncm::ContentStorage contentStorage(m_destStorageId);
-
                 if (!contentStorage.Has(cnmtContentRecord.content_id))
                 {
-                    LOG_DEBUG("Installing CNMT NCA...\n");
-                    inst::diag::NoteStep("Prepare phase: installing CNMT NCA " + tin::util::GetNcaIdString(cnmtContentRecord.content_id));
-                    this->InstallNCA(cnmtContentRecord.content_id);
-                    TrackSessionInstalledNca(cnmtContentRecord.content_id);
+                    // The cnmt was parsed without the NCA, so it can go in with the rest of the content
+                    LOG_DEBUG("Queueing CNMT NCA...\n");
+                    inst::diag::NoteStep("Prepare phase: queueing CNMT NCA " + tin::util::GetNcaIdString(cnmtContentRecord.content_id));
+                    m_pendingCnmtNcas.push_back(cnmtContentRecord.content_id);
                 }
                 else
                 {
@@ -156,11 +211,14 @@ namespace tin::install
 
                 tin::data::ByteBuffer installContentMetaBuf;
                 m_contentMeta[i].GetInstallContentMeta(installContentMetaBuf, cnmtContentRecord, m_ignoreReqFirmVersion);
-                inst::diag::NoteStep("Prepare phase: writing content meta record #" + std::to_string(i + 1));
+                installContentMetaBufs.push_back(std::move(installContentMetaBuf));
+            }
 
-                this->InstallContentMetaRecords(installContentMetaBuf, i);
+            // All content meta records go into the database with a single commit
+            inst::diag::NoteStep("Prepare phase: writing " + std::to_string(installContentMetaBufs.size()) + " content meta record(s)");
+            this->CommitContentMetaRecords(installContentMetaBufs);
+            for (size_t i = 0; i < installContentMetaBufs.size(); i++)
                 this->InstallApplicationRecord(i);
-            }
         }
         catch (...) {
             CleanupSessionInstalledNcas();
@@ -182,24 +240,47 @@ namespace tin::install
         }
 
         try {
-            for (nx::ncm::ContentMeta contentMeta: m_contentMeta) {
+            nx::ncm::ContentStorage contentStorage(m_destStorageId);
+            // Install order follows pendingNcas, queuedNcas only answers "already queued?" for packages
+            // with thousands of records (large DLC bundles)
+            std::vector<NcmContentId> pendingNcas;
+            std::set<NcmContentId, NcaIdLess> queuedNcas;
+            for (const NcmContentId& cnmtNcaId : m_pendingCnmtNcas) {
+                if (queuedNcas.count(cnmtNcaId) == 0 && !contentStorage.Has(cnmtNcaId)) {
+                    pendingNcas.push_back(cnmtNcaId);
+                    queuedNcas.insert(cnmtNcaId);
+                }
+            }
+            m_pendingCnmtNcas.clear();
+
+            for (nx::ncm::ContentMeta& contentMeta: m_contentMeta) {
                 LOG_DEBUG("Installing NCAs...\n");
                 inst::diag::NoteStep("Install phase: NCA validation " + std::string(inst::config::validateNCAs ? "enabled" : "disabled"));
                 for (auto& record : contentMeta.GetContentInfos())
                 {
                     if (inst::ui::instPage::isInstallCancelRequested())
                         THROW_FORMAT("Installation canceled.");
-                    nx::ncm::ContentStorage contentStorage(m_destStorageId);
-                    if (contentStorage.Has(record.content_id)) {
+                    if (queuedNcas.count(record.content_id) != 0 || contentStorage.Has(record.content_id)) {
                         LOG_DEBUG("NCA already installed. Skipping %s\n", tin::util::GetNcaIdString(record.content_id).c_str());
                         inst::diag::NoteStep("Install phase: skip existing NCA " + tin::util::GetNcaIdString(record.content_id));
                         continue;
                     }
+                    pendingNcas.push_back(record.content_id);
+                    queuedNcas.insert(record.content_id);
+                }
+            }
 
-                    LOG_DEBUG("Installing from %s\n", tin::util::GetNcaIdString(record.content_id).c_str());
-                    inst::diag::NoteStep("Install phase: writing NCA " + tin::util::GetNcaIdString(record.content_id));
-                    this->InstallNCA(record.content_id);
-                    TrackSessionInstalledNca(record.content_id);
+            const u32 workerCount = static_cast<u32>(std::clamp(inst::config::concurrentNcaInstalls, 1, 4));
+            if (workerCount > 1 && pendingNcas.size() > 1 && this->CanInstallNcasConcurrently()) {
+                this->InstallNcasConcurrently(pendingNcas, workerCount);
+            } else {
+                for (const NcmContentId& ncaId : pendingNcas) {
+                    if (inst::ui::instPage::isInstallCancelRequested())
+                        THROW_FORMAT("Installation canceled.");
+                    LOG_DEBUG("Installing from %s\n", tin::util::GetNcaIdString(ncaId).c_str());
+                    inst::diag::NoteStep("Install phase: writing NCA " + tin::util::GetNcaIdString(ncaId));
+                    this->InstallNCA(ncaId);
+                    TrackSessionInstalledNca(ncaId);
                 }
             }
         }
@@ -209,6 +290,155 @@ namespace tin::install
         }
     }
 
+    void Install::ValidateNCA(const NcmContentId& ncaId)
+    {
+        (void)ncaId;
+    }
+
+    bool Install::CanInstallNcasConcurrently()
+    {
+        return false;
+    }
+
+    bool Install::IsCompressedNca(const NcmContentId& ncaId)
+    {
+        (void)ncaId;
+        return false;
+    }
+
+    u64 Install::GetNcaSize(const NcmContentId& ncaId)
+    {
+        (void)ncaId;
+        return 0;
+    }
+
+    // Installs NCAs into their own placeholders on up to workerCount threads, all with UI updates muted.
+    // The calling thread stays on the install page, drawing the combined progress of the workers and
+    // handling input, so a large NCA on any worker never leaves the page frozen.
+    void Install::InstallNcasConcurrently(const std::vector<NcmContentId>& ncaIds, u32 workerCount)
+    {
+        // Signature prompts need the UI, so every header is checked here before any worker starts
+        for (const NcmContentId& ncaId : ncaIds) {
+            if (inst::ui::instPage::isInstallCancelRequested())
+                THROW_FORMAT("Installation canceled.");
+            this->ValidateNCA(ncaId);
+        }
+
+        std::vector<u64> memoryCosts;
+        std::vector<u64> ncaSizes;
+        memoryCosts.reserve(ncaIds.size());
+        ncaSizes.reserve(ncaIds.size());
+        u64 totalSize = 0;
+        for (const NcmContentId& ncaId : ncaIds) {
+            memoryCosts.push_back(EstimateNcaInstallMemory(this->IsCompressedNca(ncaId)));
+            ncaSizes.push_back(std::max<u64>(this->GetNcaSize(ncaId), 1));
+            totalSize += ncaSizes.back();
+        }
+
+        // Per-NCA bar percentage reported by the muted worker installing it
+        std::unique_ptr<std::atomic<double>[]> ncaProgress(new std::atomic<double>[ncaIds.size()]);
+        for (size_t i = 0; i < ncaIds.size(); i++)
+            ncaProgress[i].store(0.0);
+
+        std::mutex mutex;
+        std::condition_variable cond;
+        size_t nextIndex = 0;
+        u64 reservedMemory = 0;
+        std::exception_ptr failure;
+        std::vector<bool> installed(ncaIds.size(), false);
+        size_t installedCount = 0;
+        size_t finishedWorkers = 0;
+
+        auto worker = [&]() {
+            while (true) {
+                size_t index = 0;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cond.wait(lock, [&]() {
+                        return failure || nextIndex >= ncaIds.size() || reservedMemory == 0 ||
+                            reservedMemory + memoryCosts[nextIndex] <= kConcurrentNcaMemoryBudget;
+                    });
+                    if (failure || nextIndex >= ncaIds.size())
+                        return;
+                    index = nextIndex++;
+                    reservedMemory += memoryCosts[index];
+                }
+
+                std::exception_ptr error;
+                try {
+                    if (inst::ui::instPage::isInstallCancelRequested())
+                        THROW_FORMAT("Installation canceled.");
+                    LOG_DEBUG("Installing from %s\n", tin::util::GetNcaIdString(ncaIds[index]).c_str());
+                    inst::diag::NoteStep("Install phase: writing NCA " + tin::util::GetNcaIdString(ncaIds[index]));
+                    inst::ui::instPage::setProgressSinkOnThisThread(&ncaProgress[index]);
+                    this->InstallNCA(ncaIds[index]);
+                    ncaProgress[index].store(100.0);
+                }
+                catch (...) {
+                    error = std::current_exception();
+                }
+                inst::ui::instPage::setProgressSinkOnThisThread(nullptr);
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    reservedMemory -= memoryCosts[index];
+                    if (error) {
+                        if (!failure)
+                            failure = error;
+                    } else {
+                        installed[index] = true;
+                        installedCount++;
+                    }
+                }
+                cond.notify_all();
+            }
+        };
+
+        m_ncasPrevalidated = true;
+        std::vector<std::thread> workers;
+        for (u32 i = 0; i < workerCount && i < ncaIds.size(); i++) {
+            workers.emplace_back([&]() {
+                inst::ui::instPage::setProgressMutedOnThisThread(true);
+                worker();
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    finishedWorkers++;
+                }
+                cond.notify_all();
+            });
+        }
+
+        inst::ui::instPage::setInstInfoText("inst.info_page.top_info0"_lang + std::to_string(ncaIds.size()) + " NCAs...");
+        while (true) {
+            size_t done = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (cond.wait_for(lock, std::chrono::milliseconds(100), [&]() { return finishedWorkers == workers.size(); }))
+                    break;
+                done = installedCount;
+            }
+
+            double written = 0.0;
+            for (size_t i = 0; i < ncaIds.size(); i++)
+                written += static_cast<double>(ncaSizes[i]) * std::clamp(ncaProgress[i].load(), 0.0, 100.0) / 100.0;
+            const double percent = written * 100.0 / static_cast<double>(totalSize);
+            inst::ui::instPage::setProgressDetailText(std::to_string(static_cast<int>(percent)) + "% • " + std::to_string(done) + "/" + std::to_string(ncaIds.size()) + " NCAs");
+            inst::ui::instPage::setInstBarPerc(percent);
+        }
+        for (auto& thread : workers)
+            thread.join();
+        m_ncasPrevalidated = false;
+
+        // Track in list order so cleanup on failure sees the same set as the serial path
+        for (size_t i = 0; i < ncaIds.size(); i++) {
+            if (installed[i])
+                TrackSessionInstalledNca(ncaIds[i]);
+        }
+
+        if (failure)
+            std::rethrow_exception(failure);
+    }
+
     u64 Install::GetTitleId(int i)
     {
         return m_contentMeta[i].GetContentMetaKey().id;
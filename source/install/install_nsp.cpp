@@ -48,7 +48,9 @@ namespace tin::install::nsp
     NSPInstall::NSPInstall(NcmStorageId destStorageId, bool ignoreReqFirmVersion, const std::shared_ptr<NSP>& remoteNSP) :
         Install(destStorageId, ignoreReqFirmVersion), m_NSP(remoteNSP)
     {
-        m_NSP->RetrieveHeader();
+        // The shop queue may already have fetched it ahead of time
+        if (!m_NSP->HasHeader())
+            m_NSP->RetrieveHeader();
     }
 
     std::vector<std::tuple<nx::ncm::ContentMeta, NcmContentInfo>> NSPInstall::ReadCNMT()
@@ -60,25 +62,98 @@ namespace tin::install::nsp
             NcmContentId cnmtContentId = tin::util::GetNcaIdFromString(cnmtNcaName);
             size_t cnmtNcaSize = fileEntry->fileSize;
 
-            nx::ncm::ContentStorage contentStorage(m_destStorageId);
-
             LOG_DEBUG("CNMT Name: %s\n", cnmtNcaName.c_str());
 
-            // We install the cnmt nca early to read from it later
-            this->InstallNCA(cnmtContentId);
-            std::string cnmtNCAFullPath = contentStorage.GetPath(cnmtContentId);
-
-            NcmContentInfo cnmtContentInfo;
+            NcmContentInfo cnmtContentInfo = {};
             cnmtContentInfo.content_id = cnmtContentId;
             ncmU64ToContentInfoSize(cnmtNcaSize & 0xFFFFFFFFFFFF, &cnmtContentInfo);
             cnmtContentInfo.content_type = NcmContentType_Meta;
 
+            // Meta NCAs are tiny, so parse the cnmt straight from memory. The NCA itself
+            // is installed later along with the rest of the content.
+            if (cnmtNcaSize <= MAX_IN_MEMORY_CNMT_NCA_SIZE)
+            {
+                try
+                {
+                    std::vector<u8> cnmtNca(cnmtNcaSize);
+                    m_NSP->BufferData(cnmtNca.data(), m_NSP->GetDataOffset() + fileEntry->dataOffset, cnmtNcaSize);
+                    CNMTList.push_back( { tin::util::GetContentMetaFromNCAData(cnmtNca.data(), cnmtNca.size()), cnmtContentInfo } );
+                    continue;
+                }
+                catch (std::exception& e)
+                {
+                    LOG_DEBUG("In-memory CNMT parse failed (%s), installing the NCA instead\n", e.what());
+                }
+            }
+
+            // Fall back to installing the cnmt nca early to read from it
+            nx::ncm::ContentStorage contentStorage(m_destStorageId);
+            this->InstallNCA(cnmtContentId);
+            std::string cnmtNCAFullPath = contentStorage.GetPath(cnmtContentId);
+
             CNMTList.push_back( { tin::util::GetContentMetaFromNCA(cnmtNCAFullPath), cnmtContentInfo } );
         }
 
         return CNMTList;
     }
 
+    void NSPInstall::ValidateNCA(const NcmContentId& ncaId)
+    {
+        const PFS0FileEntry* fileEntry = m_NSP->GetFileEntryByNcaId(ncaId);
+
+        if (inst::config::validateNCAs && !m_declinedValidation)
+        {
+            inst::diag::NoteStep("NCA verify: validating signature for " + tin::util::GetNcaIdString(ncaId));
+            tin::install::NcaHeader* header = new NcaHeader;
+            m_NSP->BufferData(header, m_NSP->GetDataOffset() + fileEntry->dataOffset, sizeof(tin::install::NcaHeader));
+
+            Crypto::AesXtr crypto = Crypto::GetHeaderDecryptor();
+            crypto.decrypt(header, header, sizeof(tin::install::NcaHeader), 0, 0x200);
+
+            if (header->magic != MAGIC_NCA3)
+                THROW_FORMAT("Invalid NCA magic");
+
+            if (!Crypto::rsa2048PssVerify(&header->magic, 0x200, header->fixed_key_sig, Crypto::NCAHeaderSignature))
+            {
+                inst::diag::NoteStep("NCA verify: signature validation failed for " + tin::util::GetNcaIdString(ncaId), false);
+                std::string audioPath = "romfs:/audio/bark.wav";
+                if (!inst::config::soundEnabled) audioPath = "";
+                if (std::filesystem::exists(inst::config::appDir + "/bark.wav")) audioPath = inst::config::appDir + "/bark.wav";
+                std::thread audioThread(inst::util::playAudio,audioPath);
+                int rc = inst::ui::mainApp->CreateShowDialog("inst.nca_verify.title"_lang, "inst.nca_verify.desc"_lang, {"common.cancel"_lang, "inst.nca_verify.opt1"_lang}, false);
+                audioThread.join();
+                if (rc != 1)
+                    THROW_FORMAT(("inst.nca_verify.error"_lang + tin::util::GetNcaIdString(ncaId)).c_str());
+                m_declinedValidation = true;
+                inst::diag::NoteStep("NCA verify: user bypass enabled for remaining NCAs", false);
+            }
+            else {
+                inst::diag::NoteStep("NCA verify: signature valid for " + tin::util::GetNcaIdString(ncaId));
+            }
+            delete header;
+        }
+    }
+
+    bool NSPInstall::CanInstallNcasConcurrently()
+    {
+        return m_NSP->CanStreamConcurrently();
+    }
+
+    bool NSPInstall::IsCompressedNca(const NcmContentId& ncaId)
+    {
+        const PFS0FileEntry* fileEntry = m_NSP->GetFileEntryByNcaId(ncaId);
+        if (fileEntry == nullptr)
+            return false;
+        const std::string name = m_NSP->GetFileEntryName(fileEntry);
+        return name.size() > 4 && name.compare(name.size() - 4, 4, ".ncz") == 0;
+    }
+
+    u64 NSPInstall::GetNcaSize(const NcmContentId& ncaId)
+    {
+        const PFS0FileEntry* fileEntry = m_NSP->GetFileEntryByNcaId(ncaId);
+        return fileEntry != nullptr ? fileEntry->fileSize : 0;
+    }
+
     void NSPInstall::InstallNCA(const NcmContentId& ncaId)
     {
         const PFS0FileEntry* fileEntry = m_NSP->GetFileEntryByNcaId(ncaId);
@@ -97,39 +172,13 @@ namespace tin::install::nsp
         LOG_DEBUG("Size: 0x%lx\n", fileEntry->fileSize);
 
         try {
-            if (inst::config::validateNCAs && !m_declinedValidation)
-            {
-                inst::diag::NoteStep("NCA verify: validating signature for " + tin::util::GetNcaIdString(ncaId));
-                tin::install::NcaHeader* header = new NcaHeader;
-                m_NSP->BufferData(header, m_NSP->GetDataOffset() + fileEntry->dataOffset, sizeof(tin::install::NcaHeader));
-
-                Crypto::AesXtr crypto(Crypto::Keys().headerKey, false);
-                crypto.decrypt(header, header, sizeof(tin::install::NcaHeader), 0, 0x200);
-
-                if (header->magic != MAGIC_NCA3)
-                    THROW_FORMAT("Invalid NCA magic");
-
-                if (!Crypto::rsa2048PssVerify(&header->magic, 0x200, header->fixed_key_sig, Crypto::NCAHeaderSignature))
-                {
-                    inst::diag::NoteStep("NCA verify: signature validation failed for " + tin::util::GetNcaIdString(ncaId), false);
-                    std::string audioPath = "romfs:/audio/bark.wav";
-                    if (!inst::config::soundEnabled) audioPath = "";
-                    if (std::filesystem::exists(inst::config::appDir + "/bark.wav")) audioPath = inst::config::appDir + "/bark.wav";
-                    std::thread audioThread(inst::util::playAudio,audioPath);
-                    int rc = inst::ui::mainApp->CreateShowDialog("inst.nca_verify.title"_lang, "inst.nca_verify.desc"_lang, {"common.cancel"_lang, "inst.nca_verify.opt1"_lang}, false);
-                    audioThread.join();
-                    if (rc != 1)
-                        THROW_FORMAT(("inst.nca_verify.error"_lang + tin::util::GetNcaIdString(ncaId)).c_str());
-                    m_declinedValidation = true;
-                    inst::diag::NoteStep("NCA verify: user bypass enabled for remaining NCAs", false);
-                }
-                else {
-                    inst::diag::NoteStep("NCA verify: signature valid for " + tin::util::GetNcaIdString(ncaId));
-                }
-                delete header;
-            }
+            if (!m_ncasPrevalidated)
+                this->ValidateNCA(ncaId);
 
+            const u64 streamStartTick = armGetSystemTick();
             m_NSP->StreamToPlaceholder(contentStorage, ncaId);
+            inst::diag::NoteThroughput(m_NSP->GetSourceName(), ncaFileName, fileEntry->fileSize,
+                static_cast<double>(armGetSystemTick() - streamStartTick) / static_cast<double>(armGetSystemTickFreq()));
 
             LOG_DEBUG("Registering placeholder...\n");
 
@@ -56,25 +56,98 @@ namespace tin::install::xci
             NcmContentId cnmtContentId = tin::util::GetNcaIdFromString(cnmtNcaName);
             size_t cnmtNcaSize = fileEntry->fileSize;
 
-            nx::ncm::ContentStorage contentStorage(m_destStorageId);
-
             LOG_DEBUG("CNMT Name: %s\n", cnmtNcaName.c_str());
 
-            // We install the cnmt nca early to read from it later
-            this->InstallNCA(cnmtContentId);
-            std::string cnmtNCAFullPath = contentStorage.GetPath(cnmtContentId);
-
-            NcmContentInfo cnmtContentInfo;
+            NcmContentInfo cnmtContentInfo = {};
             cnmtContentInfo.content_id = cnmtContentId;
             ncmU64ToContentInfoSize(cnmtNcaSize & 0xFFFFFFFFFFFF, &cnmtContentInfo);
             cnmtContentInfo.content_type = NcmContentType_Meta;
 
+            // Meta NCAs are tiny, so parse the cnmt straight from memory. The NCA itself
+            // is installed later along with the rest of the content.
+            if (cnmtNcaSize <= MAX_IN_MEMORY_CNMT_NCA_SIZE)
+            {
+                try
+                {
+                    std::vector<u8> cnmtNca(cnmtNcaSize);
+                    m_xci->BufferData(cnmtNca.data(), m_xci->GetDataOffset() + fileEntry->dataOffset, cnmtNcaSize);
+                    CNMTList.push_back( { tin::util::GetContentMetaFromNCAData(cnmtNca.data(), cnmtNca.size()), cnmtContentInfo } );
+                    continue;
+                }
+                catch (std::exception& e)
+                {
+                    LOG_DEBUG("In-memory CNMT parse failed (%s), installing the NCA instead\n", e.what());
+                }
+            }
+
+            // Fall back to installing the cnmt nca early to read from it
+            nx::ncm::ContentStorage contentStorage(m_destStorageId);
+            this->InstallNCA(cnmtContentId);
+            std::string cnmtNCAFullPath = contentStorage.GetPath(cnmtContentId);
+
             CNMTList.push_back( { tin::util::GetContentMetaFromNCA(cnmtNCAFullPath), cnmtContentInfo } );
         }
         
         return CNMTList;
     }
 
+    void XCIInstallTask::ValidateNCA(const NcmContentId& ncaId)
+    {
+        const HFS0FileEntry* fileEntry = m_xci->GetFileEntryByNcaId(ncaId);
+
+        if (inst::config::validateNCAs && !m_declinedValidation)
+        {
+            inst::diag::NoteStep("NCA verify: validating signature for " + tin::util::GetNcaIdString(ncaId));
+            tin::install::NcaHeader* header = new NcaHeader;
+            m_xci->BufferData(header, m_xci->GetDataOffset() + fileEntry->dataOffset, sizeof(tin::install::NcaHeader));
+
+            Crypto::AesXtr crypto = Crypto::GetHeaderDecryptor();
+            crypto.decrypt(header, header, sizeof(tin::install::NcaHeader), 0, 0x200);
+
+            if (header->magic != MAGIC_NCA3)
+                THROW_FORMAT("Invalid NCA magic");
+
+            if (!Crypto::rsa2048PssVerify(&header->magic, 0x200, header->fixed_key_sig, Crypto::NCAHeaderSignature))
+            {
+                inst::diag::NoteStep("NCA verify: signature validation failed for " + tin::util::GetNcaIdString(ncaId), false);
+                std::string audioPath = "romfs:/audio/bark.wav";
+                if (!inst::config::soundEnabled) audioPath = "";
+                if (std::filesystem::exists(inst::config::appDir + "/bark.wav")) audioPath = inst::config::appDir + "/bark.wav";
+                std::thread audioThread(inst::util::playAudio,audioPath);
+                int rc = inst::ui::mainApp->CreateShowDialog("inst.nca_verify.title"_lang, "inst.nca_verify.desc"_lang, {"common.cancel"_lang, "inst.nca_verify.opt1"_lang}, false);
+                audioThread.join();
+                if (rc != 1)
+                    THROW_FORMAT(("inst.nca_verify.error"_lang + tin::util::GetNcaIdString(ncaId)).c_str());
+                m_declinedValidation = true;
+                inst::diag::NoteStep("NCA verify: user bypass enabled for remaining NCAs", false);
+            }
+            else {
+                inst::diag::NoteStep("NCA verify: signature valid for " + tin::util::GetNcaIdString(ncaId));
+            }
+            delete header;
+        }
+    }
+
+    bool XCIInstallTask::CanInstallNcasConcurrently()
+    {
+        return m_xci->CanStreamConcurrently();
+    }
+
+    bool XCIInstallTask::IsCompressedNca(const NcmContentId& ncaId)
+    {
+        const HFS0FileEntry* fileEntry = m_xci->GetFileEntryByNcaId(ncaId);
+        if (fileEntry == nullptr)
+            return false;
+        const std::string name = m_xci->GetFileEntryName(fileEntry);
+        return name.size() > 4 && name.compare(name.size() - 4, 4, ".ncz") == 0;
+    }
+
+    u64 XCIInstallTask::GetNcaSize(const NcmContentId& ncaId)
+    {
+        const HFS0FileEntry* fileEntry = m_xci->GetFileEntryByNcaId(ncaId);
+        return fileEntry != nullptr ? fileEntry->fileSize : 0;
+    }
+
     void XCIInstallTask::InstallNCA(const NcmContentId& ncaId)
     {
         const HFS0FileEntry* fileEntry = m_xci->GetFileEntryByNcaId(ncaId);
@@ -92,39 +165,13 @@ namespace tin::install::xci
         LOG_DEBUG("Size: 0x%lx\n", fileEntry->fileSize);
 
         try {
-            if (inst::config::validateNCAs && !m_declinedValidation)
-            {
-                inst::diag::NoteStep("NCA verify: validating signature for " + tin::util::GetNcaIdString(ncaId));
-                tin::install::NcaHeader* header = new NcaHeader;
-                m_xci->BufferData(header, m_xci->GetDataOffset() + fileEntry->dataOffset, sizeof(tin::install::NcaHeader));
-
-                Crypto::AesXtr crypto(Crypto::Keys().headerKey, false);
-                crypto.decrypt(header, header, sizeof(tin::install::NcaHeader), 0, 0x200);
-
-                if (header->magic != MAGIC_NCA3)
-                    THROW_FORMAT("Invalid NCA magic");
-
-                if (!Crypto::rsa2048PssVerify(&header->magic, 0x200, header->fixed_key_sig, Crypto::NCAHeaderSignature))
-                {
-                    inst::diag::NoteStep("NCA verify: signature validation failed for " + tin::util::GetNcaIdString(ncaId), false);
-                    std::string audioPath = "romfs:/audio/bark.wav";
-                    if (!inst::config::soundEnabled) audioPath = "";
-                    if (std::filesystem::exists(inst::config::appDir + "/bark.wav")) audioPath = inst::config::appDir + "/bark.wav";
-                    std::thread audioThread(inst::util::playAudio,audioPath);
-                    int rc = inst::ui::mainApp->CreateShowDialog("inst.nca_verify.title"_lang, "inst.nca_verify.desc"_lang, {"common.cancel"_lang, "inst.nca_verify.opt1"_lang}, false);
-                    audioThread.join();
-                    if (rc != 1)
-                        THROW_FORMAT(("inst.nca_verify.error"_lang + tin::util::GetNcaIdString(ncaId)).c_str());
-                    m_declinedValidation = true;
-                    inst::diag::NoteStep("NCA verify: user bypass enabled for remaining NCAs", false);
-                }
-                else {
-                    inst::diag::NoteStep("NCA verify: signature valid for " + tin::util::GetNcaIdString(ncaId));
-                }
-                delete header;
-            }
+            if (!m_ncasPrevalidated)
+                this->ValidateNCA(ncaId);
 
+            const u64 streamStartTick = armGetSystemTick();
             m_xci->StreamToPlaceholder(contentStorage, ncaId);
+            inst::diag::NoteThroughput(m_xci->GetSourceName(), ncaFileName, fileEntry->fileSize,
+                static_cast<double>(armGetSystemTick() - streamStartTick) / static_cast<double>(armGetSystemTickFreq()));
 
             // Clean up the line for whatever comes next
             LOG_DEBUG("                                                           \r");
@@ -24,6 +24,7 @@ SOFTWARE.
 
 #include <threads.h>
 #include "data/buffered_placeholder_writer.hpp"
+#include "install/header_reader.hpp"
 #include "util/title_util.hpp"
 #include "util/error.hpp"
 #include "util/debug.h"
@@ -37,20 +38,36 @@ namespace tin::install::nsp
     {
         LOG_DEBUG("Retrieving remote NSP header...\n");
 
+        HeaderReader reader([this](void* buf, off_t offset, size_t size) {
+            this->BufferData(buf, offset, size);
+        }, HeaderReader::GetConfiguredWindowSize());
+
         // Retrieve the base header
         m_headerBytes.resize(sizeof(PFS0BaseHeader), 0);
-        this->BufferData(m_headerBytes.data(), 0x0, sizeof(PFS0BaseHeader));
+        reader.Read(m_headerBytes.data(), 0x0, sizeof(PFS0BaseHeader));
 
         LOG_DEBUG("Base header: \n");
         printBytes(m_headerBytes.data(), sizeof(PFS0BaseHeader), true);
 
-        // Retrieve the full header
+        // Retrieve the full header, usually already covered by the read-ahead window
         size_t remainingHeaderSize = this->GetBaseHeader()->numFiles * sizeof(PFS0FileEntry) + this->GetBaseHeader()->stringTableSize;
         m_headerBytes.resize(sizeof(PFS0BaseHeader) + remainingHeaderSize, 0);
-        this->BufferData(m_headerBytes.data() + sizeof(PFS0BaseHeader), sizeof(PFS0BaseHeader), remainingHeaderSize);
+        reader.Read(m_headerBytes.data() + sizeof(PFS0BaseHeader), sizeof(PFS0BaseHeader), remainingHeaderSize);
+
+        LOG_DEBUG("Full header: 0x%lx bytes in %u round trip(s)\n", m_headerBytes.size(), reader.GetRoundTrips());
 
-        LOG_DEBUG("Full header: \n");
-        printBytes(m_headerBytes.data(), m_headerBytes.size(), true);
+        const PFS0BaseHeader* baseHeader = this->GetBaseHeader();
+        const u8* fileEntries = m_headerBytes.data() + sizeof(PFS0BaseHeader);
+        const char* stringTable = reinterpret_cast<const char*>(fileEntries + baseHeader->numFiles * sizeof(PFS0FileEntry));
+        m_fileIndex.Build(baseHeader->numFiles, stringTable, baseHeader->stringTableSize, [fileEntries](u32 i) {
+            return reinterpret_cast<const PFS0FileEntry*>(fileEntries + i * sizeof(PFS0FileEntry))->stringTableOffset;
+        });
+        m_headerRetrieved = true;
+    }
+
+    bool NSP::HasHeader()
+    {
+        return m_headerRetrieved;
     }
 
     const PFS0FileEntry* NSP::GetFileEntry(unsigned int index)
@@ -69,54 +86,26 @@ namespace tin::install::nsp
     std::vector<const PFS0FileEntry*> NSP::GetFileEntriesByExtension(std::string extension)
     {
         std::vector<const PFS0FileEntry*> entryList;
+        this->GetBaseHeader();
 
-        for (unsigned int i = 0; i < this->GetBaseHeader()->numFiles; i++)
-        {
-            const PFS0FileEntry* fileEntry = this->GetFileEntry(i);
-            std::string name(this->GetFileEntryName(fileEntry));
-            auto foundExtension = name.substr(name.find(".") + 1); 
-
-            if (foundExtension == extension)
-                entryList.push_back(fileEntry);
-        }
+        for (u32 index : m_fileIndex.FindByExtension(extension))
+            entryList.push_back(this->GetFileEntry(index));
 
         return entryList;
     }
 
     const PFS0FileEntry* NSP::GetFileEntryByName(std::string name)
     {
-        for (unsigned int i = 0; i < this->GetBaseHeader()->numFiles; i++)
-        {
-            const PFS0FileEntry* fileEntry = this->GetFileEntry(i);
-            std::string foundName(this->GetFileEntryName(fileEntry));
-
-            if (foundName == name)
-                return fileEntry;
-        }
-
-        return nullptr;
+        this->GetBaseHeader();
+        u32 index = m_fileIndex.FindByName(name);
+        return index != FileEntryIndex::NOT_FOUND ? this->GetFileEntry(index) : nullptr;
     }
 
     const PFS0FileEntry* NSP::GetFileEntryByNcaId(const NcmContentId& ncaId)
     {
-        const PFS0FileEntry* fileEntry = nullptr;
-        std::string ncaIdStr = tin::util::GetNcaIdString(ncaId);
-
-        if ((fileEntry = this->GetFileEntryByName(ncaIdStr + ".nca")) == nullptr)
-        {
-            if ((fileEntry = this->GetFileEntryByName(ncaIdStr + ".cnmt.nca")) == nullptr)
-            {
-                    if ((fileEntry = this->GetFileEntryByName(ncaIdStr + ".ncz")) == nullptr)
-                    {
-                         if ((fileEntry = this->GetFileEntryByName(ncaIdStr + ".cnmt.ncz")) == nullptr)
-                         {
-                              return nullptr;
-                         }
-                    }
-            }
-        }
-
-        return fileEntry;
+        this->GetBaseHeader();
+        u32 index = m_fileIndex.FindByNcaId(ncaId);
+        return index != FileEntryIndex::NOT_FOUND ? this->GetFileEntry(index) : nullptr;
     }
 
     const char* NSP::GetFileEntryName(const PFS0FileEntry* fileEntry)
@@ -133,6 +122,16 @@ namespace tin::install::nsp
         return reinterpret_cast<PFS0BaseHeader*>(m_headerBytes.data());
     }
 
+    bool NSP::CanStreamConcurrently()
+    {
+        return false;
+    }
+
+    std::string NSP::GetSourceName()
+    {
+        return "unknown";
+    }
+
     u64 NSP::GetDataOffset()
     {
         if (m_headerBytes.empty())
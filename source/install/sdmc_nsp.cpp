@@ -4,12 +4,16 @@
 #include "nx/nca_writer.h"
 #include "ui/instPage.hpp"
 #include "util/lang.hpp"
+#include "util/config.hpp"
+#include "data/prefetch_reader.hpp"
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 
 namespace tin::install::nsp
 {
-    SDMCNSP::SDMCNSP(std::string path)
+    SDMCNSP::SDMCNSP(std::string path, std::string sourceName) :
+        m_sourceName(sourceName)
     {
         m_nspFile = fopen((path).c_str(), "rb");
         if (!m_nspFile)
@@ -35,8 +39,9 @@ namespace tin::install::nsp
 
         u64 fileStart = GetDataOffset() + fileEntry->dataOffset;
         u64 fileOff = 0;
-        size_t readSize = 0x400000; // 4MB buff
-        auto readBuffer = std::make_unique<u8[]>(readSize);
+        u64 lastProgressOff = 0;
+        const size_t readSize = (size_t)std::clamp(inst::config::localReadChunkMb, 1, 16) * 0x100000;
+        const u32 readDepth = (u32)std::clamp(inst::config::localReadAheadDepth, 2, 8);
 
         try
         {
@@ -47,11 +52,20 @@ namespace tin::install::nsp
             auto lastTime = std::chrono::steady_clock::now();
             std::uint64_t lastBytes = 0;
             double emaRate = 0.0;
-            while (fileOff < ncaSize)
+
+            // Reads of the following chunks overlap with decrypting and writing the current one
+            tin::data::PrefetchReader reader([this](void* buf, u64 offset, size_t size) {
+                this->BufferData(buf, offset, size);
+            }, fileStart, ncaSize, readDepth, readSize);
+
+            const u8* chunk = nullptr;
+            size_t chunkSize = 0;
+            while (reader.Next(chunk, chunkSize))
             {
                 progress = (float) fileOff / (float) ncaSize;
 
-                if (fileOff % (0x400000 * 3) == 0) {
+                if (fileOff == 0 || fileOff - lastProgressOff >= 0x400000 * 3) {
+                    lastProgressOff = fileOff;
                     LOG_DEBUG("> Progress: %lu/%lu MB (%d%s)\r", (fileOff / 1000000), (ncaSize / 1000000), (int)(progress * 100.0), "%");
                     inst::ui::instPage::setInstBarPerc((double)(progress * 100.0));
 
@@ -105,12 +119,9 @@ namespace tin::install::nsp
                     inst::ui::instPage::setProgressDetailText(progressText);
                 }
 
-                if (fileOff + readSize >= ncaSize) readSize = ncaSize - fileOff;
-
-                this->BufferData(readBuffer.get(), fileOff + fileStart, readSize);
-                writer.write(readBuffer.get(), readSize);
+                writer.write(chunk, chunkSize);
 
-                fileOff += readSize;
+                fileOff += chunkSize;
             }
             inst::ui::instPage::setInstBarPerc(100);
             inst::ui::instPage::setProgressDetailText("100% • done");
@@ -125,7 +136,18 @@ namespace tin::install::nsp
 
     void SDMCNSP::BufferData(void* buf, off_t offset, size_t size)
     {
+        std::lock_guard<std::mutex> lock(m_fileMutex);
         fseeko(m_nspFile, offset, SEEK_SET);
         fread(buf, 1, size, m_nspFile);
     }
+
+    bool SDMCNSP::CanStreamConcurrently()
+    {
+        return true;
+    }
+
+    std::string SDMCNSP::GetSourceName()
+    {
+        return m_sourceName;
+    }
 }
@@ -48,6 +48,11 @@ namespace tin::install::nsp
 
     }
 
+    std::string USBNSP::GetSourceName()
+    {
+        return "usb";
+    }
+
     struct USBFuncArgs
     {
         std::string nspName;
@@ -61,7 +66,6 @@ namespace tin::install::nsp
         USBFuncArgs* args = reinterpret_cast<USBFuncArgs*>(in);
         tin::util::USBCmdHeader header = tin::util::USBCmdManager::SendFileRangeCmd(args->nspName, args->pfs0Offset, args->ncaSize);
 
-        u8* buf = (u8*)memalign(0x1000, 0x800000);
         u64 sizeRemaining = header.dataSize;
         size_t tmpSizeRead = 0;
 
@@ -69,27 +73,26 @@ namespace tin::install::nsp
         {
             while (sizeRemaining && !stopThreadsUsbNsp)
             {
-                tmpSizeRead = awoo_usbCommsRead(buf, std::min(sizeRemaining, (u64)0x800000), 5000000000);
+                // Receive straight into the next free buffer segment
+                u8* span = NULL;
+                size_t spanSize = 0;
+                if (!args->bufferedPlaceholderWriter->ReserveAppendSpan(&span, &spanSize))
+                    break;
+
+                tmpSizeRead = awoo_usbCommsRead(span, std::min(sizeRemaining, (u64)spanSize), 5000000000);
                 if (tmpSizeRead == 0) THROW_FORMAT(("inst.usb.error"_lang).c_str());
                 sizeRemaining -= tmpSizeRead;
 
-                while (true)
-                {
-                    if (args->bufferedPlaceholderWriter->CanAppendData(tmpSizeRead))
-                        break;
-                }
-
-                args->bufferedPlaceholderWriter->AppendData(buf, tmpSizeRead);
+                args->bufferedPlaceholderWriter->CommitAppendSpan(tmpSizeRead);
             }
         }
         catch (std::exception& e)
         {
             stopThreadsUsbNsp = true;
+            args->bufferedPlaceholderWriter->Abort();
             errorMessageUsbNsp = e.what();
         }
 
-        free(buf);
-
         return 0;
     }
 
@@ -97,11 +100,8 @@ namespace tin::install::nsp
     {
         USBFuncArgs* args = reinterpret_cast<USBFuncArgs*>(in);
 
-        while (!args->bufferedPlaceholderWriter->IsPlaceholderComplete() && !stopThreadsUsbNsp)
-        {
-            if (args->bufferedPlaceholderWriter->CanWriteSegmentToPlaceholder())
-                args->bufferedPlaceholderWriter->WriteSegmentToPlaceholder();
-        }
+        while (!stopThreadsUsbNsp && args->bufferedPlaceholderWriter->WaitForSegmentToWrite())
+            args->bufferedPlaceholderWriter->WriteSegmentToPlaceholder();
 
         return 0;
     }
@@ -114,7 +114,7 @@ namespace tin::install::nsp
         LOG_DEBUG("Retrieving %s\n", ncaFileName.c_str());
         size_t ncaSize = fileEntry->fileSize;
 
-        tin::data::BufferedPlaceholderWriter bufferedPlaceholderWriter(contentStorage, placeholderId, ncaSize);
+        tin::data::BufferedPlaceholderWriter bufferedPlaceholderWriter(contentStorage, placeholderId, ncaSize, tin::data::BufferSourceProfile::USB);
         USBFuncArgs args;
         args.nspName = m_nspName;
         args.bufferedPlaceholderWriter = &bufferedPlaceholderWriter;
@@ -176,6 +176,8 @@ namespace tin::install::nsp
         }
         inst::ui::instPage::setInstBarPerc(100);
 
+        if (stopThreadsUsbNsp)
+            bufferedPlaceholderWriter.Abort();
         thrd_join(usbThread, NULL);
         thrd_join(writeThread, NULL);
         bufferedPlaceholderWriter.close();
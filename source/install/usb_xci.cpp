@@ -47,6 +47,11 @@ namespace tin::install::xci
 
     }
 
+    std::string USBXCI::GetSourceName()
+    {
+        return "usb";
+    }
+
     struct USBFuncArgs
     {
         std::string xciName;
@@ -60,7 +65,6 @@ namespace tin::install::xci
         USBFuncArgs* args = reinterpret_cast<USBFuncArgs*>(in);
         tin::util::USBCmdHeader header = tin::util::USBCmdManager::SendFileRangeCmd(args->xciName, args->hfs0Offset, args->ncaSize);
 
-        u8* buf = (u8*)memalign(0x1000, 0x800000);
         u64 sizeRemaining = header.dataSize;
         size_t tmpSizeRead = 0;
 
@@ -68,27 +72,26 @@ namespace tin::install::xci
         {
             while (sizeRemaining && !stopThreadsUsbXci)
             {
-                tmpSizeRead = awoo_usbCommsRead(buf, std::min(sizeRemaining, (u64)0x800000), 5000000000);
+                // Receive straight into the next free buffer segment
+                u8* span = NULL;
+                size_t spanSize = 0;
+                if (!args->bufferedPlaceholderWriter->ReserveAppendSpan(&span, &spanSize))
+                    break;
+
+                tmpSizeRead = awoo_usbCommsRead(span, std::min(sizeRemaining, (u64)spanSize), 5000000000);
                 if (tmpSizeRead == 0) THROW_FORMAT(("inst.usb.error"_lang).c_str());
                 sizeRemaining -= tmpSizeRead;
 
-                while (true)
-                {
-                    if (args->bufferedPlaceholderWriter->CanAppendData(tmpSizeRead))
-                        break;
-                }
-
-                args->bufferedPlaceholderWriter->AppendData(buf, tmpSizeRead);
+                args->bufferedPlaceholderWriter->CommitAppendSpan(tmpSizeRead);
             }
         }
         catch (std::exception& e)
         {
             stopThreadsUsbXci = true;
+            args->bufferedPlaceholderWriter->Abort();
             errorMessageUsbXci = e.what();
         }
 
-        free(buf);
-
         return 0;
     }
 
@@ -96,11 +99,8 @@ namespace tin::install::xci
     {
         USBFuncArgs* args = reinterpret_cast<USBFuncArgs*>(in);
 
-        while (!args->bufferedPlaceholderWriter->IsPlaceholderComplete() && !stopThreadsUsbXci)
-        {
-            if (args->bufferedPlaceholderWriter->CanWriteSegmentToPlaceholder())
-                args->bufferedPlaceholderWriter->WriteSegmentToPlaceholder();
-        }
+        while (!stopThreadsUsbXci && args->bufferedPlaceholderWriter->WaitForSegmentToWrite())
+            args->bufferedPlaceholderWriter->WriteSegmentToPlaceholder();
 
         return 0;
     }
@@ -113,7 +113,7 @@ namespace tin::install::xci
         LOG_DEBUG("Retrieving %s\n", ncaFileName.c_str());
         size_t ncaSize = fileEntry->fileSize;
 
-        tin::data::BufferedPlaceholderWriter bufferedPlaceholderWriter(contentStorage, placeholderId, ncaSize);
+        tin::data::BufferedPlaceholderWriter bufferedPlaceholderWriter(contentStorage, placeholderId, ncaSize, tin::data::BufferSourceProfile::USB);
         USBFuncArgs args;
         args.xciName = m_xciName;
         args.bufferedPlaceholderWriter = &bufferedPlaceholderWriter;
@@ -175,6 +175,8 @@ namespace tin::install::xci
         }
         inst::ui::instPage::setInstBarPerc(100);
 
+        if (stopThreadsUsbXci)
+            bufferedPlaceholderWriter.Abort();
         thrd_join(usbThread, NULL);
         thrd_join(writeThread, NULL);
         bufferedPlaceholderWriter.close();
@@ -21,6 +21,7 @@ SOFTWARE.
 */
 
 #include "install/xci.hpp"
+#include "install/header_reader.hpp"
 #include "util/title_util.hpp"
 #include "error.hpp"
 #include "debug.h"
@@ -38,10 +39,14 @@ namespace tin::install::xci
         // Retrieve hfs0 offset
         u64 hfs0Offset = 0xf000;
 
+        HeaderReader reader([this](void* buf, off_t offset, size_t size) {
+            this->BufferData(buf, offset, size);
+        }, HeaderReader::GetConfiguredWindowSize());
+
         // Retrieve main hfs0 header
         std::vector<u8> m_headerBytes;
         m_headerBytes.resize(sizeof(HFS0BaseHeader), 0);
-        this->BufferData(m_headerBytes.data(), hfs0Offset, sizeof(HFS0BaseHeader));
+        reader.Read(m_headerBytes.data(), hfs0Offset, sizeof(HFS0BaseHeader));
 
         LOG_DEBUG("Base header: \n");
         printBytes(m_headerBytes.data(), sizeof(HFS0BaseHeader), true);
@@ -60,10 +65,9 @@ namespace tin::install::xci
         if (remainingHeaderSize > maxHeaderSize)
             THROW_FORMAT("Invalid XCI header: header too large (0x%lx)\n", remainingHeaderSize);
         m_headerBytes.resize(sizeof(HFS0BaseHeader) + remainingHeaderSize, 0);
-        this->BufferData(m_headerBytes.data() + sizeof(HFS0BaseHeader), hfs0Offset + sizeof(HFS0BaseHeader), remainingHeaderSize);
+        reader.Read(m_headerBytes.data() + sizeof(HFS0BaseHeader), hfs0Offset + sizeof(HFS0BaseHeader), remainingHeaderSize);
 
-        LOG_DEBUG("Base header: \n");
-        printBytes(m_headerBytes.data(), sizeof(HFS0BaseHeader) + remainingHeaderSize, true);
+        LOG_DEBUG("Root header: 0x%lx bytes\n", m_headerBytes.size());
 
         // Find Secure partition
         header = reinterpret_cast<HFS0BaseHeader*>(m_headerBytes.data());
@@ -77,7 +81,7 @@ namespace tin::install::xci
 
             m_secureHeaderOffset = hfs0Offset + remainingHeaderSize + 0x10 + entry->dataOffset;
             m_secureHeaderBytes.resize(sizeof(HFS0BaseHeader), 0);
-            this->BufferData(m_secureHeaderBytes.data(), m_secureHeaderOffset, sizeof(HFS0BaseHeader));
+            reader.Read(m_secureHeaderBytes.data(), m_secureHeaderOffset, sizeof(HFS0BaseHeader));
 
             LOG_DEBUG("Secure header: \n");
             printBytes(m_secureHeaderBytes.data(), sizeof(HFS0BaseHeader), true);
@@ -94,10 +98,14 @@ namespace tin::install::xci
             if (remainingHeaderSize > maxHeaderSize)
                 THROW_FORMAT("Invalid XCI secure header: header too large (0x%lx)\n", remainingHeaderSize);
             m_secureHeaderBytes.resize(sizeof(HFS0BaseHeader) + remainingHeaderSize, 0);
-            this->BufferData(m_secureHeaderBytes.data() + sizeof(HFS0BaseHeader), m_secureHeaderOffset + sizeof(HFS0BaseHeader), remainingHeaderSize);
+            reader.Read(m_secureHeaderBytes.data() + sizeof(HFS0BaseHeader), m_secureHeaderOffset + sizeof(HFS0BaseHeader), remainingHeaderSize);
+
+            LOG_DEBUG("Secure header: 0x%lx bytes, %u round trip(s) in total\n", m_secureHeaderBytes.size(), reader.GetRoundTrips());
 
-            LOG_DEBUG("Base header: \n");
-            printBytes(m_secureHeaderBytes.data(), sizeof(HFS0BaseHeader) + remainingHeaderSize, true);
+            const HFS0BaseHeader* secureHeader = this->GetSecureHeader();
+            m_fileIndex.Build(secureHeader->numFiles, hfs0GetStringTable(secureHeader), secureHeader->stringTableSize, [secureHeader](u32 i) {
+                return hfs0GetFileEntry(secureHeader, i)->stringTableOffset;
+            });
             return;
         }
         THROW_FORMAT("couldn't optain secure hfs0 header\n");
@@ -111,6 +119,16 @@ namespace tin::install::xci
         return reinterpret_cast<HFS0BaseHeader*>(m_secureHeaderBytes.data());
     }
 
+    bool XCI::CanStreamConcurrently()
+    {
+        return false;
+    }
+
+    std::string XCI::GetSourceName()
+    {
+        return "unknown";
+    }
+
     u64 XCI::GetDataOffset()
     {
         if (m_secureHeaderBytes.empty())
@@ -129,53 +147,25 @@ namespace tin::install::xci
 
     const HFS0FileEntry* XCI::GetFileEntryByName(std::string name)
     {
-        for (unsigned int i = 0; i < this->GetSecureHeader()->numFiles; i++)
-        {
-            const HFS0FileEntry* fileEntry = this->GetFileEntry(i);
-            std::string foundName(this->GetFileEntryName(fileEntry));
-
-            if (foundName == name)
-                return fileEntry;
-        }
-
-        return nullptr;
+        this->GetSecureHeader();
+        u32 index = m_fileIndex.FindByName(name);
+        return index != FileEntryIndex::NOT_FOUND ? this->GetFileEntry(index) : nullptr;
     }
 
     const HFS0FileEntry* XCI::GetFileEntryByNcaId(const NcmContentId& ncaId)
     {
-        const HFS0FileEntry* fileEntry = nullptr;
-        std::string ncaIdStr = tin::util::GetNcaIdString(ncaId);
-
-        if ((fileEntry = this->GetFileEntryByName(ncaIdStr + ".nca")) == nullptr)
-        {
-            if ((fileEntry = this->GetFileEntryByName(ncaIdStr + ".cnmt.nca")) == nullptr)
-            {
-                    if ((fileEntry = this->GetFileEntryByName(ncaIdStr + ".ncz")) == nullptr)
-                    {
-                         if ((fileEntry = this->GetFileEntryByName(ncaIdStr + ".cnmt.ncz")) == nullptr)
-                         {
-                              return nullptr;
-                         }
-                    }
-            }
-        }
-
-        return fileEntry;
+        this->GetSecureHeader();
+        u32 index = m_fileIndex.FindByNcaId(ncaId);
+        return index != FileEntryIndex::NOT_FOUND ? this->GetFileEntry(index) : nullptr;
     }
 
     std::vector<const HFS0FileEntry*> XCI::GetFileEntriesByExtension(std::string extension)
     {
         std::vector<const HFS0FileEntry*> entryList;
+        this->GetSecureHeader();
 
-        for (unsigned int i = 0; i < this->GetSecureHeader()->numFiles; i++)
-        {
-            const HFS0FileEntry* fileEntry = this->GetFileEntry(i);
-            std::string name(this->GetFileEntryName(fileEntry));
-            auto foundExtension = name.substr(name.find(".") + 1); 
-
-            if (foundExtension == extension)
-                entryList.push_back(fileEntry);
-        }
+        for (u32 index : m_fileIndex.FindByExtension(extension))
+            entryList.push_back(this->GetFileEntry(index));
 
         return entryList;
     }
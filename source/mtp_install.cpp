@@ -527,69 +527,120 @@ bool MtpNspStream::Finalize()
     return ok;
 }
 
+// Single-producer/single-consumer ring shared between the MTP feed thread and
+// the XCI install worker. Positions only ever grow, so used = write - read and
+// each side touches only its own half of the ring; the mutex is taken only to
+// park a side that has run out of data or space.
 class MtpStreamBuffer {
 public:
-    explicit MtpStreamBuffer(size_t max_size) : m_max_size(max_size) {}
+    explicit MtpStreamBuffer(size_t capacity) : m_data(capacity), m_capacity(capacity) {}
 
     bool Push(const void* buf, size_t size) {
         const auto* data = static_cast<const std::uint8_t*>(buf);
         while (size > 0) {
-            std::unique_lock<std::mutex> lock(m_mutex);
-            m_can_write.wait(lock, [&]() { return !m_active || m_buffer.size() < m_max_size; });
-            if (!m_active) return false;
-
-            const size_t writable = m_max_size - m_buffer.size();
-            const size_t chunk = std::min<size_t>(size, writable);
-            const size_t offset = m_buffer.size();
-            m_buffer.resize(offset + chunk);
-            std::memcpy(m_buffer.data() + offset, data, chunk);
+            std::uint8_t* span = nullptr;
+            size_t span_size = 0;
+            if (!AcquireWrite(&span, &span_size)) return false;
+
+            const size_t chunk = std::min<size_t>(size, span_size);
+            std::memcpy(span, data, chunk);
+            CommitWrite(chunk);
             data += chunk;
             size -= chunk;
-            lock.unlock();
+        }
+        return true;
+    }
+
+    // Blocks until there is free space and exposes the contiguous writable region.
+    bool AcquireWrite(std::uint8_t** out, size_t* out_size) {
+        if (!m_active.load() || GetBufferedSize() >= m_capacity) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_writer_waiting.store(true);
+            m_can_write.wait(lock, [&]() { return !m_active.load() || GetBufferedSize() < m_capacity; });
+            m_writer_waiting.store(false);
+            if (!m_active.load()) return false;
+        }
+
+        const u64 write_pos = m_write_pos.load();
+        const size_t start = static_cast<size_t>(write_pos % m_capacity);
+        const size_t free_size = m_capacity - GetBufferedSize();
+        *out = m_data.data() + start;
+        *out_size = std::min<size_t>(free_size, m_capacity - start);
+        return true;
+    }
+
+    void CommitWrite(size_t size) {
+        m_write_pos.fetch_add(size);
+        if (m_reader_waiting.load()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
             m_can_read.notify_one();
         }
+    }
+
+    // Blocks until data is buffered and exposes the contiguous readable region.
+    // Returns false once the buffer has been disabled and fully drained.
+    bool AcquireRead(const std::uint8_t** out, size_t* out_size) {
+        if (GetBufferedSize() == 0) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_reader_waiting.store(true);
+            m_can_read.wait(lock, [&]() { return !m_active.load() || GetBufferedSize() > 0; });
+            m_reader_waiting.store(false);
+        }
+
+        const size_t buffered = GetBufferedSize();
+        if (buffered == 0) return false;
+
+        const size_t start = static_cast<size_t>(m_read_pos.load() % m_capacity);
+        *out = m_data.data() + start;
+        *out_size = std::min<size_t>(buffered, m_capacity - start);
         return true;
     }
 
+    void CommitRead(size_t size) {
+        m_read_pos.fetch_add(size);
+        if (m_writer_waiting.load()) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_can_write.notify_one();
+        }
+    }
+
     bool ReadChunk(void* buf, size_t size, u64* out_read) {
-        auto* out = static_cast<std::uint8_t*>(buf);
         *out_read = 0;
-        std::unique_lock<std::mutex> lock(m_mutex);
-        while (m_active && m_buffer.empty()) {
-            m_can_read.wait(lock);
-        }
-        if (!m_active && m_buffer.empty()) {
+        const std::uint8_t* span = nullptr;
+        size_t span_size = 0;
+        if (!AcquireRead(&span, &span_size)) {
             return false;
         }
 
-        const size_t chunk = std::min<size_t>(size, m_buffer.size());
-        std::memcpy(out, m_buffer.data(), chunk);
-        m_buffer.erase(m_buffer.begin(), m_buffer.begin() + chunk);
+        const size_t chunk = std::min<size_t>(size, span_size);
+        std::memcpy(buf, span, chunk);
+        CommitRead(chunk);
         *out_read = chunk;
-        lock.unlock();
-        m_can_write.notify_one();
         return true;
     }
 
     void Disable() {
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_active = false;
+        m_active.store(false);
         m_can_read.notify_all();
         m_can_write.notify_all();
     }
 
     size_t GetBufferedSize() const {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        return m_buffer.size();
+        return static_cast<size_t>(m_write_pos.load() - m_read_pos.load());
     }
 
 private:
-    mutable std::mutex m_mutex;
+    std::vector<std::uint8_t> m_data;
+    size_t m_capacity = 0;
+    std::atomic<u64> m_read_pos{0};
+    std::atomic<u64> m_write_pos{0};
+    std::atomic<bool> m_active{true};
+    std::atomic<bool> m_reader_waiting{false};
+    std::atomic<bool> m_writer_waiting{false};
+    std::mutex m_mutex;
     std::condition_variable m_can_read;
     std::condition_variable m_can_write;
-    std::vector<std::uint8_t> m_buffer;
-    size_t m_max_size = 0;
-    bool m_active = true;
 };
 
 class MtpStreamSource {
@@ -597,45 +648,66 @@ public:
     explicit MtpStreamSource(MtpStreamBuffer& buffer) : m_buffer(buffer) {}
 
     Result Read(void* buf, s64 off, s64 size, u64* bytes_read) {
+        auto* out = static_cast<std::uint8_t*>(buf);
+        *bytes_read = 0;
+
+        while (size > 0) {
+            const std::uint8_t* span = nullptr;
+            u64 span_size = 0;
+            const Result rc = Peek(off, size, &span, &span_size);
+            if (R_FAILED(rc)) return rc;
+
+            std::memcpy(out, span, static_cast<size_t>(span_size));
+            Consume(span_size);
+            *bytes_read += span_size;
+            out += span_size;
+            off += static_cast<s64>(span_size);
+            size -= static_cast<s64>(span_size);
+        }
+
+        return 0;
+    }
+
+    // Discards everything before off and exposes up to max_size buffered bytes
+    // in place. The span stays valid until Consume() is called.
+    Result Peek(s64 off, s64 max_size, const std::uint8_t** out, u64* out_size) {
         if (off < m_offset) {
             StreamTrace("XCI SourceRead bad off=%lld cur=%lld size=%lld",
                 static_cast<long long>(off),
                 static_cast<long long>(m_offset),
-                static_cast<long long>(size));
+                static_cast<long long>(max_size));
             return MAKERESULT(Module_Libnx, LibnxError_BadInput);
         }
 
-        auto* out = static_cast<std::uint8_t*>(buf);
-        *bytes_read = 0;
-        std::vector<std::uint8_t> temp(0x80000);
+        *out = nullptr;
+        *out_size = 0;
+        while (true) {
+            const std::uint8_t* span = nullptr;
+            size_t span_size = 0;
+            if (!m_buffer.AcquireRead(&span, &span_size)) {
+                StreamTrace("XCI SourceRead %s failed off=%lld cur=%lld",
+                    off > m_offset ? "skip" : "data",
+                    static_cast<long long>(off),
+                    static_cast<long long>(m_offset));
+                return KERNELRESULT(NotImplemented);
+            }
 
-        while (size > 0) {
             if (off > m_offset) {
-                const auto skip = static_cast<s64>(off - m_offset);
-                const auto chunk = static_cast<size_t>(std::min<s64>(skip, static_cast<s64>(temp.size())));
-                u64 read = 0;
-                if (!m_buffer.ReadChunk(temp.data(), chunk, &read)) {
-                    StreamTrace("XCI SourceRead skip failed off=%lld chunk=%zu", static_cast<long long>(off), chunk);
-                    return KERNELRESULT(NotImplemented);
-                }
-                m_offset += static_cast<s64>(read);
+                const auto skip = static_cast<size_t>(std::min<s64>(off - m_offset, static_cast<s64>(span_size)));
+                m_buffer.CommitRead(skip);
+                m_offset += static_cast<s64>(skip);
                 continue;
             }
 
-            const auto chunk = static_cast<size_t>(std::min<s64>(size, static_cast<s64>(temp.size())));
-            u64 read = 0;
-            if (!m_buffer.ReadChunk(out, chunk, &read)) {
-                StreamTrace("XCI SourceRead data failed off=%lld chunk=%zu", static_cast<long long>(off), chunk);
-                return KERNELRESULT(NotImplemented);
-            }
-            *bytes_read += read;
-            out += read;
-            m_offset += static_cast<s64>(read);
-            off += static_cast<s64>(read);
-            size -= static_cast<s64>(read);
+            *out = span;
+            *out_size = std::min<u64>(span_size, static_cast<u64>(max_size));
+            return 0;
         }
+    }
 
-        return 0;
+    void Consume(u64 size) {
+        m_buffer.CommitRead(static_cast<size_t>(size));
+        m_offset += static_cast<s64>(size);
     }
 
 private:
@@ -900,7 +972,6 @@ private:
 
         std::unordered_map<std::string, EntryState> entries;
         entries.reserve(collections.size());
-        std::vector<std::uint8_t> buf(0x400000);
 
         for (const auto& collection : collections) {
             EntryState entry;
@@ -924,25 +995,27 @@ private:
                 static_cast<unsigned long long>(collection.offset),
                 static_cast<unsigned long long>(collection.size));
             while (remaining > 0) {
-                const auto chunk = static_cast<size_t>(std::min<u64>(remaining, buf.size()));
+                // Hand the ring's own memory to the writer instead of staging it in a copy.
+                const std::uint8_t* span = nullptr;
                 u64 bytes_read = 0;
-                if (R_FAILED(source.Read(buf.data(), static_cast<s64>(offset), static_cast<s64>(chunk), &bytes_read))) {
-                    StreamTrace("XCI Source.Read fail name='%s' off=%llu chunk=%zu",
+                if (R_FAILED(source.Peek(static_cast<s64>(offset), static_cast<s64>(remaining), &span, &bytes_read))) {
+                    StreamTrace("XCI Source.Read fail name='%s' off=%llu remaining=%llu",
                         entry.name.c_str(),
                         static_cast<unsigned long long>(offset),
-                        chunk);
+                        static_cast<unsigned long long>(remaining));
                     return false;
                 }
                 if (bytes_read == 0) {
                     StreamTrace("XCI Source.Read eof name='%s' off=%llu", entry.name.c_str(), static_cast<unsigned long long>(offset));
                     return false;
                 }
-                if (!WriteEntryData(entry, buf.data(), static_cast<size_t>(bytes_read))) {
+                if (!WriteEntryData(entry, span, static_cast<size_t>(bytes_read))) {
                     StreamTrace("XCI WriteEntryData fail name='%s' bytes=%llu",
                         entry.name.c_str(),
                         static_cast<unsigned long long>(bytes_read));
                     return false;
                 }
+                source.Consume(bytes_read);
                 offset += bytes_read;
                 remaining -= bytes_read;
             }
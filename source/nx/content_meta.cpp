@@ -21,7 +21,6 @@ SOFTWARE.
 */
 
 #include "nx/content_meta.hpp"
-
 #include <string.h>
 #include "util/title_util.hpp"
 #include "util/debug.h"
@@ -32,6 +31,7 @@ namespace nx::ncm
     ContentMeta::ContentMeta()
     {
         m_bytes.Resize(sizeof(PackagedContentMetaHeader));
+        this->Parse();
     }
 
     ContentMeta::ContentMeta(u8* data, size_t size) :
@@ -42,91 +42,92 @@ namespace nx::ncm
 
         m_bytes.Resize(size);
         memcpy(m_bytes.GetData(), data, size);
+        this->Parse();
     }
 
-    PackagedContentMetaHeader ContentMeta::GetPackagedContentMetaHeader()
+    void ContentMeta::Parse()
     {
-        return m_bytes.Read<PackagedContentMetaHeader>(0);
-    }
+        const u8* bytes = m_bytes.GetData();
+        const size_t size = m_bytes.GetSize();
+        memcpy(&m_header, bytes, sizeof(PackagedContentMetaHeader));
 
-    NcmContentMetaKey ContentMeta::GetContentMetaKey()
-    {
-        NcmContentMetaKey metaRecord;
-        PackagedContentMetaHeader contentMetaHeader = this->GetPackagedContentMetaHeader();
+        const size_t contentInfosOffset = sizeof(PackagedContentMetaHeader) + m_header.extended_header_size;
+        if (contentInfosOffset + static_cast<size_t>(m_header.content_count) * sizeof(PackagedContentInfo) > size)
+            THROW_FORMAT("Content meta data is truncated!");
 
-        memset(&metaRecord, 0, sizeof(NcmContentMetaKey));
-        metaRecord.id = contentMetaHeader.title_id;
-        metaRecord.version = contentMetaHeader.version;
-        metaRecord.type = static_cast<NcmContentMetaType>(contentMetaHeader.type);
+        m_extendedHeader.assign(bytes + sizeof(PackagedContentMetaHeader), bytes + contentInfosOffset);
 
-        return metaRecord;
-    }
+        if (m_header.type == NcmContentMetaType_Patch && m_extendedHeader.size() >= sizeof(NcmPatchMetaExtendedHeader))
+            m_extendedDataSize = reinterpret_cast<const NcmPatchMetaExtendedHeader*>(m_extendedHeader.data())->extended_data_size;
 
-    // TODO: Cache this
-    std::vector<NcmContentInfo> ContentMeta::GetContentInfos()
-    {
-        PackagedContentMetaHeader contentMetaHeader = this->GetPackagedContentMetaHeader();
-
-        std::vector<NcmContentInfo> contentInfos;
-        PackagedContentInfo* packagedContentInfos = (PackagedContentInfo*)(m_bytes.GetData() + sizeof(PackagedContentMetaHeader) + contentMetaHeader.extended_header_size);
-
-        for (unsigned int i = 0; i < contentMetaHeader.content_count; i++)
+        m_contentInfos.reserve(m_header.content_count);
+        for (unsigned int i = 0; i < m_header.content_count; i++)
         {
-            PackagedContentInfo packagedContentInfo = packagedContentInfos[i];
+            PackagedContentInfo packagedContentInfo;
+            memcpy(&packagedContentInfo, bytes + contentInfosOffset + i * sizeof(PackagedContentInfo), sizeof(PackagedContentInfo));
 
             // Don't install delta fragments. Even patches don't seem to install them.
             if (static_cast<u8>(packagedContentInfo.content_info.content_type) <= 5)
             {
-                contentInfos.push_back(packagedContentInfo.content_info); 
+                m_contentInfos.push_back(packagedContentInfo.content_info);
             }
         }
+    }
 
-        return contentInfos;
+    PackagedContentMetaHeader ContentMeta::GetPackagedContentMetaHeader() const
+    {
+        return m_header;
     }
 
-    void ContentMeta::GetInstallContentMeta(tin::data::ByteBuffer& installContentMetaBuffer, NcmContentInfo& cnmtNcmContentInfo, bool ignoreReqFirmVersion)
+    NcmContentMetaKey ContentMeta::GetContentMetaKey() const
     {
-        PackagedContentMetaHeader packagedContentMetaHeader = this->GetPackagedContentMetaHeader();
-        std::vector<NcmContentInfo> contentInfos = this->GetContentInfos();
+        NcmContentMetaKey metaRecord;
+
+        memset(&metaRecord, 0, sizeof(NcmContentMetaKey));
+        metaRecord.id = m_header.title_id;
+        metaRecord.version = m_header.version;
+        metaRecord.type = static_cast<NcmContentMetaType>(m_header.type);
 
+        return metaRecord;
+    }
+
+    const std::vector<NcmContentInfo>& ContentMeta::GetContentInfos() const
+    {
+        return m_contentInfos;
+    }
+
+    void ContentMeta::GetInstallContentMeta(tin::data::ByteBuffer& installContentMetaBuffer, NcmContentInfo& cnmtNcmContentInfo, bool ignoreReqFirmVersion) const
+    {
         // Setup the content meta header
         NcmContentMetaHeader contentMetaHeader;
-        contentMetaHeader.extended_header_size = packagedContentMetaHeader.extended_header_size;
-        contentMetaHeader.content_count = contentInfos.size() + 1; // Add one for the cnmt content record
-        contentMetaHeader.content_meta_count = packagedContentMetaHeader.content_meta_count;
-        contentMetaHeader.attributes = packagedContentMetaHeader.attributes;
+        contentMetaHeader.extended_header_size = m_header.extended_header_size;
+        contentMetaHeader.content_count = m_contentInfos.size() + 1; // Add one for the cnmt content record
+        contentMetaHeader.content_meta_count = m_header.content_meta_count;
+        contentMetaHeader.attributes = m_header.attributes;
         contentMetaHeader.storage_id = 0;
 
-        installContentMetaBuffer.Append<NcmContentMetaHeader>(contentMetaHeader);
+        // Size the buffer once: header, extended header, cnmt record, content records, then the patch extended data
+        const size_t start = installContentMetaBuffer.GetSize();
+        const size_t extendedHeaderOffset = start + sizeof(NcmContentMetaHeader);
+        const size_t contentInfosOffset = extendedHeaderOffset + m_extendedHeader.size();
+        const size_t contentInfosSize = (m_contentInfos.size() + 1) * sizeof(NcmContentInfo);
+        installContentMetaBuffer.Resize(contentInfosOffset + contentInfosSize + m_extendedDataSize);
+        LOG_DEBUG("Install content meta size: 0x%lx\n", installContentMetaBuffer.GetSize());
 
-        // Setup the meta extended header
-        LOG_DEBUG("Install content meta pre size: 0x%lx\n", installContentMetaBuffer.GetSize());
-        installContentMetaBuffer.Resize(installContentMetaBuffer.GetSize() + contentMetaHeader.extended_header_size);
-        LOG_DEBUG("Install content meta post size: 0x%lx\n", installContentMetaBuffer.GetSize());
-        auto* extendedHeaderSourceBytes = m_bytes.GetData() + sizeof(PackagedContentMetaHeader);
-        u8* installExtendedHeaderStart = installContentMetaBuffer.GetData() + sizeof(NcmContentMetaHeader);
-        memcpy(installExtendedHeaderStart, extendedHeaderSourceBytes, contentMetaHeader.extended_header_size);
+        u8* out = installContentMetaBuffer.GetData();
+        memcpy(out + start, &contentMetaHeader, sizeof(NcmContentMetaHeader));
+        if (!m_extendedHeader.empty())
+            memcpy(out + extendedHeaderOffset, m_extendedHeader.data(), m_extendedHeader.size());
 
         // Optionally disable the required system version field
-        if (ignoreReqFirmVersion && (packagedContentMetaHeader.type == NcmContentMetaType_Application || packagedContentMetaHeader.type == NcmContentMetaType_Patch))
+        if (ignoreReqFirmVersion && (m_header.type == NcmContentMetaType_Application || m_header.type == NcmContentMetaType_Patch))
         {
-            installContentMetaBuffer.Write<u32>(0, sizeof(NcmContentMetaHeader) + 8);
+            installContentMetaBuffer.Write<u32>(0, extendedHeaderOffset + 8);
         }
 
-        // Setup cnmt content record
-        installContentMetaBuffer.Append<NcmContentInfo>(cnmtNcmContentInfo);
-
-        // Setup the content records
-        for (auto& contentInfo : contentInfos)
-        {
-            installContentMetaBuffer.Append<NcmContentInfo>(contentInfo);
-        }
-
-        if (packagedContentMetaHeader.type == NcmContentMetaType_Patch)
-        {
-            NcmPatchMetaExtendedHeader* patchMetaExtendedHeader = (NcmPatchMetaExtendedHeader*)extendedHeaderSourceBytes;
-            installContentMetaBuffer.Resize(installContentMetaBuffer.GetSize() + patchMetaExtendedHeader->extended_data_size);
-        }
+        // Setup the cnmt content record, followed by the content records
+        memcpy(out + contentInfosOffset, &cnmtNcmContentInfo, sizeof(NcmContentInfo));
+        if (!m_contentInfos.empty())
+            memcpy(out + contentInfosOffset + sizeof(NcmContentInfo), m_contentInfos.data(), m_contentInfos.size() * sizeof(NcmContentInfo));
     }
-}
-
+}
\ No newline at end of file
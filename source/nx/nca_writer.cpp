@@ -30,6 +30,12 @@ SOFTWARE.
 #include "util/title_util.hpp"
 #include "install/nca.hpp"
 #include <limits>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
 
 // region Utility Functions, Classes, Structs
 
@@ -72,13 +78,49 @@ struct MallocDeleter {
      }
 };
 
-// Custom deleter for ZSTD_DCtx
+// ZSTD_DCtx cache shared by every NCZ in an install session, so each NCA
+// does not allocate a fresh context (and window buffer) of its own
+static std::mutex g_dctxPoolMutex;
+static std::vector<ZSTD_DCtx*> g_dctxPool;
+
+// Pooled contexts keep their window buffers, so only as many are kept as one NCZ can have in use
+// at once: the NCZBLOCK workers plus the streaming decompressor. Extra ones are freed on release.
+static size_t maxPooledDCtx()
+{
+     return (size_t)std::clamp(inst::config::nczDecompressThreads, 1, 4) + 1;
+}
+
+// Custom deleter for ZSTD_DCtx - returns the context to the pool
 struct ZstdDCtxDeleter {
      void operator()(ZSTD_DCtx* ctx) const {
-          if (ctx) ZSTD_freeDCtx(ctx);
+          if (!ctx) return;
+          ZSTD_DCtx_reset(ctx, ZSTD_reset_session_only);
+          {
+               std::lock_guard<std::mutex> lock(g_dctxPoolMutex);
+               if (g_dctxPool.size() < maxPooledDCtx())
+               {
+                    g_dctxPool.push_back(ctx);
+                    return;
+               }
+          }
+          ZSTD_freeDCtx(ctx);
      }
 };
 
+static std::unique_ptr<ZSTD_DCtx, ZstdDCtxDeleter> acquireZstdDCtx()
+{
+     {
+          std::lock_guard<std::mutex> lock(g_dctxPoolMutex);
+          if (!g_dctxPool.empty())
+          {
+               ZSTD_DCtx* ctx = g_dctxPool.back();
+               g_dctxPool.pop_back();
+               return std::unique_ptr<ZSTD_DCtx, ZstdDCtxDeleter>(ctx, ZstdDCtxDeleter());
+          }
+     }
+     return std::unique_ptr<ZSTD_DCtx, ZstdDCtxDeleter>(ZSTD_createDCtx(), ZstdDCtxDeleter());
+}
+
 // endregion
 
 // region Header Structs
@@ -189,6 +231,226 @@ struct NczBlockHeader {
 
 // endregion
 
+// region Placeholder Write Queue
+
+// Owns the placeholder writes of one NcaBodyWriter on a dedicated thread, so
+// decompression and re-encryption keep going while storage is busy.
+// When writes back up, contiguous queued buffers are copied into one reused staging buffer and
+// written with a single WritePlaceholder. The queued buffers go back to the producer before that
+// write starts, so a writer never holds more than NcaBodyWriter::MAX_BUFFERED_SIZE.
+class PlaceholderWriteQueue
+{
+public:
+     static constexpr size_t MAX_QUEUED_WRITES = 2;
+     static constexpr u64 MAX_COALESCED_WRITE = NcaBodyWriter::CONTENT_BUFFER_SIZE * MAX_QUEUED_WRITES;
+     // Producer buffer + queued (or draining) buffers + staging buffer
+     static_assert(NcaBodyWriter::CONTENT_BUFFER_SIZE * (1 + MAX_QUEUED_WRITES) + MAX_COALESCED_WRITE == NcaBodyWriter::MAX_BUFFERED_SIZE);
+
+     PlaceholderWriteQueue(const NcmContentId& ncaId, const std::shared_ptr<nx::ncm::ContentStorage>& contentStorage)
+          : m_ncaId(ncaId), m_contentStorage(contentStorage)
+     {
+          m_thread = std::thread([this]() { workerMain(); });
+     }
+
+     ~PlaceholderWriteQueue()
+     {
+          // Not finished normally (install failed) - drop whatever is still queued
+          {
+               std::lock_guard<std::mutex> lock(m_mutex);
+               m_abandoned = true;
+          }
+          stop();
+     }
+
+     // Queues buffer to be written at offset and hands back an empty buffer to refill.
+     // Blocks while the queue is full.
+     void submit(u64 offset, std::vector<u8>& buffer)
+     {
+          Write write;
+          write.offset = offset;
+          write.data.swap(buffer);
+
+          {
+               std::unique_lock<std::mutex> lock(m_mutex);
+               if (m_error.empty() && m_queue.size() + m_draining >= MAX_QUEUED_WRITES)
+               {
+                    const u64 waitStart = armGetSystemTick();
+                    m_spaceCond.wait(lock, [&]() { return !m_error.empty() || m_queue.size() + m_draining < MAX_QUEUED_WRITES; });
+                    m_stallTicks += armGetSystemTick() - waitStart;
+                    m_stalls++;
+               }
+
+               if (!m_error.empty())
+                    THROW_FORMAT("PlaceholderWriteQueue: %s", m_error.c_str());
+
+               m_queue.push_back(std::move(write));
+               m_submitted++;
+
+               if (!m_spare.empty())
+               {
+                    buffer.swap(m_spare.back());
+                    m_spare.pop_back();
+               }
+          }
+          m_workCond.notify_one();
+
+          buffer.clear();
+          buffer.reserve(NcaBodyWriter::CONTENT_BUFFER_SIZE);
+     }
+
+     // Waits for all queued writes to land. Throws if any of them failed.
+     void finish()
+     {
+          stop();
+
+          LOG_DEBUG("PlaceholderWriteQueue: %llu buffers in %llu writes (%llu coalesced), %llu stalls for %llu ms",
+               (unsigned long long)m_submitted, (unsigned long long)m_written, (unsigned long long)m_coalesced,
+               (unsigned long long)m_stalls, (unsigned long long)(m_stallTicks * 1000 / armGetSystemTickFreq()));
+
+          if (!m_error.empty())
+               THROW_FORMAT("PlaceholderWriteQueue: %s", m_error.c_str());
+     }
+
+private:
+     struct Write
+     {
+          u64 offset = 0;
+          std::vector<u8> data;
+     };
+
+     void stop()
+     {
+          {
+               std::lock_guard<std::mutex> lock(m_mutex);
+               m_stop = true;
+          }
+          m_workCond.notify_all();
+
+          if (m_thread.joinable())
+               m_thread.join();
+     }
+
+     // Hands drained buffers back to the producer and lets submit() continue.
+     void releaseBatch(std::vector<Write>& batch)
+     {
+          {
+               std::lock_guard<std::mutex> lock(m_mutex);
+               for (Write& write : batch)
+               {
+                    if (m_spare.size() < MAX_QUEUED_WRITES && write.data.capacity() == NcaBodyWriter::CONTENT_BUFFER_SIZE)
+                         m_spare.push_back(std::move(write.data));
+               }
+               m_draining = 0;
+          }
+          batch.clear();
+          m_spaceCond.notify_all();
+     }
+
+     void workerMain()
+     {
+          while (true)
+          {
+               std::vector<Write> batch;
+               bool skip = false;
+               {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_workCond.wait(lock, [&]() { return m_stop || !m_queue.empty(); });
+                    if (m_queue.empty())
+                         return; // Stopped and fully drained
+
+                    // Take the oldest write plus whatever queued up behind it. Until released, these
+                    // buffers still count against MAX_QUEUED_WRITES.
+                    while (!m_queue.empty())
+                    {
+                         batch.push_back(std::move(m_queue.front()));
+                         m_queue.pop_front();
+                    }
+                    m_draining = batch.size();
+                    skip = m_abandoned || !m_error.empty();
+               }
+
+               if (skip)
+               {
+                    releaseBatch(batch);
+                    continue;
+               }
+
+               bool contiguous = batch.size() > 1;
+               for (size_t i = 1; contiguous && i < batch.size(); i++)
+                    contiguous = batch[i].offset == batch[i - 1].offset + batch[i - 1].data.size();
+
+               std::string error;
+               u64 written = 0;
+               u64 coalesced = 0;
+               try
+               {
+                    if (contiguous)
+                    {
+                         // Reserved on first use only, so small NCAs never allocate it
+                         if (m_staging.capacity() < MAX_COALESCED_WRITE)
+                              m_staging.reserve(MAX_COALESCED_WRITE);
+                         m_staging.clear();
+                         const u64 offset = batch[0].offset;
+                         for (const Write& write : batch)
+                              append(m_staging, write.data.data(), write.data.size());
+                         coalesced = batch.size();
+                         releaseBatch(batch);
+
+                         m_contentStorage->WritePlaceholder(*(NcmPlaceHolderId*)&m_ncaId, offset, m_staging.data(), m_staging.size());
+                         written++;
+                    }
+                    else
+                    {
+                         for (Write& write : batch)
+                         {
+                              m_contentStorage->WritePlaceholder(*(NcmPlaceHolderId*)&m_ncaId, write.offset, write.data.data(), write.data.size());
+                              written++;
+                         }
+                    }
+               }
+               catch (std::exception& e)
+               {
+                    error = e.what();
+               }
+               releaseBatch(batch);
+
+               std::lock_guard<std::mutex> lock(m_mutex);
+               m_written += written;
+               m_coalesced += coalesced;
+               if (!error.empty() && m_error.empty())
+               {
+                    m_error = error;
+                    m_spaceCond.notify_all();
+               }
+          }
+     }
+
+     NcmContentId m_ncaId;
+     std::shared_ptr<nx::ncm::ContentStorage> m_contentStorage;
+
+     std::mutex m_mutex;
+     std::condition_variable m_workCond;  // Writer thread waits for queued buffers
+     std::condition_variable m_spaceCond; // Producer waits for room in the queue
+     std::deque<Write> m_queue;
+     std::vector<std::vector<u8>> m_spare;
+     std::vector<u8> m_staging;  // Only touched by the writer thread
+     size_t m_draining = 0;      // Buffers taken off the queue but not yet released
+     bool m_stop = false;
+     bool m_abandoned = false;
+     std::string m_error;
+
+     // Backpressure statistics
+     u64 m_submitted = 0;
+     u64 m_written = 0;
+     u64 m_coalesced = 0;  // Buffers merged into a staging write
+     u64 m_stalls = 0;
+     u64 m_stallTicks = 0;
+
+     std::thread m_thread;
+};
+
+// endregion
+
 // region NcaBodyWriter Methods
 
 NcaBodyWriter::NcaBodyWriter(const NcmContentId& ncaId, u64 offset, std::shared_ptr<nx::ncm::ContentStorage>& contentStorage)
@@ -200,7 +462,15 @@ NcaBodyWriter::NcaBodyWriter(const NcmContentId& ncaId, u64 offset, std::shared_
 
 NcaBodyWriter::~NcaBodyWriter()
 {
-     NcaBodyWriter::close();
+     // Destruction may happen while an install error unwinds, so a failed flush must not throw again
+     try
+     {
+          NcaBodyWriter::close();
+     }
+     catch (std::exception& e)
+     {
+          LOG_DEBUG("NcaBodyWriter close failed during destruction: %s\n", e.what());
+     }
 }
 
 void NcaBodyWriter::close()
@@ -211,6 +481,13 @@ void NcaBodyWriter::close()
 
      flushContentBuffer(); // Virtual dispatch - overrides expected to invoke parent
 
+     if (m_writeQueue)
+     {
+          // Placeholder must be complete before the caller registers it
+          auto writeQueue = std::move(m_writeQueue);
+          writeQueue->finish();
+     }
+
      doClose(); // Derived cleanup before finalizing close
 
      // Free resources
@@ -274,8 +551,12 @@ void NcaBodyWriter::flushContentBuffer()
 
      if (m_contentStorage)
      {
-          m_contentStorage->WritePlaceholder(*(NcmPlaceHolderId*)&m_ncaId, m_offset, m_contentBuffer.data(), m_contentBuffer.size());
-          m_offset += m_contentBuffer.size();
+          if (!m_writeQueue)
+               m_writeQueue = std::make_unique<PlaceholderWriteQueue>(m_ncaId, m_contentStorage);
+
+          const u64 size = m_contentBuffer.size();
+          m_writeQueue->submit(m_offset, m_contentBuffer); // Swaps in an empty buffer
+          m_offset += size;
      }
 
      m_contentBuffer.resize(0);
@@ -327,6 +608,7 @@ private:
 };
 
 // ZSTD Stream Writer - handles streaming ZSTD compression
+// Output is batched into a large window so the CTR/flush path sees few big writes
 class ZstdStreamWriter : public CloseableWriter
 {
 public:
@@ -335,9 +617,10 @@ public:
      ZstdStreamWriter(const std::function<WriterFn>& writeFn)
           : m_writeFn(writeFn),
             m_buffInSize(ZSTD_DStreamInSize()),
-            m_buffOutSize(ZSTD_DStreamOutSize()),
-            m_buffOut(static_cast<u8*>(malloc(ZSTD_DStreamOutSize())), MallocDeleter()),
-            m_dctx(ZSTD_createDCtx(), ZstdDCtxDeleter())
+            m_buffOutSize(std::max<size_t>(outputWindowSize(), ZSTD_DStreamOutSize())),
+            m_buffOutOwned(static_cast<u8*>(malloc(m_buffOutSize)), MallocDeleter()),
+            m_buffOut(m_buffOutOwned.get()),
+            m_dctx(acquireZstdDCtx())
      {
           if (!writeFn)
                THROW_FORMAT("ZstdStreamWriter: WriterFn callback cannot be null");
@@ -345,6 +628,25 @@ public:
                THROW_FORMAT("ZstdStreamWriter: failed to allocate resources");
      }
 
+     // Batches into a caller-owned window instead, which must outlive close()
+     ZstdStreamWriter(const std::function<WriterFn>& writeFn, u8* window, size_t windowSize)
+          : m_writeFn(writeFn),
+            m_buffInSize(ZSTD_DStreamInSize()),
+            m_buffOutSize(windowSize),
+            m_buffOut(window),
+            m_dctx(acquireZstdDCtx())
+     {
+          if (!writeFn)
+               THROW_FORMAT("ZstdStreamWriter: WriterFn callback cannot be null");
+          if (!m_buffOut || !m_buffOutSize || !m_dctx)
+               THROW_FORMAT("ZstdStreamWriter: failed to allocate resources");
+     }
+
+     static size_t outputWindowSize()
+     {
+          return (size_t)std::clamp(inst::config::zstdOutputWindowMb, 1, 8) * 0x100000;
+     }
+
      ~ZstdStreamWriter() override
      {
           ZstdStreamWriter::close();
@@ -354,9 +656,17 @@ public:
      {
           if (isClosed()) return; // Idempotent close
 
+          // Hand over whatever is still batched in the output window
+          if (m_writeFn && m_buffOutPos > 0)
+          {
+               m_writeFn(m_buffOut, m_buffOutPos);
+               m_buffOutPos = 0;
+          }
+
           // Free resources
-          m_dctx.reset();    // Calls ZSTD_freeDCtx()
-          m_buffOut.reset(); // Calls free()
+          m_dctx.reset();         // Returns the context to the pool
+          m_buffOutOwned.reset(); // Calls free(), borrowed windows are left alone
+          m_buffOut = NULL;
           m_writeFn = NULL;
 
           CloseableWriter::close(); // Mark as closed after all cleanups are done
@@ -374,10 +684,12 @@ public:
           {
                const size_t readChunkSz = std::min(sz, m_buffInSize);
                ZSTD_inBuffer input = { ptr, readChunkSz, 0 };
+               bool outputFull = false;
 
-               while (input.pos < input.size)
+               // Keep going while the window filled up, zstd may still hold pending output
+               while (input.pos < input.size || outputFull)
                {
-                    ZSTD_outBuffer output = { m_buffOut.get(), m_buffOutSize, 0 };
+                    ZSTD_outBuffer output = { m_buffOut, m_buffOutSize, m_buffOutPos };
                     size_t const ret = ZSTD_decompressStream(m_dctx.get(), &output, &input);
 
                     if (ZSTD_isError(ret))
@@ -386,10 +698,14 @@ public:
                          THROW_FORMAT("ZstdStreamWriter: decompress error: %s", errorName);
                     }
 
-                    // Write decompressed data to callback writer immediately
-                    if (output.pos > 0)
+                    m_buffOutPos = output.pos;
+                    outputFull = m_buffOutPos == m_buffOutSize;
+
+                    // Write decompressed data to callback writer once the window is full
+                    if (outputFull)
                     {
-                         m_writeFn(m_buffOut.get(), output.pos);
+                         m_writeFn(m_buffOut, m_buffOutPos);
+                         m_buffOutPos = 0;
                     }
                }
 
@@ -402,16 +718,223 @@ private:
      std::function<WriterFn> m_writeFn;
      size_t m_buffInSize;
      size_t m_buffOutSize;
-     std::unique_ptr<u8, MallocDeleter> m_buffOut;
+     size_t m_buffOutPos = 0;
+     std::unique_ptr<u8, MallocDeleter> m_buffOutOwned;
+     u8* m_buffOut;
      std::unique_ptr<ZSTD_DCtx, ZstdDCtxDeleter> m_dctx;
 };
 
+// NCZBLOCK Decompress Pool - decompresses whole NCZBLOCK blocks on worker threads
+// NCZBLOCK blocks are independent zstd frames, so they can be decompressed out of order.
+// Finished blocks are held in a reorder window and handed to writeFn strictly in block order.
+class NczBlockDecompressPool
+{
+public:
+     NczBlockDecompressPool(u32 workerCount, u32 windowSize, const std::function<WriterFn>& writeFn)
+          : m_writeFn(writeFn), m_windowSize(std::max<u32>(windowSize, 1))
+     {
+          if (!writeFn)
+               THROW_FORMAT("NczBlockDecompressPool: WriterFn callback cannot be null");
+
+          for (u32 i = 0; i < workerCount; i++)
+          {
+               m_workers.emplace_back([this]() { workerMain(); });
+          }
+     }
+
+     ~NczBlockDecompressPool()
+     {
+          {
+               std::lock_guard<std::mutex> lock(m_mutex);
+               m_stop = true;
+          }
+          m_jobCond.notify_all();
+
+          for (auto& worker : m_workers)
+          {
+               if (worker.joinable())
+                    worker.join();
+          }
+     }
+
+     // Queues a block for decompression. Blocks while the reorder window is full,
+     // emitting finished blocks in order to make room.
+     void submit(std::vector<u8>&& data, u64 expectedSize, bool compressed)
+     {
+          while (true)
+          {
+               std::unique_lock<std::mutex> lock(m_mutex);
+               if (m_window.size() < m_windowSize)
+                    break;
+               lock.unlock();
+               emitNext(true);
+          }
+
+          auto job = std::make_unique<Job>();
+          job->input = std::move(data);
+          job->expectedSize = expectedSize;
+
+          std::lock_guard<std::mutex> lock(m_mutex);
+          if (!compressed)
+          {
+               // Nothing to decompress, pass through in order
+               job->output = std::move(job->input);
+               job->done = true;
+               m_window.push_back(std::move(job));
+               return;
+          }
+
+          m_pending.push_back(job.get());
+          m_window.push_back(std::move(job));
+          m_jobCond.notify_one();
+     }
+
+     // Emits any blocks that have already finished, without waiting
+     void emitReady()
+     {
+          while (emitNext(false)) {}
+     }
+
+     // Waits for and emits all outstanding blocks
+     void finish()
+     {
+          while (emitNext(true)) {}
+     }
+
+     // Set once a block failed to decompress; the output stream is then incomplete
+     bool failed() const
+     {
+          return m_failed;
+     }
+
+private:
+     struct Job
+     {
+          std::vector<u8> input;
+          std::vector<u8> output;
+          u64 expectedSize = 0;
+          bool done = false;
+          std::string error;
+     };
+
+     // Emits the oldest block if it is done (or once it is, if wait is set)
+     // Returns false if there was nothing to emit
+     bool emitNext(bool wait)
+     {
+          std::unique_ptr<Job> job;
+          {
+               std::unique_lock<std::mutex> lock(m_mutex);
+               if (m_window.empty())
+                    return false;
+
+               if (wait)
+                    m_doneCond.wait(lock, [&]() { return m_window.front()->done; });
+               else if (!m_window.front()->done)
+                    return false;
+
+               job = std::move(m_window.front());
+               m_window.pop_front();
+          }
+
+          if (!job->error.empty())
+          {
+               m_failed = true;
+               THROW_FORMAT("NczBlockDecompressPool: %s", job->error.c_str());
+          }
+
+          if (!job->output.empty())
+               m_writeFn(job->output.data(), job->output.size());
+          return true;
+     }
+
+     void workerMain()
+     {
+          std::unique_ptr<ZSTD_DCtx, ZstdDCtxDeleter> dctx = acquireZstdDCtx();
+
+          while (true)
+          {
+               Job* job = NULL;
+               {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_jobCond.wait(lock, [&]() { return m_stop || !m_pending.empty(); });
+                    if (m_stop)
+                         return;
+
+                    job = m_pending.front();
+                    m_pending.pop_front();
+               }
+
+               if (!dctx)
+                    job->error = "failed to allocate resources";
+               else
+                    decompress(dctx.get(), job);
+
+               job->input.clear();
+               job->input.shrink_to_fit();
+
+               {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    job->done = true;
+               }
+               m_doneCond.notify_all();
+          }
+     }
+
+     static void decompress(ZSTD_DCtx* dctx, Job* job)
+     {
+          ZSTD_DCtx_reset(dctx, ZSTD_reset_session_only);
+
+          job->output.resize(std::max<u64>(job->expectedSize, ZSTD_DStreamOutSize()));
+          ZSTD_inBuffer input = { job->input.data(), job->input.size(), 0 };
+          size_t outPos = 0;
+          bool outputFull = false;
+
+          while (input.pos < input.size || outputFull)
+          {
+               if (outPos == job->output.size())
+                    job->output.resize(job->output.size() + ZSTD_DStreamOutSize());
+
+               ZSTD_outBuffer output = { job->output.data(), job->output.size(), outPos };
+               size_t const ret = ZSTD_decompressStream(dctx, &output, &input);
+
+               if (ZSTD_isError(ret))
+               {
+                    job->error = std::string("decompress error: ") + ZSTD_getErrorName(ret);
+                    break;
+               }
+
+               outputFull = output.pos == output.size;
+               outPos = output.pos;
+          }
+
+          job->output.resize(outPos);
+     }
+
+     std::function<WriterFn> m_writeFn;
+     u32 m_windowSize;
+
+     std::mutex m_mutex;
+     std::condition_variable m_jobCond;  // Workers wait for pending jobs
+     std::condition_variable m_doneCond; // Submitter waits for the oldest job to finish
+     std::deque<std::unique_ptr<Job>> m_window; // All in-flight blocks, in block order
+     std::deque<Job*> m_pending;                // Blocks not yet picked up by a worker
+     bool m_stop = false;
+     bool m_failed = false;
+
+     std::vector<std::thread> m_workers;
+};
+
 // NCZBLOCK Stream Writer - handles streaming NCZBLOCK compression
 class NczBlockStreamWriter : public CloseableWriter
 {
 public:
-     NczBlockStreamWriter(const std::function<WriterFn>& writeFn)
-          : m_writeFn(writeFn),
+     // Blocks larger than this are always decompressed sequentially
+     static constexpr u64 MAX_PARALLEL_BLOCK_SIZE = 0x800000; // 8MB
+     // Upper bound on compressed + decompressed data held by the reorder window
+     static constexpr u64 MAX_PARALLEL_WINDOW_BYTES = 0x2000000; // 32MB
+
+     NczBlockStreamWriter(const std::function<WriterFn>& writeFn, u32 workerCount)
+          : m_writeFn(writeFn), m_workerCount(workerCount),
             m_headerParsed(false), m_blockSizesParsed(false),
             m_currentBlockIdx(0), m_currentBlockReadOffset(0)
      {
@@ -419,6 +942,11 @@ public:
                THROW_FORMAT("NczBlockStreamWriter: WriterFn callback cannot be null");
      }
 
+     NczBlockStreamWriter(const std::function<WriterFn>& writeFn)
+          : NczBlockStreamWriter(writeFn, (u32)std::clamp(inst::config::nczDecompressThreads, 1, 4))
+     {
+     }
+
      ~NczBlockStreamWriter() override
      {
           NczBlockStreamWriter::close();
@@ -434,6 +962,17 @@ public:
                m_currentBlockWriter->close(); // Flush remaining data to writerFn
                m_currentBlockWriter = NULL;
           }
+          if (m_pool)
+          {
+               if (!m_pool->failed())
+               {
+                    // Hand over a truncated final block as-is, like the sequential path does
+                    if (!m_blockBuffer.empty())
+                         submitCurrentBlock();
+                    m_pool->finish(); // Flush remaining blocks to writerFn
+               }
+               m_pool = NULL;
+          }
           m_writeFn = NULL;
 
           CloseableWriter::close(); // Mark as closed after all cleanups are done
@@ -513,9 +1052,22 @@ public:
 
                // All future writes will go directly to output
                m_buffer.clear(); // reclaim ok
+
+               if (m_workerCount > 1 && m_header.usesZstd() && m_header.blockSize() <= MAX_PARALLEL_BLOCK_SIZE)
+               {
+                    const u64 windowSize = std::min<u64>(m_workerCount * 2, std::max<u64>(2, MAX_PARALLEL_WINDOW_BYTES / (m_header.blockSize() * 2)));
+                    LOG_DEBUG("[NczBlockStreamWriter] Using %u decompress workers, window of %lu blocks", m_workerCount, windowSize);
+                    m_pool = std::make_unique<NczBlockDecompressPool>(m_workerCount, (u32)windowSize, m_writeFn);
+               }
           }
 
           // Phase 3: Decompress blocks
+          if (m_pool)
+          {
+               writeBlocksParallel(ptr, sz);
+               return;
+          }
+
           while (sz)
           {
                // Starting a new block?
@@ -530,22 +1082,20 @@ public:
                     m_currentBlockReadOffset = 0;
 
                     const u64 compressedSize = m_blockSizes[m_currentBlockIdx];
-
-                    u64 expectedDecompSize = m_header.blockSize();
-                    // If last block, adjust expected decompressed to remaining
-                    if (m_currentBlockIdx == m_header.numberOfBlocks - 1)
-                    {
-                         const u64 remainder = m_header.decompressedSize % m_header.blockSize();
-                         if (remainder > 0) expectedDecompSize = remainder;
-                         // TODO Log if expected < compressed ?
-                    }
+                    const u64 expectedDecompSize = getExpectedDecompressedSize(m_currentBlockIdx);
 
                     if (m_header.usesZstd())
                     {
                          // Even when zstd flagged, if no compression achieved, assume uncompressed
                          if (compressedSize < expectedDecompSize)
                          {
-                              m_currentBlockWriter = std::make_unique<ZstdStreamWriter>(m_writeFn);
+                              // One output window serves every block, rather than a fresh allocation per block
+                              if (!m_blockOutWindow)
+                              {
+                                   m_blockOutWindowSize = std::max<size_t>(std::min<size_t>(ZstdStreamWriter::outputWindowSize(), m_header.blockSize()), ZSTD_DStreamOutSize());
+                                   m_blockOutWindow.reset(static_cast<u8*>(malloc(m_blockOutWindowSize)));
+                              }
+                              m_currentBlockWriter = std::make_unique<ZstdStreamWriter>(m_writeFn, m_blockOutWindow.get(), m_blockOutWindowSize);
                          }
                          else
                          {
@@ -578,7 +1128,70 @@ public:
      }
 
 private:
+     u64 getExpectedDecompressedSize(u64 blockIdx) const
+     {
+          u64 expectedDecompSize = m_header.blockSize();
+          // If last block, adjust expected decompressed to remaining
+          if (blockIdx == m_header.numberOfBlocks - 1)
+          {
+               const u64 remainder = m_header.decompressedSize % m_header.blockSize();
+               if (remainder > 0) expectedDecompSize = remainder;
+               // TODO Log if expected < compressed ?
+          }
+          return expectedDecompSize;
+     }
+
+     // Buffers whole compressed blocks and hands them to the decompress pool
+     void writeBlocksParallel(const u8* ptr, u64 sz)
+     {
+          while (sz)
+          {
+               // Out of blocks?
+               if (m_currentBlockIdx >= m_header.numberOfBlocks)
+               {
+                    break;
+               }
+
+               const u64 blockSize = m_blockSizes[m_currentBlockIdx];
+               const u64 remaining = std::min(sz, blockSize - m_currentBlockReadOffset);
+
+               if (m_blockBuffer.empty())
+                    m_blockBuffer.reserve(blockSize);
+
+               append(m_blockBuffer, ptr, remaining);
+               m_currentBlockReadOffset += remaining;
+               ptr += remaining;
+               sz -= remaining;
+
+               if (m_currentBlockReadOffset >= blockSize)
+               {
+                    submitCurrentBlock();
+               }
+          }
+
+          m_pool->emitReady();
+     }
+
+     void submitCurrentBlock()
+     {
+          const u64 compressedSize = m_blockSizes[m_currentBlockIdx];
+          const u64 expectedDecompSize = getExpectedDecompressedSize(m_currentBlockIdx);
+
+          // Even when zstd flagged, if no compression achieved, assume uncompressed
+          const bool compressed = compressedSize < expectedDecompSize;
+          if (!compressed)
+          {
+               LOG_DEBUG("[NczBlockStreamWriter] Block (%lu) appears to have no compression - Passing through", m_currentBlockIdx);
+          }
+
+          m_pool->submit(std::move(m_blockBuffer), expectedDecompSize, compressed);
+          m_blockBuffer = std::vector<u8>();
+          m_currentBlockReadOffset = 0;
+          m_currentBlockIdx++;
+     }
+
      std::function<WriterFn> m_writeFn;
+     u32 m_workerCount;
 
      NczBlockHeader m_header;
      bool m_headerParsed;
@@ -587,7 +1200,12 @@ private:
 
      u64 m_currentBlockIdx;
      u64 m_currentBlockReadOffset;
-     std::unique_ptr<CloseableWriter> m_currentBlockWriter;
+     std::unique_ptr<u8, MallocDeleter> m_blockOutWindow; // Shared by the sequential zstd block writers
+     size_t m_blockOutWindowSize = 0;
+     std::unique_ptr<CloseableWriter> m_currentBlockWriter; // Declared after the window it may borrow
+
+     std::unique_ptr<NczBlockDecompressPool> m_pool; // Only set when decompressing in parallel
+     std::vector<u8> m_blockBuffer; // Compressed data of the current block, parallel path only
 
      std::vector<u8> m_buffer; // For header + block-sizes parsing phases
 };
@@ -603,7 +1221,14 @@ public:
 
      ~NczBodyWriter() override
      {
-          NcaBodyWriter::close();
+          try
+          {
+               NcaBodyWriter::close();
+          }
+          catch (std::exception& e)
+          {
+               LOG_DEBUG("NczBodyWriter close failed during destruction: %s\n", e.what());
+          }
      }
 
 protected:
@@ -613,6 +1238,7 @@ protected:
           // Free resources
           currentSectionCipher.reset(); // unique_ptr handles delete
           sections.clear(); // reclaim ok
+          m_sectionRanges.clear();
           m_writer = NULL;
      }
 
@@ -626,91 +1252,116 @@ protected:
 
 private:
 
-     // Find the section index for the specified offset
-     // Returns -1 if none found
-     int getSectionIndexForOffset(u64 offset)
+     // Section extents sorted by offset. Neighbouring sections that share the same
+     // key and counter are merged, since their CTR keystream is continuous.
+     struct SectionRange
+     {
+          u64 start;
+          u64 end;
+          u64 section;
+     };
+
+     // Adjacency is checked against the merged range, not the first section it started from,
+     // so runs of more than two sections collapse into one range.
+     static bool canMergeSections(const NczSectionHeader& a, const NczSectionHeader& b)
      {
-          for (int i = 0; i < sections.size(); i++)
+          return a.cryptoType == b.cryptoType &&
+               memcmp(a.cryptoKey, b.cryptoKey, sizeof(a.cryptoKey)) == 0 &&
+               memcmp(a.cryptoCounter, b.cryptoCounter, sizeof(a.cryptoCounter)) == 0;
+     }
+
+     void buildSectionIndex()
+     {
+          std::vector<u64> order;
+          order.reserve(sections.size());
+          for (u64 i = 0; i < sections.size(); i++)
+          {
+               if (sections[i].size) order.push_back(i);
+          }
+          std::stable_sort(order.begin(), order.end(), [this](u64 a, u64 b) {
+               return sections[a].offset < sections[b].offset;
+          });
+
+          m_sectionRanges.clear();
+          m_sectionRanges.reserve(order.size());
+          for (const u64 idx : order)
           {
-               if (offset >= sections[i].offset && offset < sections[i].offset + sections[i].size)
+               const NczSectionHeader& section = sections[idx];
+               u64 start = section.offset;
+               const u64 end = section.offset + section.size;
+
+               if (!m_sectionRanges.empty())
                {
-                    return i;
+                    SectionRange& last = m_sectionRanges.back();
+                    if (end <= last.end) continue; // Fully covered by an earlier section
+                    if (canMergeSections(sections[last.section], section) && last.end == start)
+                    {
+                         last.end = end;
+                         continue;
+                    }
+                    start = std::max(start, last.end); // Earlier section wins on overlap
                }
+               m_sectionRanges.push_back({start, end, idx});
           }
-          return -1;
+          m_sectionCursor = 0;
      }
 
-     // Find the next closest section index for the specified offset
-     // Returns -1 if none found
-     int getNextSectionIndexForOffset(u64 offset)
+     // Returns the first range that ends after offset. Content is flushed in
+     // order, so this normally only walks the cursor forward.
+     u64 seekSectionRange(u64 offset)
      {
-          int nextSectionIdx = -1;
-          u64 nextSectionOffset = std::numeric_limits<u64>::max();
-          for (int i = 0; i < sections.size(); i++)
+          if (m_sectionCursor > 0 && offset < m_sectionRanges[m_sectionCursor - 1].end)
           {
-               if (sections[i].offset > offset && sections[i].offset < nextSectionOffset)
-               {
-                    nextSectionIdx = i;
-                    nextSectionOffset = sections[i].offset;
-               }
+               m_sectionCursor = std::upper_bound(m_sectionRanges.begin(), m_sectionRanges.end(), offset,
+                    [](u64 value, const SectionRange& range) { return value < range.end; }) - m_sectionRanges.begin();
           }
-          return nextSectionIdx;
+          while (m_sectionCursor < m_sectionRanges.size() && m_sectionRanges[m_sectionCursor].end <= offset)
+          {
+               m_sectionCursor++;
+          }
+          return m_sectionCursor;
      }
 
      bool encrypt(u8* ptr, u64 sz, u64 offset)
      {
           while (sz)
           {
-               int offsetSectionIdx = getSectionIndexForOffset(offset);
-               u64 chunk = sz;
+               const u64 rangeIdx = seekSectionRange(offset);
+               if (rangeIdx >= m_sectionRanges.size())
+               {
+                    break; // Past the last section - remaining bytes are not encrypted
+               }
+
+               const SectionRange& range = m_sectionRanges[rangeIdx];
+               u64 chunk;
 
-               if (offsetSectionIdx >= 0)
+               if (offset < range.start)
+               {
+                    // Not within a defined section (i.e. padding), leave it as-is up to the next one
+                    chunk = std::min<u64>(sz, range.start - offset);
+               }
+               else
                {
-                    NczSectionHeader* offsetSection = &sections[offsetSectionIdx];
+                    const NczSectionHeader& section = sections[range.section];
 
                     // Create new context if section changed
-                    if (offsetSectionIdx != currentSectionIdx) // -1 => true
+                    if (range.section != currentSectionIdx)
                     {
                          currentSectionCipher.reset(); // Delete early as we may not re-assign
-                         if (offsetSection->cryptoType == 3)
+                         if (section.cryptoType == 3)
                          {
-                              currentSectionCipher = std::make_unique<Aes128CtrCipher>(offsetSection->cryptoKey, offsetSection->cryptoCounter);
+                              currentSectionCipher = std::make_unique<Aes128CtrCipher>(section.cryptoKey, section.cryptoCounter);
                          }
-                         currentSectionIdx = offsetSectionIdx;
+                         currentSectionIdx = range.section;
                     }
 
-                    const u64 sectionEnd = offsetSection->offset + offsetSection->size;
-
-                    // assert offset < sectionEnd
-
-                    chunk = std::min<u64>(sz, sectionEnd - offset);
-
-                    // assert chunk > 0
+                    chunk = std::min<u64>(sz, range.end - offset);
 
                     if (currentSectionCipher)
                     {
                          currentSectionCipher->encrypt(ptr, chunk, offset);
                     }
                }
-               else
-               {
-                    // When an offset doesn't fall within a defined section,
-                    // (i.e. Its not encrypted - Possibly padding),
-                    // We look for the next closest section to determine
-                    // how many unencrypted bytes to account for
-                    int nextSectionIdx = getNextSectionIndexForOffset(offset);
-                    if (nextSectionIdx >= 0)
-                    {
-                         NczSectionHeader* nextSection = &sections[nextSectionIdx];
-                         u64 nextSectionStart = nextSection->offset;
-
-                         // assert offset < nextSectionStart
-
-                         chunk = std::min<u64>(sz, nextSectionStart - offset);
-                    }
-               }
-
-               // assert chunk > 0
 
                offset += chunk;
                ptr += chunk;
@@ -808,6 +1459,7 @@ public:
                {
                     sections.push_back(header->section(i));
                }
+               buildSectionIndex();
 
                m_sectionsInitialized = true;
                m_buffer.resize(0);
@@ -875,19 +1527,40 @@ private:
      bool m_sectionsInitialized = false;
 
      std::vector<NczSectionHeader> sections;
+     std::vector<SectionRange> m_sectionRanges; // Sorted lookup index over sections
+     u64 m_sectionCursor = 0;
      std::unique_ptr<Aes128CtrCipher> currentSectionCipher; // Crypto cipher for current section
      u64 currentSectionIdx = (u64)-1; // Track which section the cipher is for
 };
 
 // region NcaWriter Methods
 
+void NcaWriter::ReleaseDecompressionContexts()
+{
+     std::lock_guard<std::mutex> lock(g_dctxPoolMutex);
+     for (ZSTD_DCtx* ctx : g_dctxPool)
+     {
+          ZSTD_freeDCtx(ctx);
+     }
+     g_dctxPool.clear();
+     g_dctxPool.shrink_to_fit();
+}
+
 NcaWriter::NcaWriter(const NcmContentId& ncaId, std::shared_ptr<nx::ncm::ContentStorage>& contentStorage) : m_ncaId(ncaId), m_contentStorage(contentStorage), m_writer(NULL)
 {
 }
 
 NcaWriter::~NcaWriter()
 {
-     NcaWriter::close();
+     // Like the body writers, never let a failed close escape the destructor
+     try
+     {
+          NcaWriter::close();
+     }
+     catch (std::exception& e)
+     {
+          LOG_DEBUG("NcaWriter close failed during destruction: %s\n", e.what());
+     }
 }
 
 void NcaWriter::close()
@@ -1019,8 +1692,8 @@ void NcaWriter::flushHeader()
      }
 
      memcpy(&header, m_buffer.data(), sizeof(header));
-     Crypto::AesXtr decryptor(Crypto::Keys().headerKey, false);
-     Crypto::AesXtr encryptor(Crypto::Keys().headerKey, true);
+     Crypto::AesXtr decryptor = Crypto::GetHeaderDecryptor();
+     Crypto::AesXtr encryptor = Crypto::GetHeaderEncryptor();
      decryptor.decrypt(&header, &header, sizeof(header), 0, 0x200);
 
      if (header.magic == MAGIC_NCA3)
@@ -1043,7 +1716,18 @@ void NcaWriter::flushHeader()
 
      if (m_contentStorage)
      {
-          m_contentStorage->WritePlaceholder(*(NcmPlaceHolderId*)&m_ncaId, 0, m_buffer.data(), m_buffer.size());
+          try
+          {
+               m_contentStorage->WritePlaceholder(*(NcmPlaceHolderId*)&m_ncaId, 0, m_buffer.data(), m_buffer.size());
+          }
+          catch (...)
+          {
+               // Drop the header, a later close() flushing it again would recreate the placeholder
+               // after the caller has already deleted it
+               m_buffer.clear();
+               m_contentStorage = NULL;
+               throw;
+          }
      }
 }
 
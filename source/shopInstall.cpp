@@ -1,11 +1,16 @@
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <curl/curl.h>
 #include <filesystem>
+#include <fstream>
 #include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
@@ -14,6 +19,7 @@
 #include <zstd.h>
 #include <mbedtls/aes.h>
 #include "shopInstall.hpp"
+#include "data/prefetch_reader.hpp"
 #include "install/http_nsp.hpp"
 #include "install/http_xci.hpp"
 #include "install/install.hpp"
@@ -515,10 +521,11 @@ namespace {
         return ext == ".xci" || ext == ".xcz";
     }
 
-    bool IsXciMagic(const std::string& url)
+    bool IsXciMagic(const std::string& url, const std::atomic<bool>* abortFlag = nullptr)
     {
         try {
             tin::network::HTTPDownload download(url);
+            download.SetAbortFlag(abortFlag);
             u32 magic = 0;
             download.BufferDataRange(&magic, 0xF000, sizeof(magic), nullptr);
             if (magic == 0x30534648)
@@ -1130,16 +1137,340 @@ namespace {
 
     }
 
-    std::vector<shopInstStuff::ShopSection> ParseShopSectionsBody(const std::string& body, const std::string& baseUrl, std::string& error)
+    bool ParseShopItemEntry(const nlohmann::json& entry, const std::string& sectionId, const std::string& baseUrl, shopInstStuff::ShopItem& item)
+    {
+        if (!entry.contains("url"))
+            return false;
+        std::string url = entry["url"].get<std::string>();
+        std::uint64_t size = 0;
+        if (entry.contains("size") && entry["size"].is_number()) {
+            size = entry["size"].get<std::uint64_t>();
+        }
+
+        std::string fragment;
+        std::string urlPath = url;
+        auto hashPos = urlPath.find('#');
+        if (hashPos != std::string::npos) {
+            fragment = urlPath.substr(hashPos + 1);
+            urlPath = urlPath.substr(0, hashPos);
+        }
+
+        std::string fullUrl = BuildFullUrl(baseUrl, urlPath);
+
+        std::string name;
+        const bool hasExplicitName = entry.contains("name");
+        if (hasExplicitName) {
+            name = entry["name"].get<std::string>();
+        } else if (!fragment.empty()) {
+            name = DecodeUrlSegment(fragment);
+        } else {
+            name = inst::util::formatUrlString(fullUrl);
+        }
+
+        if (fullUrl.empty() || name.empty())
+            return false;
+
+        item.name = std::move(name);
+        item.url = std::move(fullUrl);
+        item.size = size;
+        std::uint64_t titleId = 0;
+        std::uint32_t appVersion = 0;
+        std::int32_t appType = -1;
+        if (TryParseTitleId(entry, titleId)) {
+            item.titleId = titleId;
+            item.hasTitleId = true;
+        }
+        if (TryParseAppVersion(entry, appVersion)) {
+            item.appVersion = appVersion;
+            item.hasAppVersion = true;
+        }
+        std::uint32_t releaseDate = 0;
+        if (TryParseReleaseDate(entry, releaseDate)) {
+            item.releaseDate = releaseDate;
+            item.hasReleaseDate = true;
+        }
+        if (TryParseAppType(entry, appType))
+            item.appType = appType;
+        if (entry.contains("app_id") && entry["app_id"].is_string()) {
+            item.appId = entry["app_id"].get<std::string>();
+            item.hasAppId = !item.appId.empty();
+            if (!item.hasTitleId) {
+                std::uint64_t parsedAppId = 0;
+                if (TryParseTitleIdFromAppId(item.appId, parsedAppId)) {
+                    item.titleId = parsedAppId;
+                    item.hasTitleId = true;
+                }
+            }
+        }
+        if (item.appType < 0) {
+            if (item.hasAppId)
+                InferAppTypeFromAppId(item.appId, item.appType);
+            if (item.appType < 0 && item.hasTitleId)
+                InferAppTypeFromTitleId(item.titleId, item.appType);
+            if (item.appType < 0)
+                InferAppTypeFromSectionId(sectionId, item.appType);
+        }
+        if (entry.contains("icon_url") && entry["icon_url"].is_string()) {
+            std::string iconUrl = entry["icon_url"].get<std::string>();
+            if (!iconUrl.empty()) {
+                item.iconUrl = BuildFullUrl(baseUrl, iconUrl);
+                item.hasIconUrl = true;
+            }
+        } else if (entry.contains("iconUrl") && entry["iconUrl"].is_string()) {
+            std::string iconUrl = entry["iconUrl"].get<std::string>();
+            if (!iconUrl.empty()) {
+                item.iconUrl = BuildFullUrl(baseUrl, iconUrl);
+                item.hasIconUrl = true;
+            }
+        }
+        if (entry.contains("save_id") && entry["save_id"].is_string())
+            item.saveId = entry["save_id"].get<std::string>();
+        else if (entry.contains("saveId") && entry["saveId"].is_string())
+            item.saveId = entry["saveId"].get<std::string>();
+        if (entry.contains("note") && entry["note"].is_string())
+            item.saveNote = entry["note"].get<std::string>();
+        else if (entry.contains("save_note") && entry["save_note"].is_string())
+            item.saveNote = entry["save_note"].get<std::string>();
+        else if (entry.contains("saveNote") && entry["saveNote"].is_string())
+            item.saveNote = entry["saveNote"].get<std::string>();
+        if (entry.contains("created_at") && entry["created_at"].is_string())
+            item.saveCreatedAt = entry["created_at"].get<std::string>();
+        else if (entry.contains("createdAt") && entry["createdAt"].is_string())
+            item.saveCreatedAt = entry["createdAt"].get<std::string>();
+        if (entry.contains("created_ts")) {
+            if (entry["created_ts"].is_number_unsigned())
+                item.saveCreatedTs = entry["created_ts"].get<std::uint64_t>();
+            else if (entry["created_ts"].is_number_integer()) {
+                const auto parsedCreatedTs = entry["created_ts"].get<long long>();
+                if (parsedCreatedTs > 0)
+                    item.saveCreatedTs = static_cast<std::uint64_t>(parsedCreatedTs);
+            }
+        } else if (entry.contains("createdTs")) {
+            if (entry["createdTs"].is_number_unsigned())
+                item.saveCreatedTs = entry["createdTs"].get<std::uint64_t>();
+            else if (entry["createdTs"].is_number_integer()) {
+                const auto parsedCreatedTs = entry["createdTs"].get<long long>();
+                if (parsedCreatedTs > 0)
+                    item.saveCreatedTs = static_cast<std::uint64_t>(parsedCreatedTs);
+            }
+        }
+        ApplyOfflineDataToItem(item, hasExplicitName);
+
+        return true;
+    }
+
+    void ParseShopSectionJson(const nlohmann::json& section, const std::string& baseUrl, std::vector<shopInstStuff::ShopSection>& sections)
+    {
+        if (!section.contains("items") || !section["items"].is_array())
+            return;
+        shopInstStuff::ShopSection parsed;
+        parsed.id = section.value("id", "all");
+        parsed.title = section.value("title", "All");
+        for (const auto& entry : section["items"]) {
+            shopInstStuff::ShopItem item;
+            if (ParseShopItemEntry(entry, parsed.id, baseUrl, item))
+                parsed.items.push_back(std::move(item));
+        }
+
+        if (!parsed.items.empty())
+            sections.push_back(std::move(parsed));
+    }
+
+    // Streams /api/shop/sections without building a DOM for the whole response. Only one item entry
+    // is materialized at a time, and items are converted as soon as they close. Items seen before
+    // their section's "id" are held back, since the id feeds app type inference.
+    class ShopSectionsSaxHandler final : public nlohmann::json_sax<nlohmann::json> {
+    public:
+        explicit ShopSectionsSaxHandler(const std::string& baseUrl) : m_baseUrl(baseUrl) {}
+
+        std::vector<shopInstStuff::ShopSection> sections;
+        bool sawSections = false;
+        bool hasError = false;
+        std::string errorText;
+
+        bool null() override { return this->Value(nlohmann::json()); }
+        bool boolean(bool val) override { return this->Value(nlohmann::json(val)); }
+        bool number_integer(number_integer_t val) override { return this->Value(nlohmann::json(val)); }
+        bool number_unsigned(number_unsigned_t val) override { return this->Value(nlohmann::json(val)); }
+        bool number_float(number_float_t val, const string_t&) override { return this->Value(nlohmann::json(val)); }
+        bool binary(binary_t& val) override { return this->Value(nlohmann::json(std::move(val))); }
+
+        bool string(string_t& val) override {
+            if (m_capture.empty()) {
+                if (m_depth == 1 && m_rootKey == "error") {
+                    hasError = true;
+                    errorText = val;
+                } else if (m_depth == 3 && m_inSection && (m_sectionKey == "id" || m_sectionKey == "title")) {
+                    (m_sectionKey == "id" ? m_section.id : m_section.title) = val;
+                    if (m_sectionKey == "id") m_sectionIdSeen = true;
+                    return true;
+                }
+            }
+            return this->Value(nlohmann::json(std::move(val)));
+        }
+
+        bool key(string_t& val) override {
+            if (!m_capture.empty()) {
+                m_captureKey = std::move(val);
+                return true;
+            }
+            if (m_depth == 1) m_rootKey = val;
+            else if (m_depth == 3 && m_inSection) m_sectionKey = val;
+            return true;
+        }
+
+        bool start_object(std::size_t) override {
+            if (!m_capture.empty() || (m_depth == 4 && m_inItems))
+                return this->StartCapture(nlohmann::json::object());
+            if (m_depth == 3 && m_inSection && (m_sectionKey == "id" || m_sectionKey == "title")) {
+                m_sectionBadField = true;
+            } else if (m_depth == 2 && m_inSections) {
+                m_inSection = true;
+                m_section = shopInstStuff::ShopSection();
+                m_section.id = "all";
+                m_section.title = "All";
+                m_sectionIdSeen = false;
+                m_sectionHasItems = false;
+                m_sectionBadField = false;
+                m_sectionKey.clear();
+                m_deferred.clear();
+            }
+            m_depth++;
+            return true;
+        }
+
+        bool end_object() override {
+            if (!m_capture.empty())
+                return this->EndCapture();
+            m_depth--;
+            if (m_depth == 2 && m_inSection) {
+                m_inSection = false;
+                // A non-string id or title fails the whole response, as it did with the DOM parser
+                if (m_sectionHasItems && m_sectionBadField)
+                    throw std::runtime_error("Shop section id or title is not a string");
+                for (const auto& entry : m_deferred)
+                    this->AddItem(entry);
+                m_deferred.clear();
+                if (m_sectionHasItems && !m_section.items.empty())
+                    sections.push_back(std::move(m_section));
+            }
+            return true;
+        }
+
+        bool start_array(std::size_t) override {
+            if (!m_capture.empty())
+                return this->StartCapture(nlohmann::json::array());
+            if (m_depth == 3 && m_inSection && (m_sectionKey == "id" || m_sectionKey == "title")) {
+                m_sectionBadField = true;
+            } else if (m_depth == 1 && m_rootKey == "sections") {
+                m_inSections = true;
+                sawSections = true;
+            } else if (m_depth == 3 && m_inSection && m_sectionKey == "items") {
+                m_inItems = true;
+                m_sectionHasItems = true;
+            }
+            m_depth++;
+            return true;
+        }
+
+        bool end_array() override {
+            if (!m_capture.empty())
+                return this->EndCapture();
+            m_depth--;
+            if (m_depth == 3 && m_inItems) m_inItems = false;
+            else if (m_depth == 1 && m_inSections) m_inSections = false;
+            return true;
+        }
+
+        bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override {
+            return false;
+        }
+
+    private:
+        const std::string& m_baseUrl;
+        std::size_t m_depth = 0;
+        std::string m_rootKey;
+        std::string m_sectionKey;
+        bool m_inSections = false;
+        bool m_inSection = false;
+        bool m_inItems = false;
+        bool m_sectionIdSeen = false;
+        bool m_sectionHasItems = false;
+        bool m_sectionBadField = false;
+        shopInstStuff::ShopSection m_section;
+        std::vector<nlohmann::json> m_deferred;
+
+        // The item entry currently being built, and the open containers inside it
+        nlohmann::json m_item;
+        std::vector<nlohmann::json*> m_capture;
+        std::string m_captureKey;
+
+        nlohmann::json* Insert(nlohmann::json&& value) {
+            nlohmann::json* parent = m_capture.back();
+            if (parent->is_object())
+                return &((*parent)[m_captureKey] = std::move(value));
+            parent->push_back(std::move(value));
+            return &parent->back();
+        }
+
+        bool Value(nlohmann::json&& value) {
+            if (!m_capture.empty())
+                this->Insert(std::move(value));
+            else if (m_depth == 3 && m_inSection && (m_sectionKey == "id" || m_sectionKey == "title"))
+                m_sectionBadField = true;
+            return true;
+        }
+
+        bool StartCapture(nlohmann::json&& container) {
+            if (m_capture.empty()) {
+                m_item = std::move(container);
+                m_capture.push_back(&m_item);
+            } else {
+                m_capture.push_back(this->Insert(std::move(container)));
+            }
+            return true;
+        }
+
+        bool EndCapture() {
+            m_capture.pop_back();
+            if (!m_capture.empty())
+                return true;
+            if (m_sectionIdSeen)
+                this->AddItem(m_item);
+            else
+                m_deferred.push_back(std::move(m_item));
+            m_item = nlohmann::json();
+            return true;
+        }
+
+        void AddItem(const nlohmann::json& entry) {
+            shopInstStuff::ShopItem item;
+            if (ParseShopItemEntry(entry, m_section.id, m_baseUrl, item))
+                m_section.items.push_back(std::move(item));
+        }
+    };
+
+    std::vector<shopInstStuff::ShopSection> ParseShopSectionsJson(const nlohmann::json& sectionsArray, const std::string& baseUrl)
     {
         std::vector<shopInstStuff::ShopSection> sections;
+        for (const auto& section : sectionsArray)
+            ParseShopSectionJson(section, baseUrl, sections);
+        return sections;
+    }
+
+    std::vector<shopInstStuff::ShopSection> ParseShopSectionsBody(const std::string& body, const std::string& baseUrl, std::string& error)
+    {
         try {
-            nlohmann::json shop = nlohmann::json::parse(body);
-            if (shop.contains("error") && shop["error"].is_string()) {
-                error = "Shop login failed. " + shop["error"].get<std::string>();
-                return sections;
+            ShopSectionsSaxHandler handler(baseUrl);
+            if (!nlohmann::json::sax_parse(body, &handler)) {
+                error = "Invalid shop response.";
+                return {};
+            }
+            if (handler.hasError) {
+                error = "Shop login failed. " + handler.errorText;
+                return {};
             }
-            if (!shop.contains("sections") || !shop["sections"].is_array()) {
+            if (!handler.sawSections) {
                 std::string lower = body;
                 std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
                 if (lower.find("unauthorized") != std::string::npos || lower.find("login") != std::string::npos) {
@@ -1147,145 +1478,14 @@ namespace {
                 } else {
                     error = "Shop response missing sections.";
                 }
-                return sections;
-            }
-
-            for (const auto& section : shop["sections"]) {
-                if (!section.contains("items") || !section["items"].is_array())
-                    continue;
-                shopInstStuff::ShopSection parsed;
-                parsed.id = section.value("id", "all");
-                parsed.title = section.value("title", "All");
-                for (const auto& entry : section["items"]) {
-                    if (!entry.contains("url"))
-                        continue;
-                    std::string url = entry["url"].get<std::string>();
-                    std::uint64_t size = 0;
-                    if (entry.contains("size") && entry["size"].is_number()) {
-                        size = entry["size"].get<std::uint64_t>();
-                    }
-
-                    std::string fragment;
-                    std::string urlPath = url;
-                    auto hashPos = urlPath.find('#');
-                    if (hashPos != std::string::npos) {
-                        fragment = urlPath.substr(hashPos + 1);
-                        urlPath = urlPath.substr(0, hashPos);
-                    }
-
-                    std::string fullUrl = BuildFullUrl(baseUrl, urlPath);
-
-                    std::string name;
-                    const bool hasExplicitName = entry.contains("name");
-                    if (hasExplicitName) {
-                        name = entry["name"].get<std::string>();
-                    } else if (!fragment.empty()) {
-                        name = DecodeUrlSegment(fragment);
-                    } else {
-                        name = inst::util::formatUrlString(fullUrl);
-                    }
-
-                    if (!fullUrl.empty() && !name.empty()) {
-                        shopInstStuff::ShopItem item;
-                        item.name = name;
-                        item.url = fullUrl;
-                        item.size = size;
-                        std::uint64_t titleId = 0;
-                        std::uint32_t appVersion = 0;
-                        std::int32_t appType = -1;
-                        if (TryParseTitleId(entry, titleId)) {
-                            item.titleId = titleId;
-                            item.hasTitleId = true;
-                        }
-                        if (TryParseAppVersion(entry, appVersion)) {
-                            item.appVersion = appVersion;
-                            item.hasAppVersion = true;
-                        }
-                        std::uint32_t releaseDate = 0;
-                        if (TryParseReleaseDate(entry, releaseDate)) {
-                            item.releaseDate = releaseDate;
-                            item.hasReleaseDate = true;
-                        }
-                        if (TryParseAppType(entry, appType))
-                            item.appType = appType;
-                        if (entry.contains("app_id") && entry["app_id"].is_string()) {
-                            item.appId = entry["app_id"].get<std::string>();
-                            item.hasAppId = !item.appId.empty();
-                            if (!item.hasTitleId) {
-                                std::uint64_t parsedAppId = 0;
-                                if (TryParseTitleIdFromAppId(item.appId, parsedAppId)) {
-                                    item.titleId = parsedAppId;
-                                    item.hasTitleId = true;
-                                }
-                            }
-                        }
-                        if (item.appType < 0) {
-                            if (item.hasAppId)
-                                InferAppTypeFromAppId(item.appId, item.appType);
-                            if (item.appType < 0 && item.hasTitleId)
-                                InferAppTypeFromTitleId(item.titleId, item.appType);
-                            if (item.appType < 0)
-                                InferAppTypeFromSectionId(parsed.id, item.appType);
-                        }
-                        if (entry.contains("icon_url") && entry["icon_url"].is_string()) {
-                            std::string iconUrl = entry["icon_url"].get<std::string>();
-                            if (!iconUrl.empty()) {
-                                item.iconUrl = BuildFullUrl(baseUrl, iconUrl);
-                                item.hasIconUrl = true;
-                            }
-                        } else if (entry.contains("iconUrl") && entry["iconUrl"].is_string()) {
-                            std::string iconUrl = entry["iconUrl"].get<std::string>();
-                            if (!iconUrl.empty()) {
-                                item.iconUrl = BuildFullUrl(baseUrl, iconUrl);
-                                item.hasIconUrl = true;
-                            }
-                        }
-                        if (entry.contains("save_id") && entry["save_id"].is_string())
-                            item.saveId = entry["save_id"].get<std::string>();
-                        else if (entry.contains("saveId") && entry["saveId"].is_string())
-                            item.saveId = entry["saveId"].get<std::string>();
-                        if (entry.contains("note") && entry["note"].is_string())
-                            item.saveNote = entry["note"].get<std::string>();
-                        else if (entry.contains("save_note") && entry["save_note"].is_string())
-                            item.saveNote = entry["save_note"].get<std::string>();
-                        else if (entry.contains("saveNote") && entry["saveNote"].is_string())
-                            item.saveNote = entry["saveNote"].get<std::string>();
-                        if (entry.contains("created_at") && entry["created_at"].is_string())
-                            item.saveCreatedAt = entry["created_at"].get<std::string>();
-                        else if (entry.contains("createdAt") && entry["createdAt"].is_string())
-                            item.saveCreatedAt = entry["createdAt"].get<std::string>();
-                        if (entry.contains("created_ts")) {
-                            if (entry["created_ts"].is_number_unsigned())
-                                item.saveCreatedTs = entry["created_ts"].get<std::uint64_t>();
-                            else if (entry["created_ts"].is_number_integer()) {
-                                const auto parsedCreatedTs = entry["created_ts"].get<long long>();
-                                if (parsedCreatedTs > 0)
-                                    item.saveCreatedTs = static_cast<std::uint64_t>(parsedCreatedTs);
-                            }
-                        } else if (entry.contains("createdTs")) {
-                            if (entry["createdTs"].is_number_unsigned())
-                                item.saveCreatedTs = entry["createdTs"].get<std::uint64_t>();
-                            else if (entry["createdTs"].is_number_integer()) {
-                                const auto parsedCreatedTs = entry["createdTs"].get<long long>();
-                                if (parsedCreatedTs > 0)
-                                    item.saveCreatedTs = static_cast<std::uint64_t>(parsedCreatedTs);
-                            }
-                        }
-                        ApplyOfflineDataToItem(item, hasExplicitName);
-                        parsed.items.push_back(item);
-                    }
-                }
-
-                if (!parsed.items.empty())
-                    sections.push_back(parsed);
+                return {};
             }
+            return std::move(handler.sections);
         }
         catch (...) {
             error = "Invalid shop response.";
             return {};
         }
-
-        return sections;
     }
 }
 
@@ -1323,6 +1523,8 @@ namespace shopInstStuff {
         std::string contentType;
         std::string error;
         std::string decodeError;
+        std::string etag;
+        std::string lastModified;
         CURLcode curlCode = CURLE_OK;
     };
 
@@ -1366,6 +1568,35 @@ namespace shopInstStuff {
             return IsRetriableHttpCode(result.responseCode);
         }
 
+        // Keeps the cache validators of the final response. Redirect hops each start with a new status line.
+        size_t CaptureValidatorHeader(char* buffer, size_t size, size_t numItems, void* userdata)
+        {
+            auto* result = static_cast<FetchResult*>(userdata);
+            const size_t length = size * numItems;
+            std::string line(buffer, length);
+            while (!line.empty() && (line.back() == '\r' || line.back() == '\n'))
+                line.pop_back();
+
+            if (line.rfind("HTTP/", 0) == 0) {
+                result->etag.clear();
+                result->lastModified.clear();
+                return length;
+            }
+
+            const auto colon = line.find(':');
+            if (colon == std::string::npos)
+                return length;
+            std::string name = line.substr(0, colon);
+            std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+            const auto valueStart = line.find_first_not_of(" \t", colon + 1);
+            const std::string value = valueStart == std::string::npos ? std::string() : line.substr(valueStart);
+            if (name == "etag")
+                result->etag = value;
+            else if (name == "last-modified")
+                result->lastModified = value;
+            return length;
+        }
+
         std::uint32_t ShopRetryDelayMs(int attemptIndex)
         {
             // attemptIndex is 0-based for retries after the first try.
@@ -1378,7 +1609,7 @@ namespace shopInstStuff {
         }
     }
 
-    FetchResult FetchShopResponse(const std::string& url, const std::string& user, const std::string& pass, const ShopFetchProgressCallback& progressCb = ShopFetchProgressCallback())
+    FetchResult FetchShopResponse(const std::string& url, const std::string& user, const std::string& pass, const ShopFetchProgressCallback& progressCb = ShopFetchProgressCallback(), const std::vector<std::string>& extraHeaders = std::vector<std::string>())
     {
         FetchResult lastResult;
 
@@ -1397,6 +1628,8 @@ namespace shopInstStuff {
             curl_easy_setopt(curl, CURLOPT_USERAGENT, userAgent.c_str());
             curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteToString);
             curl_easy_setopt(curl, CURLOPT_WRITEDATA, &result.body);
+            curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, CaptureValidatorHeader);
+            curl_easy_setopt(curl, CURLOPT_HEADERDATA, &result);
             curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, kShopRequestTimeoutMs);
             curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, kShopConnectTimeoutMs);
             curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1L);
@@ -1413,6 +1646,8 @@ namespace shopInstStuff {
             const auto headers = BuildLegacyHeaders(url, user, pass);
             for (const auto& header : headers)
                 headerList = curl_slist_append(headerList, header.c_str());
+            for (const auto& header : extraHeaders)
+                headerList = curl_slist_append(headerList, header.c_str());
             if (headerList)
                 curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headerList);
 
@@ -1711,8 +1946,13 @@ namespace shopInstStuff {
             bool handled = false;
 
             if (shop.contains("sections") && shop["sections"].is_array()) {
-                std::string parseError;
-                std::vector<ShopSection> parsedSections = ParseShopSectionsBody(shop.dump(), baseUrl, parseError);
+                // A malformed sections list falls through to files/paths/directories
+                std::vector<ShopSection> parsedSections;
+                try {
+                    parsedSections = ParseShopSectionsJson(shop["sections"], baseUrl);
+                } catch (...) {
+                    parsedSections.clear();
+                }
                 if (!parsedSections.empty()) {
                     for (const auto& section : parsedSections) {
                         for (const auto& sectionItem : section.items) {
@@ -1773,6 +2013,183 @@ namespace shopInstStuff {
         }
     }
 
+    namespace {
+        // The decoded /api/shop/sections payload is kept on the SD card together with its ETag and
+        // Last-Modified validators, so a later fetch can be answered with 304 Not Modified.
+        struct ShopCatalogCacheMeta {
+            std::string etag;
+            std::string lastModified;
+            std::uint64_t size = 0;
+        };
+
+        std::mutex g_shopCatalogMutex;
+        std::string g_shopCatalogKey;
+        std::string g_shopCatalogEtag;
+        std::string g_shopCatalogLastModified;
+        std::vector<ShopSection> g_shopCatalogSections;
+
+        // The credentials only enter the key (and the stored metadata) as a SHA-256 digest, so a cached
+        // catalog is never served for a different user or password.
+        std::string ShopCatalogCacheKey(const std::string& sectionsUrl, const std::string& user, const std::string& pass)
+        {
+            const std::string credentials = user + "\n" + pass;
+            std::uint8_t digest[0x20] = {};
+            sha256CalculateHash(digest, credentials.data(), credentials.size());
+            static const char kHexDigits[] = "0123456789abcdef";
+            std::string key = sectionsUrl + "\n";
+            for (std::uint8_t byte : digest) {
+                key.push_back(kHexDigits[byte >> 4]);
+                key.push_back(kHexDigits[byte & 0xF]);
+            }
+            return key;
+        }
+
+        std::string GetShopCatalogCacheBasePath(const std::string& cacheKey)
+        {
+            std::string cacheDir = inst::config::appDir + "/shop_cache";
+            std::error_code ec;
+            if (!std::filesystem::exists(cacheDir, ec)) {
+                std::filesystem::create_directory(cacheDir, ec);
+                if (ec)
+                    return "";
+            }
+            return cacheDir + "/" + std::to_string(std::hash<std::string>{}(cacheKey));
+        }
+
+        // All cache file access holds g_shopCatalogMutex: a background revalidation and a foreground
+        // fetch of the same shop can both rewrite the .body/.json pair.
+        bool LoadShopCatalogCacheMeta(const std::string& cacheKey, ShopCatalogCacheMeta& out)
+        {
+            const std::string basePath = GetShopCatalogCacheBasePath(cacheKey);
+            if (basePath.empty())
+                return false;
+            std::lock_guard<std::mutex> lock(g_shopCatalogMutex);
+            std::ifstream in(basePath + ".json", std::ios::binary);
+            if (!in)
+                return false;
+
+            nlohmann::json root;
+            try {
+                in >> root;
+            } catch (...) {
+                return false;
+            }
+
+            if (!root.is_object() || root.value("key", std::string()) != cacheKey)
+                return false;
+            if (!root.contains("size") || !root["size"].is_number_unsigned())
+                return false;
+            out.etag = root.value("etag", std::string());
+            out.lastModified = root.value("lastModified", std::string());
+            out.size = root["size"].get<std::uint64_t>();
+            if (out.etag.empty() && out.lastModified.empty())
+                return false;
+
+            std::error_code ec;
+            const std::uint64_t bodySize = std::filesystem::file_size(basePath + ".body", ec);
+            return !ec && bodySize == out.size;
+        }
+
+        bool LoadShopCatalogCacheBody(const std::string& cacheKey, const ShopCatalogCacheMeta& meta, std::string& out)
+        {
+            const std::string basePath = GetShopCatalogCacheBasePath(cacheKey);
+            if (basePath.empty())
+                return false;
+            std::lock_guard<std::mutex> lock(g_shopCatalogMutex);
+            std::ifstream in(basePath + ".body", std::ios::binary);
+            if (!in)
+                return false;
+            out.resize(static_cast<std::size_t>(meta.size));
+            in.read(out.data(), static_cast<std::streamsize>(out.size()));
+            return static_cast<std::uint64_t>(in.gcount()) == meta.size;
+        }
+
+        void RemoveShopCatalogCache(const std::string& cacheKey)
+        {
+            const std::string basePath = GetShopCatalogCacheBasePath(cacheKey);
+            std::lock_guard<std::mutex> lock(g_shopCatalogMutex);
+            if (g_shopCatalogKey == cacheKey) {
+                g_shopCatalogKey.clear();
+                g_shopCatalogSections.clear();
+            }
+            if (basePath.empty())
+                return;
+            std::error_code ec;
+            std::filesystem::remove(basePath + ".json", ec);
+            std::filesystem::remove(basePath + ".body", ec);
+        }
+
+        // The body is written before the metadata that describes it, so an interrupted write only
+        // leaves a size mismatch that LoadShopCatalogCacheMeta rejects.
+        void StoreShopCatalogCache(const std::string& cacheKey, const FetchResult& fetch)
+        {
+            const std::string basePath = GetShopCatalogCacheBasePath(cacheKey);
+            if (basePath.empty())
+                return;
+            std::lock_guard<std::mutex> lock(g_shopCatalogMutex);
+            std::error_code ec;
+            std::filesystem::remove(basePath + ".json", ec);
+
+            {
+                std::ofstream out(basePath + ".body", std::ios::binary | std::ios::trunc);
+                if (!out)
+                    return;
+                out.write(fetch.body.data(), static_cast<std::streamsize>(fetch.body.size()));
+                if (!out)
+                    return;
+            }
+
+            nlohmann::json root;
+            root["key"] = cacheKey;
+            root["etag"] = fetch.etag;
+            root["lastModified"] = fetch.lastModified;
+            root["size"] = static_cast<std::uint64_t>(fetch.body.size());
+            std::ofstream out(basePath + ".json", std::ios::binary | std::ios::trunc);
+            if (out)
+                out << root.dump();
+        }
+
+        void RememberShopCatalogSections(const std::string& cacheKey, const std::string& etag, const std::string& lastModified, const std::vector<ShopSection>& sections)
+        {
+            std::lock_guard<std::mutex> lock(g_shopCatalogMutex);
+            g_shopCatalogKey = cacheKey;
+            g_shopCatalogEtag = etag;
+            g_shopCatalogLastModified = lastModified;
+            g_shopCatalogSections = sections;
+        }
+
+        bool TryGetRememberedShopSections(const std::string& cacheKey, const ShopCatalogCacheMeta& meta, std::vector<ShopSection>& out)
+        {
+            std::lock_guard<std::mutex> lock(g_shopCatalogMutex);
+            if (g_shopCatalogKey != cacheKey || g_shopCatalogEtag != meta.etag || g_shopCatalogLastModified != meta.lastModified)
+                return false;
+            out = g_shopCatalogSections;
+            return true;
+        }
+
+        // Reuses the parsed sections of this session when they match the stored validators, otherwise
+        // parses the stored payload. A payload that no longer parses is dropped.
+        bool LoadShopCatalogSections(const std::string& cacheKey, const ShopCatalogCacheMeta& meta, const std::string& baseUrl, std::vector<ShopSection>& out)
+        {
+            if (TryGetRememberedShopSections(cacheKey, meta, out))
+                return true;
+
+            std::string body;
+            std::string parseError;
+            if (LoadShopCatalogCacheBody(cacheKey, meta, body))
+                out = ParseShopSectionsBody(body, baseUrl, parseError);
+            if (out.empty() || !parseError.empty()) {
+                LOG_DEBUG("Shop catalog cache is unusable, dropping it\n");
+                out.clear();
+                RemoveShopCatalogCache(cacheKey);
+                return false;
+            }
+
+            RememberShopCatalogSections(cacheKey, meta.etag, meta.lastModified, out);
+            return true;
+        }
+    }
+
     std::vector<ShopItem> FetchShop(const std::string& shopUrl, const std::string& user, const std::string& pass, std::string& error, const ShopFetchProgressCallback& progressCb)
     {
         std::vector<ShopItem> items;
@@ -1842,7 +2259,25 @@ namespace shopInstStuff {
         }
 
         std::string sectionsUrl = baseUrl + "/api/shop/sections";
-        FetchResult fetch = FetchShopResponse(sectionsUrl, user, pass, progressCb);
+        const std::string cacheKey = ShopCatalogCacheKey(sectionsUrl, user, pass);
+        ShopCatalogCacheMeta cacheMeta;
+        const bool haveCache = inst::config::shopCatalogCache && LoadShopCatalogCacheMeta(cacheKey, cacheMeta);
+        std::vector<std::string> conditionalHeaders;
+        if (haveCache) {
+            if (!cacheMeta.etag.empty())
+                conditionalHeaders.push_back("If-None-Match: " + cacheMeta.etag);
+            if (!cacheMeta.lastModified.empty())
+                conditionalHeaders.push_back("If-Modified-Since: " + cacheMeta.lastModified);
+        }
+
+        FetchResult fetch = FetchShopResponse(sectionsUrl, user, pass, progressCb, conditionalHeaders);
+        if (fetch.error.empty() && fetch.responseCode == 304) {
+            if (haveCache && LoadShopCatalogSections(cacheKey, cacheMeta, baseUrl, sections)) {
+                LOG_DEBUG("Shop catalog not modified, reusing %zu cached sections\n", sections.size());
+                return sections;
+            }
+            fetch = FetchShopResponse(sectionsUrl, user, pass, progressCb);
+        }
         if (fetch.responseCode == 404) {
             tryLegacyFallback();
             return sections;
@@ -1861,11 +2296,36 @@ namespace shopInstStuff {
         }
 
         sections = ParseShopSectionsBody(fetch.body, baseUrl, error);
+        if (inst::config::shopCatalogCache) {
+            const bool cacheable = !sections.empty() && error.empty() && (!fetch.etag.empty() || !fetch.lastModified.empty());
+            if (cacheable) {
+                StoreShopCatalogCache(cacheKey, fetch);
+                RememberShopCatalogSections(cacheKey, fetch.etag, fetch.lastModified, sections);
+            } else if (haveCache) {
+                RemoveShopCatalogCache(cacheKey);
+            }
+        }
         if (sections.empty() && !error.empty() && tryLegacyFallback())
             return sections;
         return sections;
     }
 
+    bool LoadCachedShopSections(const std::string& shopUrl, const std::string& user, const std::string& pass, std::vector<ShopSection>& outSections)
+    {
+        outSections.clear();
+        if (!inst::config::shopCatalogCache || inst::config::shopLegacyMode)
+            return false;
+        const std::string baseUrl = NormalizeShopUrl(shopUrl);
+        if (baseUrl.empty())
+            return false;
+
+        const std::string cacheKey = ShopCatalogCacheKey(baseUrl + "/api/shop/sections", user, pass);
+        ShopCatalogCacheMeta cacheMeta;
+        if (!LoadShopCatalogCacheMeta(cacheKey, cacheMeta))
+            return false;
+        return LoadShopCatalogSections(cacheKey, cacheMeta, baseUrl, outSections);
+    }
+
     namespace {
         class StreamInstallHelper final : public tin::install::Install {
         public:
@@ -1902,39 +2362,183 @@ namespace shopInstStuff {
             void InstallNCA(const NcmContentId& /*ncaId*/) override {}
         };
 
+        // Resolves the container type and fetches the PFS0 header and small cnmt NCAs of the next few
+        // queue items on background threads, so that work overlaps with the current install
+        class ShopQueuePrefetcher final {
+        public:
+            struct Prefetched {
+                bool isXci = false;
+                std::shared_ptr<tin::install::nsp::HTTPNSP> nsp;
+            };
+
+            ShopQueuePrefetcher(const std::vector<ShopItem>& items, size_t depth) : m_items(items), m_depth(depth) {}
+
+            // Reached early when an install fails or is cancelled, so in-flight prefetches are aborted
+            // rather than left to finish their range retries
+            ~ShopQueuePrefetcher() {
+                m_stop.store(true);
+                for (auto& [_, slot] : m_slots) {
+                    if (slot->thread.joinable())
+                        slot->thread.join();
+                }
+            }
+
+            // Starts prefetching the items after current, up to the configured depth
+            void Schedule(size_t current) {
+                for (size_t i = current + 1; i < m_items.size() && i <= current + m_depth; i++) {
+                    if (m_slots.count(i)) continue;
+                    auto slot = std::make_unique<Slot>();
+                    Slot* raw = slot.get();
+                    const ShopItem item = m_items[i];
+                    const std::atomic<bool>* stop = &m_stop;
+                    raw->thread = std::thread([raw, item, stop]() { Prefetch(item, stop, raw->result, raw->ok); });
+                    m_slots.emplace(i, std::move(slot));
+                }
+            }
+
+            // Waits for the prefetch of an item. Returns false if it was never started or failed.
+            bool Take(size_t index, Prefetched& out) {
+                auto it = m_slots.find(index);
+                if (it == m_slots.end()) return false;
+                if (it->second->thread.joinable())
+                    it->second->thread.join();
+                const bool ok = it->second->ok;
+                out = std::move(it->second->result);
+                if (out.nsp)
+                    out.nsp->m_download.SetAbortFlag(nullptr); // The NSP outlives this prefetcher
+                m_slots.erase(it);
+                return ok;
+            }
+
+        private:
+            static constexpr size_t kMaxPrefetchedCnmtBytes = 0x100000;
+
+            struct Slot {
+                std::thread thread;
+                Prefetched result;
+                bool ok = false;
+            };
+
+            const std::vector<ShopItem>& m_items;
+            size_t m_depth;
+            std::unordered_map<size_t, std::unique_ptr<Slot>> m_slots;
+            std::atomic<bool> m_stop{false};
+
+            static void Prefetch(const ShopItem& item, const std::atomic<bool>* stop, Prefetched& result, bool& ok) {
+                try {
+                    result.isXci = IsXciExtension(item.name) || IsXciExtension(item.url) || IsXciMagic(item.url, stop);
+                    if (!result.isXci) {
+                        if (stop->load())
+                            THROW_FORMAT("Prefetch aborted\n");
+                        auto nsp = std::make_shared<tin::install::nsp::HTTPNSP>(item.url);
+                        nsp->m_download.SetAbortFlag(stop);
+                        nsp->RetrieveHeader();
+
+                        // Only small cnmt NCAs, large ones take the regular path later
+                        size_t budget = kMaxPrefetchedCnmtBytes;
+                        for (const auto* fileEntry : nsp->GetFileEntriesByExtension("cnmt.nca")) {
+                            if (stop->load())
+                                THROW_FORMAT("Prefetch aborted\n");
+                            if (fileEntry->fileSize > budget) continue;
+                            nsp->PrefetchRange(nsp->GetDataOffset() + fileEntry->dataOffset, fileEntry->fileSize);
+                            budget -= fileEntry->fileSize;
+                        }
+                        result.nsp = std::move(nsp);
+                    }
+                    ok = true;
+                } catch (std::exception& e) {
+                    LOG_DEBUG("Shop prefetch of %s failed: %s\n", item.url.c_str(), e.what());
+                    result = Prefetched{};
+                    ok = false;
+                }
+            }
+        };
+
+        // Caches aligned windows of the remote file in LRU order for the small, scattered reads of the
+        // XCI header and partition tables. The bulk of the data is streamed by a PrefetchReader instead.
         class HttpStreamSource {
         public:
             explicit HttpStreamSource(tin::network::HTTPDownload& download) : m_download(download) {}
 
             Result Read(void* buf, s64 off, s64 size, u64* bytes_read) {
                 if (off < 0 || size <= 0) return MAKERESULT(Module_Libnx, LibnxError_BadInput);
-                const size_t req_size = static_cast<size_t>(size);
-                const size_t req_off = static_cast<size_t>(off);
-
-                if (!m_cache.empty() && req_off >= m_cache_start && (req_off + req_size) <= m_cache_end) {
-                    const size_t rel = req_off - m_cache_start;
-                    std::memcpy(buf, m_cache.data() + rel, req_size);
-                    *bytes_read = static_cast<u64>(size);
-                    return 0;
-                }
+                u8* out = static_cast<u8*>(buf);
+                const u64 req_off = static_cast<u64>(off);
+                const u64 req_end = req_off + static_cast<u64>(size);
+
+                u64 pos = req_off;
+                while (pos < req_end) {
+                    const u64 index = pos / kWindowSize;
+                    std::shared_ptr<std::vector<u8>> window;
+                    try {
+                        window = this->GetWindow(index);
+                    } catch (std::exception& e) {
+                        // A window may run past the end of the file, fall back to the exact range
+                        LOG_DEBUG("HttpStreamSource: window %lu unavailable (%s), reading 0x%lx bytes at 0x%lx directly\n", index, e.what(), req_end - pos, pos);
+                        m_download.BufferDataRange(out + (pos - req_off), pos, req_end - pos, nullptr);
+                        break;
+                    }
 
-                const size_t fetch_size = std::min(req_size, kReadAheadSize);
-                m_cache.resize(fetch_size);
-                m_download.BufferDataRange(m_cache.data(), req_off, fetch_size, nullptr);
-                m_cache_start = req_off;
-                m_cache_end = req_off + fetch_size;
+                    const u64 window_start = index * kWindowSize;
+                    const u64 copy_end = std::min<u64>(req_end, window_start + window->size());
+                    if (copy_end <= pos) {
+                        m_download.BufferDataRange(out + (pos - req_off), pos, req_end - pos, nullptr);
+                        break;
+                    }
+                    std::memcpy(out + (pos - req_off), window->data() + (pos - window_start), copy_end - pos);
+                    pos = copy_end;
+                }
 
-                std::memcpy(buf, m_cache.data(), req_size);
                 *bytes_read = static_cast<u64>(size);
                 return 0;
             }
 
+            // Copies what the cached windows already hold from the start of the range and downloads
+            // the rest, so the data stream doesn't fetch the bytes the header reads pulled in again
+            void ReadThrough(void* buf, u64 off, size_t size) {
+                u8* out = static_cast<u8*>(buf);
+                while (size > 0) {
+                    const u64 index = off / kWindowSize;
+                    auto it = std::find_if(m_windows.begin(), m_windows.end(), [index](const Window& w) { return w.index == index; });
+                    const u64 window_start = index * kWindowSize;
+                    if (it == m_windows.end() || off - window_start >= it->data->size())
+                        break;
+                    const size_t copy = static_cast<size_t>(std::min<u64>(size, window_start + it->data->size() - off));
+                    std::memcpy(out, it->data->data() + (off - window_start), copy);
+                    out += copy;
+                    off += copy;
+                    size -= copy;
+                }
+                if (size > 0)
+                    m_download.BufferDataRange(out, off, size, nullptr);
+            }
+
         private:
-            static constexpr size_t kReadAheadSize = 16 * 1024 * 1024;
+            static constexpr u64 kWindowSize = 4 * 1024 * 1024;
+            static constexpr size_t kMaxWindows = 2;
+
+            struct Window {
+                u64 index;
+                std::shared_ptr<std::vector<u8>> data;
+            };
+
             tin::network::HTTPDownload& m_download;
-            std::vector<std::uint8_t> m_cache;
-            size_t m_cache_start = 0;
-            size_t m_cache_end = 0;
+            std::list<Window> m_windows; // Most recently used first
+
+            std::shared_ptr<std::vector<u8>> GetWindow(u64 index) {
+                for (auto it = m_windows.begin(); it != m_windows.end(); ++it) {
+                    if (it->index != index) continue;
+                    m_windows.splice(m_windows.begin(), m_windows, it);
+                    return it->data;
+                }
+
+                auto data = std::make_shared<std::vector<u8>>(kWindowSize);
+                m_download.BufferDataRange(data->data(), index * kWindowSize, kWindowSize, nullptr);
+                m_windows.push_front(Window{index, data});
+                while (m_windows.size() > kMaxWindows)
+                    m_windows.pop_back();
+                return data;
+            }
         };
 
         struct StreamHfs0Header {
@@ -2026,6 +2630,9 @@ namespace shopInstStuff {
             return false;
         }
 
+        constexpr u32 kStreamPipelineDepth = 3;
+        constexpr size_t kStreamChunkSize = 4 * 1024 * 1024;
+
         static bool InstallXciHttpStream(const std::string& url, NcmStorageId dest_storage) {
             tin::network::HTTPDownload download(url);
             HttpStreamSource source(download);
@@ -2033,6 +2640,11 @@ namespace shopInstStuff {
             std::vector<StreamCollectionEntry> collections;
             if (!GetXciCollections(source, collections)) return false;
 
+            u64 dataEnd = 0;
+            for (const auto& c : collections) {
+                dataEnd = std::max<u64>(dataEnd, c.offset + c.size);
+            }
+
             u64 totalBytes = 0;
             for (const auto& c : collections) {
                 totalBytes += c.size;
@@ -2096,13 +2708,44 @@ namespace shopInstStuff {
                 }
             };
 
-            std::vector<std::uint8_t> buf(0x800000);
+            // Download the secure partition data on a reader thread so fetching the next chunk,
+            // and with it the next entry, overlaps with writing the current one. This is the only
+            // read-ahead stage: chunks are downloaded straight into the reader's buffers, apart from
+            // the start that the header windows already hold. The source is only used by the reader
+            // thread from here on.
+            const u64 streamStart = collections.empty() ? 0 : collections.front().offset;
+            tin::data::PrefetchReader reader([&source](void* buf, u64 offset, size_t size) {
+                source.ReadThrough(buf, offset, size);
+            }, streamStart, dataEnd - streamStart, kStreamPipelineDepth, kStreamChunkSize);
+
+            const u8* chunkData = nullptr;
+            size_t chunkSize = 0;
+            u64 streamPos = streamStart;
+            auto nextBytes = [&](u64 maxSize, const u8*& data, u64& size) -> bool {
+                if (chunkSize == 0) {
+                    try {
+                        if (!reader.Next(chunkData, chunkSize))
+                            return false;
+                    } catch (...) {
+                        cleanupEntries();
+                        throw;
+                    }
+                }
+                size = std::min<u64>(maxSize, chunkSize);
+                data = chunkData;
+                chunkData += size;
+                chunkSize -= size;
+                streamPos += size;
+                return true;
+            };
+
             for (const auto& collection : collections) {
                 if (inst::ui::instPage::isInstallCancelRequested()) {
                     cleanupEntries();
                     THROW_FORMAT("Installation canceled.");
                 }
-                EntryState entry;
+                // Tracked before any data is written, so a failed write cleans up this entry's placeholder too
+                EntryState& entry = entries[collection.name];
                 entry.name = collection.name;
                 entry.size = collection.size;
                 entry.is_nca = entry.name.find(".nca") != std::string::npos || entry.name.find(".ncz") != std::string::npos;
@@ -2113,37 +2756,54 @@ namespace shopInstStuff {
 
                 if (!ensureStarted(entry)) return false;
 
+                // Entries are read as one sequential stream, skip any padding before this one
+                if (collection.offset < streamPos) {
+                    LOG_DEBUG("XCI entry %s overlaps the previous entry\n", collection.name.c_str());
+                    cleanupEntries();
+                    return false;
+                }
+                while (streamPos < collection.offset) {
+                    const u8* skipped = nullptr;
+                    u64 skippedSize = 0;
+                    if (!nextBytes(collection.offset - streamPos, skipped, skippedSize)) {
+                        cleanupEntries();
+                        return false;
+                    }
+                }
+
+                const u64 entryStartTick = armGetSystemTick();
                 u64 remaining = collection.size;
-                u64 offset = collection.offset;
                 while (remaining > 0) {
                     if (inst::ui::instPage::isInstallCancelRequested()) {
                         cleanupEntries();
                         THROW_FORMAT("Installation canceled.");
                     }
-                    const auto chunk = static_cast<size_t>(std::min<u64>(remaining, buf.size()));
+                    const u8* data = nullptr;
                     u64 bytes_read = 0;
-                    if (R_FAILED(source.Read(buf.data(), static_cast<s64>(offset), static_cast<s64>(chunk), &bytes_read))) {
-                        cleanupEntries();
-                        return false;
-                    }
-                    if (bytes_read == 0) {
+                    if (!nextBytes(remaining, data, bytes_read) || bytes_read == 0) {
                         cleanupEntries();
                         return false;
                     }
 
                     if (entry.name.find(".tik") != std::string::npos) {
-                        entry.ticket_buf.insert(entry.ticket_buf.end(), buf.data(), buf.data() + bytes_read);
+                        entry.ticket_buf.insert(entry.ticket_buf.end(), data, data + bytes_read);
                         entry.written += bytes_read;
                         if (entry.written >= entry.size) entry.complete = true;
                     } else if (entry.name.find(".cert") != std::string::npos) {
-                        entry.cert_buf.insert(entry.cert_buf.end(), buf.data(), buf.data() + bytes_read);
+                        entry.cert_buf.insert(entry.cert_buf.end(), data, data + bytes_read);
                         entry.written += bytes_read;
                         if (entry.written >= entry.size) entry.complete = true;
                     } else if (entry.is_nca && entry.nca_writer) {
-                        entry.nca_writer->write(buf.data(), bytes_read);
-                        entry.written += bytes_read;
+                        try {
+                            entry.nca_writer->write(data, bytes_read);
+                            entry.written += bytes_read;
+                            if (entry.written >= entry.size)
+                                entry.nca_writer->close();
+                        } catch (...) {
+                            cleanupEntries();
+                            throw;
+                        }
                         if (entry.written >= entry.size) {
-                            entry.nca_writer->close();
                             try {
                                 entry.storage->Register(*(NcmPlaceHolderId*)&entry.nca_id, entry.nca_id);
                                 entry.storage->DeletePlaceholder(*(NcmPlaceHolderId*)&entry.nca_id);
@@ -2169,7 +2829,6 @@ namespace shopInstStuff {
                         }
                     }
 
-                    offset += bytes_read;
                     remaining -= bytes_read;
                     processedBytes += bytes_read;
 
@@ -2207,8 +2866,9 @@ namespace shopInstStuff {
                         }
                     }
                 }
-
-                entries.emplace(entry.name, std::move(entry));
+                if (entry.is_nca)
+                    inst::diag::NoteThroughput("shop", entry.name, entry.size,
+                        static_cast<double>(armGetSystemTick() - entryStartTick) / static_cast<double>(freq));
             }
 
             for (auto& [name, entry] : entries) {
@@ -2286,14 +2946,18 @@ namespace shopInstStuff {
 
         std::string currentName;
         try {
+            ShopQueuePrefetcher prefetcher(items, static_cast<size_t>(std::clamp(inst::config::shopPrefetchDepth, 0, 4)));
             for (size_t i = 0; i < items.size(); i++) {
+                prefetcher.Schedule(i);
                 LOG_DEBUG("%s %s\n", "Install request from", items[i].url.c_str());
                 currentName = names[i];
                 inst::diag::NoteTransferReceived(currentName);
                 UpdateInstallIcon(items[i]);
                 inst::ui::instPage::setTopInstInfoText("inst.info_page.top_info0"_lang + currentName + sourceLabel);
                 std::unique_ptr<tin::install::Install> installTask;
-                bool isXci = IsXciExtension(items[i].name) || IsXciExtension(items[i].url) || IsXciMagic(items[i].url);
+                ShopQueuePrefetcher::Prefetched prefetched;
+                const bool havePrefetch = prefetcher.Take(i, prefetched);
+                bool isXci = havePrefetch ? prefetched.isXci : (IsXciExtension(items[i].name) || IsXciExtension(items[i].url) || IsXciMagic(items[i].url));
                 if (isXci) {
                     inst::ui::instPage::setInstInfoText("Transfer received. Install started...");
                     inst::diag::NoteInstallStarted(currentName);
@@ -2303,7 +2967,8 @@ namespace shopInstStuff {
                     inst::diag::RecordSuccess(currentName);
                     continue;
                 } else {
-                    auto httpNSP = std::make_shared<tin::install::nsp::HTTPNSP>(items[i].url);
+                    auto httpNSP = prefetched.nsp ? prefetched.nsp : std::make_shared<tin::install::nsp::HTTPNSP>(items[i].url);
+                    httpNSP->m_sourceName = "shop";
                     installTask = std::make_unique<tin::install::nsp::NSPInstall>(destStorageId, inst::config::ignoreReqVers, httpNSP);
                 }
 
@@ -18,6 +18,10 @@ namespace inst::ui {
     extern MainApplication *mainApp;
     static pu::ui::Layout::Ref lastLayoutBeforeInstall;
     static std::atomic<bool> g_installCancelRequested{false};
+    // Background install workers must not render; only the thread driving the install page updates it.
+    static thread_local bool g_progressMuted = false;
+    // Where a muted thread's bar percentage goes instead, so the driving thread can aggregate it.
+    static thread_local std::atomic<double>* g_progressSink = nullptr;
     static std::atomic<bool> g_installDimSessionActive{false};
     static std::atomic<bool> g_installDimStopRequested{false};
     static std::thread g_installDimThread;
@@ -231,17 +235,24 @@ namespace inst::ui {
     }
 
     void instPage::setInstInfoText(std::string ourText){
+        if (g_progressMuted) return;
         mainApp->instpage->installInfoText->SetText(ourText);
         mainApp->CallForRender();
     }
 
     void instPage::setInstBarPerc(double ourPercent){
+        if (g_progressMuted) {
+            if (g_progressSink != nullptr)
+                g_progressSink->store(ourPercent, std::memory_order_relaxed);
+            return;
+        }
         mainApp->instpage->installBar->SetVisible(true);
         mainApp->instpage->installBar->SetProgress(ourPercent);
         mainApp->CallForRender();
     }
 
     void instPage::setProgressDetailText(const std::string& ourText){
+        if (g_progressMuted) return;
         mainApp->instpage->progressDetailText->SetText(ourText);
         mainApp->instpage->progressDetailText->SetX((1280 - mainApp->instpage->progressDetailText->GetTextWidth()) / 2);
         mainApp->instpage->progressDetailText->SetVisible(true);
@@ -249,6 +260,7 @@ namespace inst::ui {
     }
 
     void instPage::clearProgressDetailText(){
+        if (g_progressMuted) return;
         mainApp->instpage->progressDetailText->SetVisible(false);
         mainApp->CallForRender();
     }
@@ -356,6 +368,14 @@ namespace inst::ui {
         g_installCancelRequested.store(false);
     }
 
+    void instPage::setProgressMutedOnThisThread(bool muted){
+        g_progressMuted = muted;
+    }
+
+    void instPage::setProgressSinkOnThisThread(std::atomic<double>* sink){
+        g_progressSink = sink;
+    }
+
     void instPage::onInput(u64 Down, u64 Up, u64 Held, pu::ui::Touch Pos) {
         if (!Pos.IsEmpty()) {
             if (!this->touchWakeActive) {
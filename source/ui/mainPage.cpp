@@ -202,14 +202,14 @@ namespace inst::ui {
     void mainMenuThread() {
         bool menuLoaded = mainApp->IsShown();
         if (!appletFinished && appletGetAppletType() == AppletType_LibraryApplet) {
-            tin::data::NUM_BUFFER_SEGMENTS = 2;
+            tin::data::BUFFER_MEMORY_BUDGET = tin::data::APPLET_BUFFER_MEMORY_BUDGET;
             if (menuLoaded) {
                 inst::ui::appletFinished = true;
                 mainApp->CreateShowDialog("main.applet.title"_lang, "main.applet.desc"_lang, {"common.ok"_lang}, true);
             } 
         } else if (!appletFinished) {
             inst::ui::appletFinished = true;
-            tin::data::NUM_BUFFER_SEGMENTS = 128;
+            tin::data::BUFFER_MEMORY_BUDGET = tin::data::FULL_BUFFER_MEMORY_BUDGET;
         }
         if (!updateFinished && (!inst::config::autoUpdate || inst::util::getIPAddress() == "1.0.0.127")) updateFinished = true;
         if (!updateFinished && menuLoaded && inst::config::updateInfo.size()) {
@@ -237,6 +237,7 @@ namespace inst::ui {
                         inst::ui::instPage::setTopInstInfoText("Updating Offline DB");
                         inst::ui::instPage::setInstInfoText("Preparing...");
                         inst::ui::instPage::setInstBarPerc(0);
+                        mainApp->shopinstPage->stopCatalogRevalidation();
                         const auto apply = inst::offline::dbupdate::ApplyUpdate(inst::config::offlineDbManifestUrl, false,
                             [](const std::string& stage, double percent) {
                                 inst::ui::instPage::setInstInfoText(stage);
@@ -1117,6 +1117,7 @@ namespace inst::ui {
                     inst::ui::instPage::setTopInstInfoText("Updating Offline DB");
                     inst::ui::instPage::setInstInfoText("Preparing...");
                     inst::ui::instPage::setInstBarPerc(0);
+                    mainApp->shopinstPage->stopCatalogRevalidation();
                     const auto apply = inst::offline::dbupdate::ApplyUpdate(manifestUrl, false,
                         [](const std::string& stage, double percent) {
                             inst::ui::instPage::setInstInfoText(stage);
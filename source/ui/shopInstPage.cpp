@@ -1114,6 +1114,59 @@ namespace inst::ui {
         this->iconDownloadCv.notify_all();
         if (this->iconDownloadThread.joinable())
             this->iconDownloadThread.join();
+        if (this->catalogRevalidateThread.joinable())
+            this->catalogRevalidateThread.join();
+    }
+
+    // Stale-while-revalidate: the cached catalog is already on screen, this refreshes the on-disk cache
+    // in the background and hands the result to the next startShop().
+    void shopInstPage::startCatalogRevalidation(const std::string& shopUrl, const std::string& cacheKey) {
+        this->finishCatalogRevalidation();
+        if (this->catalogRevalidateThread.joinable())
+            return;
+        this->catalogRevalidateKey = cacheKey;
+        this->catalogRevalidateSuperseded = false;
+        this->catalogRevalidateDone.store(false, std::memory_order_relaxed);
+        const std::string user = inst::config::shopUser;
+        const std::string pass = inst::config::shopPass;
+        this->catalogRevalidateThread = std::thread([this, shopUrl, user, pass]() {
+            std::string error;
+            bool usedLegacyFallback = false;
+            this->catalogRevalidateSections = shopInstStuff::FetchShopSections(shopUrl, user, pass, error, &usedLegacyFallback);
+            this->catalogRevalidateUsedLegacyFallback = usedLegacyFallback;
+            this->catalogRevalidateOk = error.empty() && !this->catalogRevalidateSections.empty();
+            this->catalogRevalidateDone.store(true, std::memory_order_release);
+        });
+    }
+
+    // Never waits on the UI thread: a revalidation that is still downloading is left running and
+    // picked up by a later startShop().
+    void shopInstPage::finishCatalogRevalidation() {
+        if (!this->catalogRevalidateThread.joinable() || !this->catalogRevalidateDone.load(std::memory_order_acquire))
+            return;
+        this->catalogRevalidateThread.join();
+        if (!this->catalogRevalidateOk)
+            return;
+        this->catalogRevalidateOk = false;
+        if (this->catalogRevalidateSuperseded) {
+            this->catalogRevalidateSections.clear();
+            return;
+        }
+        this->catalogCacheValid = true;
+        this->catalogCacheKey = this->catalogRevalidateKey;
+        this->catalogCacheUsedLegacyFallback = this->catalogRevalidateUsedLegacyFallback;
+        this->catalogCacheSections = std::move(this->catalogRevalidateSections);
+        this->catalogRevalidateSections.clear();
+    }
+
+    // The revalidation parses against the offline title DB, so it has to be gone before that DB is
+    // replaced. Blocks until the fetch returns and drops its result.
+    void shopInstPage::stopCatalogRevalidation() {
+        if (!this->catalogRevalidateThread.joinable())
+            return;
+        this->catalogRevalidateThread.join();
+        this->catalogRevalidateOk = false;
+        this->catalogRevalidateSections.clear();
     }
 
     void shopInstPage::resetIconDownloadState() {
@@ -3711,6 +3764,7 @@ namespace inst::ui {
         this->setLoadingProgress(loadingPercent, true);
         mainApp->CallForRender();
 
+        this->finishCatalogRevalidation();
         const std::string cacheKey = shopUrl + "\n" + inst::config::shopUser + "\n" + inst::config::shopPass + "\n" + (inst::config::shopLegacyMode ? "1" : "0");
         const bool canUseCatalogCache = !forceRefresh
             && this->catalogCacheValid
@@ -3721,6 +3775,14 @@ namespace inst::ui {
             updateLoadingProgress(89, "Using cached catalog...", true);
             this->shopSections = this->catalogCacheSections;
             usedLegacyFallback = this->catalogCacheUsedLegacyFallback;
+        } else if (!forceRefresh && inst::config::shopCatalogStaleWhileRevalidate
+            && shopInstStuff::LoadCachedShopSections(shopUrl, inst::config::shopUser, inst::config::shopPass, this->shopSections)) {
+            updateLoadingProgress(89, "Using cached catalog...", true);
+            this->catalogCacheValid = true;
+            this->catalogCacheKey = cacheKey;
+            this->catalogCacheUsedLegacyFallback = false;
+            this->catalogCacheSections = this->shopSections;
+            this->startCatalogRevalidation(shopUrl, cacheKey);
         } else {
             std::atomic<bool> fetchDone{false};
             std::atomic<std::uint64_t> fetchDownloaded{0};
@@ -3813,6 +3875,8 @@ namespace inst::ui {
             error = fetchError;
             usedLegacyFallback = fetchUsedLegacyFallback;
             if (error.empty() && !this->shopSections.empty()) {
+                // A foreground fetch is at least as fresh as a revalidation still in flight
+                this->catalogRevalidateSuperseded = true;
                 this->catalogCacheValid = true;
                 this->catalogCacheKey = cacheKey;
                 this->catalogCacheUsedLegacyFallback = usedLegacyFallback;
@@ -36,6 +36,17 @@ namespace inst::config {
     bool shopStartGridMode;
     bool offlineDbAutoCheckOnStartup;
     bool verboseInstallLogging;
+    int nczDecompressThreads;
+    int httpRangeConnections;
+    int localReadAheadDepth;
+    int localReadChunkMb;
+    int concurrentNcaInstalls;
+    int zstdOutputWindowMb;
+    int bufferSegmentMb;
+    int headerReadAheadKb;
+    int shopPrefetchDepth;
+    bool shopCatalogCache;
+    bool shopCatalogStaleWhileRevalidate;
 
     namespace {
         std::string ToLower(std::string value)
@@ -659,6 +670,17 @@ namespace inst::config {
             {"shopStartGridMode", shopStartGridMode},
             {"offlineDbAutoCheckOnStartup", offlineDbAutoCheckOnStartup},
             {"verboseInstallLogging", verboseInstallLogging},
+            {"nczDecompressThreads", nczDecompressThreads},
+            {"httpRangeConnections", httpRangeConnections},
+            {"localReadAheadDepth", localReadAheadDepth},
+            {"localReadChunkMb", localReadChunkMb},
+            {"concurrentNcaInstalls", concurrentNcaInstalls},
+            {"zstdOutputWindowMb", zstdOutputWindowMb},
+            {"bufferSegmentMb", bufferSegmentMb},
+            {"headerReadAheadKb", headerReadAheadKb},
+            {"shopPrefetchDepth", shopPrefetchDepth},
+            {"shopCatalogCache", shopCatalogCache},
+            {"shopCatalogStaleWhileRevalidate", shopCatalogStaleWhileRevalidate},
             {"shopRememberSelection", false},
             {"shopSelection", nlohmann::json::array()}
         };
@@ -693,6 +715,17 @@ namespace inst::config {
         shopStartGridMode = false;
         offlineDbAutoCheckOnStartup = true;
         verboseInstallLogging = false;
+        nczDecompressThreads = 2;
+        httpRangeConnections = 4;
+        localReadAheadDepth = 3;
+        localReadChunkMb = 4;
+        concurrentNcaInstalls = 2;
+        zstdOutputWindowMb = 2;
+        bufferSegmentMb = 8;
+        headerReadAheadKb = 256;
+        shopPrefetchDepth = 2;
+        shopCatalogCache = true;
+        shopCatalogStaleWhileRevalidate = false;
         bool hasHttpUserAgentModeKey = false;
         bool needsConfigRewrite = false;
 
@@ -729,6 +762,17 @@ namespace inst::config {
             if (j.contains("shopStartGridMode")) shopStartGridMode = j["shopStartGridMode"].get<bool>();
             if (j.contains("offlineDbAutoCheckOnStartup")) offlineDbAutoCheckOnStartup = j["offlineDbAutoCheckOnStartup"].get<bool>();
             if (j.contains("verboseInstallLogging")) verboseInstallLogging = j["verboseInstallLogging"].get<bool>();
+            if (j.contains("nczDecompressThreads")) nczDecompressThreads = j["nczDecompressThreads"].get<int>();
+            if (j.contains("httpRangeConnections")) httpRangeConnections = j["httpRangeConnections"].get<int>();
+            if (j.contains("localReadAheadDepth")) localReadAheadDepth = j["localReadAheadDepth"].get<int>();
+            if (j.contains("localReadChunkMb")) localReadChunkMb = j["localReadChunkMb"].get<int>();
+            if (j.contains("concurrentNcaInstalls")) concurrentNcaInstalls = j["concurrentNcaInstalls"].get<int>();
+            if (j.contains("zstdOutputWindowMb")) zstdOutputWindowMb = j["zstdOutputWindowMb"].get<int>();
+            if (j.contains("bufferSegmentMb")) bufferSegmentMb = j["bufferSegmentMb"].get<int>();
+            if (j.contains("headerReadAheadKb")) headerReadAheadKb = j["headerReadAheadKb"].get<int>();
+            if (j.contains("shopPrefetchDepth")) shopPrefetchDepth = j["shopPrefetchDepth"].get<int>();
+            if (j.contains("shopCatalogCache")) shopCatalogCache = j["shopCatalogCache"].get<bool>();
+            if (j.contains("shopCatalogStaleWhileRevalidate")) shopCatalogStaleWhileRevalidate = j["shopCatalogStaleWhileRevalidate"].get<bool>();
 
             static const char* currentKeys[] = {
                 "autoUpdate",
@@ -756,7 +800,18 @@ namespace inst::config {
                 "shopLegacyMode",
                 "shopStartGridMode",
                 "offlineDbAutoCheckOnStartup",
-                "verboseInstallLogging"
+                "verboseInstallLogging",
+                "nczDecompressThreads",
+                "httpRangeConnections",
+                "localReadAheadDepth",
+                "localReadChunkMb",
+                "concurrentNcaInstalls",
+                "zstdOutputWindowMb",
+                "bufferSegmentMb",
+                "headerReadAheadKb",
+                "shopPrefetchDepth",
+                "shopCatalogCache",
+                "shopCatalogStaleWhileRevalidate"
             };
 
             for (const char* key : currentKeys) {
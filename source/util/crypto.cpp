@@ -1,9 +1,64 @@
 #include "util/crypto.hpp"
 
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string.h>
 #include <mbedtls/bignum.h>
 
+namespace {
+    std::mutex g_headerKeyMutex;
+    std::unique_ptr<Crypto::AesXtr> g_headerDecryptor;
+    std::unique_ptr<Crypto::AesXtr> g_headerEncryptor;
+
+    void EnsureHeaderContexts() {
+        if (g_headerDecryptor && g_headerEncryptor) return;
+        Crypto::Keys keys;
+        g_headerDecryptor = std::make_unique<Crypto::AesXtr>(keys.headerKey, false);
+        g_headerEncryptor = std::make_unique<Crypto::AesXtr>(keys.headerKey, true);
+        memset(keys.headerKey, 0, sizeof(keys.headerKey));
+    }
+}
+
+Crypto::AesXtr Crypto::GetHeaderDecryptor() {
+    std::lock_guard<std::mutex> lock(g_headerKeyMutex);
+    EnsureHeaderContexts();
+    return *g_headerDecryptor;
+}
+
+Crypto::AesXtr Crypto::GetHeaderEncryptor() {
+    std::lock_guard<std::mutex> lock(g_headerKeyMutex);
+    EnsureHeaderContexts();
+    return *g_headerEncryptor;
+}
+
+void Crypto::InvalidateHeaderKey() {
+    std::lock_guard<std::mutex> lock(g_headerKeyMutex);
+    g_headerDecryptor.reset();
+    g_headerEncryptor.reset();
+}
+
+void Crypto::DecryptNcaKeyAreaKey(u8 kaekIndex, u8 keyGeneration, const u8* encryptedKey, u8* outKey) {
+    static const u8 keyAreaKeySources[3][0x10] = {
+        { 0x7F, 0x59, 0x97, 0x1E, 0x62, 0x9F, 0x36, 0xA1, 0x30, 0x98, 0x06, 0x6F, 0x21, 0x44, 0xC3, 0x0D }, /* Application */
+        { 0x32, 0x7D, 0x36, 0x08, 0x5A, 0xD1, 0x75, 0x8D, 0xAB, 0x4E, 0x6F, 0xBA, 0xA5, 0x55, 0xD8, 0x82 }, /* Ocean */
+        { 0x87, 0x45, 0xF1, 0xBB, 0xA6, 0xBE, 0x79, 0x64, 0x7D, 0x04, 0x8B, 0xA6, 0x7B, 0x5F, 0xDA, 0x4A }, /* System */
+    };
+
+    if (kaekIndex >= 3) {
+        throw std::runtime_error("Invalid NCA key area key index!");
+    }
+
+    /* Generations 0 and 1 both use the first master key. */
+    const u32 masterKeyRevision = keyGeneration > 0 ? keyGeneration - 1 : 0;
+    u8 kek[0x10] = {0};
+
+    if (R_FAILED(splCryptoGenerateAesKek(keyAreaKeySources[kaekIndex], masterKeyRevision, 0, kek)) ||
+        R_FAILED(splCryptoGenerateAesKey(kek, encryptedKey, outKey))) {
+        throw std::runtime_error("Failed to unwrap NCA key area key!");
+    }
+}
+
 void Crypto::calculateMGF1andXOR(unsigned char* data, size_t data_size, const void* source, size_t source_size) {
     unsigned char h_buf[RSA_2048_BYTES] = {0};
     memcpy(h_buf, source, source_size);
@@ -161,6 +161,7 @@ struct DownloadProgressContext {
 
 struct WriteAtOffsetContext {
     FILE* file = nullptr;
+    const inst::curl::DownloadDataCallback* dataCb = nullptr;
 };
 
 int progress_callback_file(void *clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t /*ultotal*/, curl_off_t /*ulnow*/) {
@@ -185,7 +186,10 @@ static size_t writeDataFileAtOffset(void *ptr, size_t size, size_t nmemb, void *
     auto* ctx = static_cast<WriteAtOffsetContext*>(stream);
     if (ctx == nullptr || ctx->file == nullptr)
         return 0;
-    return fwrite(ptr, size, nmemb, ctx->file);
+    const size_t written = fwrite(ptr, size, nmemb, ctx->file);
+    if (written > 0 && ctx->dataCb != nullptr && *ctx->dataCb)
+        (*ctx->dataCb)(ptr, written * size);
+    return written;
 }
 
 static constexpr long kDefaultConnectTimeoutMs = 15000;
@@ -407,7 +411,7 @@ namespace inst::curl {
         return false;
     }
 
-    bool downloadFileRangeToOffsetWithProgress(const std::string ourUrl, const char *pagefilename, std::uint64_t fileOffset, std::uint64_t start, std::uint64_t endInclusive, long timeout, const DownloadProgressCallback& progressCb) {
+    bool downloadFileRangeToOffsetWithProgress(const std::string ourUrl, const char *pagefilename, std::uint64_t fileOffset, std::uint64_t start, std::uint64_t endInclusive, long timeout, const DownloadProgressCallback& progressCb, const DownloadDataCallback& dataCb) {
         if (!ensureCurlGlobalInit()) {
             LOG_DEBUG("curl global init failed\n");
             return false;
@@ -460,6 +464,7 @@ namespace inst::curl {
 
         WriteAtOffsetContext writeCtx{};
         writeCtx.file = pagefile;
+        writeCtx.dataCb = &dataCb;
         curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, &writeCtx);
         const CURLcode result = curl_easy_perform(curl_handle);
         long responseCode = 0;
@@ -483,6 +488,78 @@ namespace inst::curl {
         return false;
     }
 
+    bool downloadFileResumable(const std::string ourUrl, const char *pagefilename, std::uint64_t resumeOffset, long timeout, const DownloadProgressCallback& progressCb, const DownloadDataCallback& dataCb) {
+        if (!ensureCurlGlobalInit()) {
+            LOG_DEBUG("curl global init failed\n");
+            return false;
+        }
+
+        CURL *curl_handle = curl_easy_init();
+        if (curl_handle == nullptr) {
+            LOG_DEBUG("curl_easy_init failed\n");
+            return false;
+        }
+
+        applyCommonCurlOptions(curl_handle, ourUrl, timeout, false);
+        curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, writeDataFileAtOffset);
+        curl_easy_setopt(curl_handle, CURLOPT_FAILONERROR, 1L);
+        curl_easy_setopt(curl_handle, CURLOPT_NOPROGRESS, 0L);
+        if (resumeOffset > 0)
+            curl_easy_setopt(curl_handle, CURLOPT_RESUME_FROM_LARGE, static_cast<curl_off_t>(resumeOffset));
+
+        DownloadProgressContext progressCtx{};
+        progressCtx.cb = &progressCb;
+        progressCtx.lastNow = -1;
+        progressCtx.lastTotal = -1;
+        curl_easy_setopt(curl_handle, CURLOPT_XFERINFOFUNCTION, progress_callback_file);
+        curl_easy_setopt(curl_handle, CURLOPT_XFERINFODATA, &progressCtx);
+
+        // Unlike downloadFileWithProgress, a partial file is kept on failure so the caller can resume it.
+        FILE *pagefile = fopen(pagefilename, resumeOffset > 0 ? "r+b" : "wb");
+        if (pagefile == nullptr) {
+            LOG_DEBUG("Failed to open resumable output file: %s\n", pagefilename);
+            curl_easy_cleanup(curl_handle);
+            return false;
+        }
+        applyBufferedFileIo(pagefile);
+
+#if defined(_WIN32)
+        if (_fseeki64(pagefile, static_cast<__int64>(resumeOffset), SEEK_SET) != 0) {
+#else
+        if (fseeko(pagefile, static_cast<off_t>(resumeOffset), SEEK_SET) != 0) {
+#endif
+            fclose(pagefile);
+            curl_easy_cleanup(curl_handle);
+            return false;
+        }
+
+        WriteAtOffsetContext writeCtx{};
+        writeCtx.file = pagefile;
+        writeCtx.dataCb = &dataCb;
+        curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, &writeCtx);
+        const CURLcode result = curl_easy_perform(curl_handle);
+        long responseCode = 0;
+        curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &responseCode);
+
+        fflush(pagefile);
+        fclose(pagefile);
+        curl_easy_cleanup(curl_handle);
+
+        const bool ok = (result == CURLE_OK) &&
+            (resumeOffset > 0 ? (responseCode == 206) : (responseCode >= 200 && responseCode < 300));
+        if (ok) {
+            if (progressCb) {
+                progressCb(progressCtx.lastNow > 0 ? static_cast<std::uint64_t>(progressCtx.lastNow) : 0,
+                    progressCtx.lastTotal > 0 ? static_cast<std::uint64_t>(progressCtx.lastTotal) : 0);
+            }
+            return true;
+        }
+
+        LOG_DEBUG("downloadFileResumable failed rc=%s http=%ld url=%s offset=%llu\n",
+            curl_easy_strerror(result), responseCode, ourUrl.c_str(), static_cast<unsigned long long>(resumeOffset));
+        return false;
+    }
+
     bool downloadFileWithAuth(const std::string ourUrl, const char *pagefilename, const std::string& user, const std::string& pass, long timeout) {
         if (!ensureCurlGlobalInit()) {
             LOG_DEBUG("curl global init failed\n");
@@ -22,11 +22,17 @@ SOFTWARE.
 
 #include "util/file_util.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 
+#include "install/nca.hpp"
+#include "install/pfs0.hpp"
 #include "install/simple_filesystem.hpp"
 #include "nx/fs.hpp"
 #include "data/byte_buffer.hpp"
+#include "util/crypto.hpp"
+#include "util/error.hpp"
 #include "util/title_util.hpp"
 
 namespace tin::util
@@ -50,4 +56,88 @@ namespace tin::util
 
         return nx::ncm::ContentMeta(cnmtBuf.GetData(), cnmtBuf.GetSize());
     }
+
+    nx::ncm::ContentMeta GetContentMetaFromNCAData(const u8* ncaData, size_t ncaSize)
+    {
+        if (ncaSize < sizeof(tin::install::NcaHeader))
+            THROW_FORMAT("Meta NCA is too small");
+
+        tin::install::NcaHeader header;
+        memcpy(&header, ncaData, sizeof(header));
+        Crypto::AesXtr headerCrypto = Crypto::GetHeaderDecryptor();
+        headerCrypto.decrypt(&header, &header, sizeof(header), 0, 0x200);
+
+        if (header.magic != MAGIC_NCA3)
+            THROW_FORMAT("Invalid NCA magic");
+        if (header.m_rightsId[0] != 0 || header.m_rightsId[1] != 0)
+            THROW_FORMAT("Meta NCA uses titlekey crypto");
+
+        // The cnmt lives in the PFS0 of section 0
+        const tin::install::NcaFsHeader& fsHeader = header.fs_headers[0];
+        const u64 sectionStart = static_cast<u64>(header.section_entries[0].media_start_offset) * 0x200;
+        const u64 sectionEnd = static_cast<u64>(header.section_entries[0].media_end_offset) * 0x200;
+
+        if (fsHeader.partition_type != 1 || fsHeader.fs_type != 2)
+            THROW_FORMAT("Meta NCA section 0 is not a PFS0");
+        if (sectionStart < sizeof(header) || sectionEnd <= sectionStart || sectionEnd > ncaSize)
+            THROW_FORMAT("Meta NCA section 0 is out of bounds");
+
+        std::vector<u8> section(ncaData + sectionStart, ncaData + sectionEnd);
+
+        if (fsHeader.crypt_type == 3)
+        {
+            u8 key[0x10];
+            const u8 keyGeneration = std::max(header.m_cryptoType, header.m_cryptoType2);
+            Crypto::DecryptNcaKeyAreaKey(header.m_kaekIndex, keyGeneration, header.m_keys + 0x20, key);
+
+            Crypto::Aes128Ctr sectionCrypto(key, Crypto::AesCtr(fsHeader.section_ctr));
+            sectionCrypto.seek(sectionStart);
+            sectionCrypto.decrypt(section.data(), section.data(), section.size());
+        }
+        else if (fsHeader.crypt_type != 1)
+        {
+            THROW_FORMAT("Unsupported meta NCA crypto type %u", fsHeader.crypt_type);
+        }
+
+        // HierarchicalSha256: master hash, block size, layer count, then the hash table and PFS0 regions
+        u64 pfs0Offset = 0;
+        u64 pfs0Size = 0;
+        memcpy(&pfs0Offset, fsHeader.superblock_data + 0x38, sizeof(pfs0Offset));
+        memcpy(&pfs0Size, fsHeader.superblock_data + 0x40, sizeof(pfs0Size));
+
+        if (pfs0Offset > section.size() || pfs0Size > section.size() - pfs0Offset || pfs0Size < sizeof(tin::install::PFS0BaseHeader))
+            THROW_FORMAT("Meta NCA PFS0 is out of bounds");
+
+        const u8* pfs0 = section.data() + pfs0Offset;
+        tin::install::PFS0BaseHeader pfs0Header;
+        memcpy(&pfs0Header, pfs0, sizeof(pfs0Header));
+
+        const u64 fileTableSize = static_cast<u64>(pfs0Header.numFiles) * sizeof(tin::install::PFS0FileEntry);
+        const u64 pfs0HeaderSize = sizeof(pfs0Header) + fileTableSize + pfs0Header.stringTableSize;
+        if (pfs0Header.magic != 0x30534650 || pfs0HeaderSize > pfs0Size)
+            THROW_FORMAT("Invalid meta NCA PFS0 header");
+
+        const char* stringTable = reinterpret_cast<const char*>(pfs0 + sizeof(pfs0Header) + fileTableSize);
+        for (u32 i = 0; i < pfs0Header.numFiles; i++)
+        {
+            tin::install::PFS0FileEntry entry;
+            memcpy(&entry, pfs0 + sizeof(pfs0Header) + i * sizeof(entry), sizeof(entry));
+            if (entry.stringTableOffset >= pfs0Header.stringTableSize)
+                continue;
+
+            const std::string name(stringTable + entry.stringTableOffset, strnlen(stringTable + entry.stringTableOffset, pfs0Header.stringTableSize - entry.stringTableOffset));
+            if (name.size() < 5 || name.compare(name.size() - 5, 5, ".cnmt") != 0)
+                continue;
+
+            if (entry.dataOffset > pfs0Size - pfs0HeaderSize || entry.fileSize > pfs0Size - pfs0HeaderSize - entry.dataOffset)
+                THROW_FORMAT("Meta NCA cnmt is out of bounds");
+
+            tin::data::ByteBuffer cnmtBuf;
+            cnmtBuf.Resize(entry.fileSize);
+            memcpy(cnmtBuf.GetData(), pfs0 + pfs0HeaderSize + entry.dataOffset, entry.fileSize);
+            return nx::ncm::ContentMeta(cnmtBuf.GetData(), cnmtBuf.GetSize());
+        }
+
+        THROW_FORMAT("Meta NCA has no cnmt file");
+    }
 }
\ No newline at end of file
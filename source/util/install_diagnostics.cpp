@@ -5,6 +5,7 @@
 #include <ctime>
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <mutex>
 #include <regex>
 #include <sstream>
@@ -105,6 +106,24 @@ namespace inst::diag {
         AppendLine("DEBUG", step);
     }
 
+    void NoteThroughput(const std::string& source, const std::string& item, std::uint64_t bytes, double seconds)
+    {
+        if (!IsVerboseEnabled())
+            return;
+
+        std::string format = "nca";
+        const std::size_t dot = item.find_last_of('.');
+        if (dot != std::string::npos && dot + 1 < item.size())
+            format = ToLower(item.substr(dot + 1));
+
+        const double mb = static_cast<double>(bytes) / (1024.0 * 1024.0);
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(2)
+             << "Throughput: source=" << source << " format=" << format << " item=" << item
+             << " size=" << mb << "MB time=" << seconds << "s rate=" << (seconds > 0.0 ? mb / seconds : 0.0) << "MB/s";
+        AppendLine("DEBUG", line.str());
+    }
+
     void RecordSuccess(const std::string& item)
     {
         AppendLine("INFO", "Install succeeded: " + item);
@@ -30,6 +30,12 @@ SOFTWARE.
 #include <cstring>
 #include <sstream>
 #include <limits>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
 #include "util/curl.hpp"
 #include "util/error.hpp"
 #include "util/hauth.hpp"
@@ -172,9 +178,17 @@ namespace tin::network
     struct StreamCallbackContext
     {
         std::function<size_t (u8* bytes, size_t size)>* streamFunc = nullptr;
+        const std::function<bool()>* abortFunc = nullptr;
         bool hadException = false;
     };
 
+    // Called by curl while the transfer is idle too, so an abort doesn't wait for the next body bytes
+    static int StreamAbortCallback(void* userData, curl_off_t, curl_off_t, curl_off_t, curl_off_t)
+    {
+        auto* ctx = reinterpret_cast<StreamCallbackContext*>(userData);
+        return ctx && ctx->abortFunc && (*ctx->abortFunc)() ? 1 : 0;
+    }
+
     static size_t ParseHTMLDataCallback(char* bytes, size_t size, size_t numItems, void* userData)
     {
         auto* ctx = reinterpret_cast<StreamCallbackContext*>(userData);
@@ -195,17 +209,138 @@ namespace tin::network
         }
     }
 
+    // Range requests reuse easy handles per host so each chunk can ride an existing
+    // keep-alive connection. All pooled handles share one DNS and TLS session cache.
+    // Every parallel range connection, each shop queue prefetch and one sequential reader
+    // may hand a handle back at once, so the idle cap follows those settings.
+    static size_t MaxIdleRangeHandlesPerHost()
+    {
+        return static_cast<size_t>(std::clamp(inst::config::httpRangeConnections, 1, 8)) +
+            static_cast<size_t>(std::clamp(inst::config::shopPrefetchDepth, 0, 4)) + 1;
+    }
+
+    static std::mutex g_rangePoolMutex;
+    static CURLSH* g_rangeShare = nullptr;
+    static std::map<std::string, std::vector<CURL*>> g_idleRangeHandles;
+    static std::map<std::string, std::shared_ptr<curl_slist>> g_rangeHeaderLists;
+    static std::mutex g_rangeShareLocks[CURL_LOCK_DATA_LAST];
+
+    static void RangeShareLock(CURL*, curl_lock_data data, curl_lock_access, void*)
+    {
+        g_rangeShareLocks[data].lock();
+    }
+
+    static void RangeShareUnlock(CURL*, curl_lock_data data, void*)
+    {
+        g_rangeShareLocks[data].unlock();
+    }
+
+    static std::string GetRangeHostKey(const std::string& url)
+    {
+        const size_t schemeEnd = url.find("://");
+        const size_t hostStart = schemeEnd == std::string::npos ? 0 : schemeEnd + 3;
+        const size_t hostEnd = url.find_first_of("/?", hostStart);
+        std::string key = url.substr(0, hostEnd);
+        std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+        return key;
+    }
+
+    static CURL* AcquireRangeHandle(const std::string& hostKey)
+    {
+        std::lock_guard<std::mutex> lock(g_rangePoolMutex);
+        auto it = g_idleRangeHandles.find(hostKey);
+        if (it != g_idleRangeHandles.end() && !it->second.empty()) {
+            CURL* curl = it->second.back();
+            it->second.pop_back();
+            curl_easy_reset(curl); // Keeps the live connection and the share
+            return curl;
+        }
+
+        if (!g_rangeShare) {
+            g_rangeShare = curl_share_init();
+            if (g_rangeShare) {
+                curl_share_setopt(g_rangeShare, CURLSHOPT_LOCKFUNC, &RangeShareLock);
+                curl_share_setopt(g_rangeShare, CURLSHOPT_UNLOCKFUNC, &RangeShareUnlock);
+                curl_share_setopt(g_rangeShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+                curl_share_setopt(g_rangeShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            }
+        }
+
+        CURL* curl = curl_easy_init();
+        if (curl && g_rangeShare)
+            curl_easy_setopt(curl, CURLOPT_SHARE, g_rangeShare);
+        return curl;
+    }
+
+    static void ReleaseRangeHandle(const std::string& hostKey, CURL* curl)
+    {
+        std::lock_guard<std::mutex> lock(g_rangePoolMutex);
+        auto& idle = g_idleRangeHandles[hostKey];
+        if (idle.size() >= MaxIdleRangeHandlesPerHost()) {
+            curl_easy_cleanup(curl);
+            return;
+        }
+        idle.push_back(curl);
+    }
+
+    // The custom shop headers only depend on the URL and the session's credentials,
+    // so they are built once per URL and reused for every chunk
+    static std::shared_ptr<curl_slist> GetRangeHeaderList(const std::string& requestUrl)
+    {
+        std::lock_guard<std::mutex> lock(g_rangePoolMutex);
+        auto it = g_rangeHeaderLists.find(requestUrl);
+        if (it != g_rangeHeaderLists.end())
+            return it->second;
+
+        struct curl_slist* headerList = nullptr;
+        std::string versionValue;
+        std::string revisionValue;
+        BuildVersionAndRevision(versionValue, revisionValue);
+        const std::string themeHeader = "Theme: 0000000000000000000000000000000000000000000000000000000000000000";
+        const std::string uidHeader = "UID: " + inst::util::ComputeUidFromMmcCid();
+        const std::string versionHeader = "Version: " + versionValue;
+        const std::string revisionHeader = "Revision: " + revisionValue;
+        const std::string languageHeader = "Language: " + Language::GetShopHeaderLanguage();
+        const std::string hauthHeader = "HAUTH: " + inst::util::ComputeHauthFromUrl(requestUrl);
+        const std::string uauthHeader = "UAUTH: " + inst::util::ComputeUauthFromUrl(
+            requestUrl,
+            g_basic_auth_set ? g_basic_auth_user : "",
+            g_basic_auth_set ? g_basic_auth_pass : "");
+        headerList = curl_slist_append(headerList, themeHeader.c_str());
+        headerList = curl_slist_append(headerList, languageHeader.c_str());
+        headerList = curl_slist_append(headerList, hauthHeader.c_str());
+        headerList = curl_slist_append(headerList, uidHeader.c_str());
+        headerList = curl_slist_append(headerList, versionHeader.c_str());
+        headerList = curl_slist_append(headerList, revisionHeader.c_str());
+        headerList = curl_slist_append(headerList, uauthHeader.c_str());
+
+        std::shared_ptr<curl_slist> cached(headerList, [](curl_slist* list) {
+            if (list)
+                curl_slist_free_all(list);
+        });
+        g_rangeHeaderLists[requestUrl] = cached;
+        return cached;
+    }
+
+    static void DropRangeHeaderLists()
+    {
+        std::lock_guard<std::mutex> lock(g_rangePoolMutex);
+        g_rangeHeaderLists.clear();
+    }
+
     static int StreamHttpRangeForUrl(const std::string& url, size_t offset, size_t size,
-        const std::function<size_t (u8* bytes, size_t size)>& streamFunc)
+        const std::function<size_t (u8* bytes, size_t size)>& streamFunc, const std::function<bool()>& abortFunc)
     {
         if (size == 0)
             return 0;
 
         const std::string requestUrl = TrimCopy(StripUrlFragment(url));
+        const std::string hostKey = GetRangeHostKey(requestUrl);
         auto writeDataFunc = streamFunc;
         StreamCallbackContext callbackCtx;
         callbackCtx.streamFunc = &writeDataFunc;
-        CURL* curl = curl_easy_init();
+        callbackCtx.abortFunc = &abortFunc;
+        CURL* curl = AcquireRangeHandle(hostKey);
         if (!curl)
             THROW_FORMAT("Failed to initialize curl\n");
 
@@ -221,41 +356,23 @@ namespace tin::network
         curl_easy_setopt(curl, CURLOPT_RANGE, range.c_str());
         curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
         curl_easy_setopt(curl, CURLOPT_MAXREDIRS, 8L);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
         curl_easy_setopt(curl, CURLOPT_WRITEDATA, &callbackCtx);
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &ParseHTMLDataCallback);
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+        curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, &StreamAbortCallback);
+        curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &callbackCtx);
         std::string authValue;
         ApplyBasicAuth(curl, authValue);
 
-        struct curl_slist* headerList = nullptr;
-        std::string versionValue;
-        std::string revisionValue;
-        BuildVersionAndRevision(versionValue, revisionValue);
-        const std::string themeHeader = "Theme: 0000000000000000000000000000000000000000000000000000000000000000";
-        const std::string uidHeader = "UID: " + inst::util::ComputeUidFromMmcCid();
-        const std::string versionHeader = "Version: " + versionValue;
-        const std::string revisionHeader = "Revision: " + revisionValue;
-        const std::string languageHeader = "Language: " + Language::GetShopHeaderLanguage();
-        const std::string hauthHeader = "HAUTH: " + inst::util::ComputeHauthFromUrl(requestUrl);
-        const std::string uauthHeader = "UAUTH: " + inst::util::ComputeUauthFromUrl(
-            requestUrl,
-            g_basic_auth_set ? g_basic_auth_user : "",
-            g_basic_auth_set ? g_basic_auth_pass : "");
-        headerList = curl_slist_append(headerList, themeHeader.c_str());
-        headerList = curl_slist_append(headerList, languageHeader.c_str());
-        headerList = curl_slist_append(headerList, hauthHeader.c_str());
-        headerList = curl_slist_append(headerList, uidHeader.c_str());
-        headerList = curl_slist_append(headerList, versionHeader.c_str());
-        headerList = curl_slist_append(headerList, revisionHeader.c_str());
-        headerList = curl_slist_append(headerList, uauthHeader.c_str());
+        const std::shared_ptr<curl_slist> headerList = GetRangeHeaderList(requestUrl);
         if (headerList)
-            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headerList);
+            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headerList.get());
 
         const CURLcode rc = curl_easy_perform(curl);
         u64 httpCode = 0;
         curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
-        if (headerList)
-            curl_slist_free_all(headerList);
-        curl_easy_cleanup(curl);
+        ReleaseRangeHandle(hostKey, curl);
 
         if (callbackCtx.hadException)
             return 1999;
@@ -436,6 +553,11 @@ namespace tin::network
         }
     }
 
+    void HTTPDownload::SetAbortFlag(const std::atomic<bool>* abortFlag)
+    {
+        m_abortFlag = abortFlag;
+    }
+
     void HTTPDownload::BufferDataRange(void* buffer, size_t offset, size_t size, std::function<void (size_t sizeRead)> progressFunc)
     {
         size_t sizeRead = 0;
@@ -473,12 +595,19 @@ namespace tin::network
 
         static constexpr int kMaxRetries = 3;
         static constexpr u64 kRetryDelayNs = 2000000000ULL;
+        static constexpr u64 kAbortPollNs = 100000000ULL;
+
+        const std::function<bool()> aborted = [this]() {
+            return m_abortFlag != nullptr && m_abortFlag->load(std::memory_order_relaxed);
+        };
 
         auto streamWithRetry = [&](const std::string& url, size_t requestOffset, size_t requestSize) -> int
         {
             size_t bytesReceived = 0;
 
             auto trackingFunc = [&](u8* buf, size_t sz) -> size_t {
+                if (aborted())
+                    return 0; // Surfaces as a fatal write error
                 size_t written = streamFunc(buf, sz);
                 bytesReceived += written;
                 return written;
@@ -492,7 +621,13 @@ namespace tin::network
                     {
                         LOG_DEBUG("StreamDataRange: retry %d/%d, resuming at offset %zu+%zu\n",
                             attempt, kMaxRetries, requestOffset, bytesReceived);
-                        svcSleepThread(kRetryDelayNs);
+                        for (u64 slept = 0; slept < kRetryDelayNs && !aborted(); slept += kAbortPollNs)
+                            svcSleepThread(kAbortPollNs);
+                    }
+                    if (aborted())
+                    {
+                        LOG_DEBUG("StreamDataRange: aborted (url=%s)\n", url.c_str());
+                        return 1;
                     }
 
                     const size_t currentOffset = requestOffset + bytesReceived;
@@ -501,7 +636,7 @@ namespace tin::network
                     if (remaining == 0)
                         return 0;
 
-                    const int rc = StreamHttpRangeForUrl(url, currentOffset, remaining, trackingFunc);
+                    const int rc = StreamHttpRangeForUrl(url, currentOffset, remaining, trackingFunc, aborted);
                     if (rc == 0)
                         return 0;
 
@@ -511,7 +646,8 @@ namespace tin::network
                         rc == 403 ||
                         rc == 404 ||
                         rc == 416 ||
-                        rc == 1000 + CURLE_WRITE_ERROR;
+                        rc == 1000 + CURLE_WRITE_ERROR ||
+                        rc == 1000 + CURLE_ABORTED_BY_CALLBACK;
 
                     if (fatal)
                     {
@@ -525,7 +661,7 @@ namespace tin::network
                 }
 
                 LOG_DEBUG("StreamDataRange: auto-retries exhausted for %s\n", url.c_str());
-                if (retryConfirmFunc && retryConfirmFunc())
+                if (!aborted() && retryConfirmFunc && retryConfirmFunc())
                 {
                     LOG_DEBUG("StreamDataRange: user requested another retry cycle for %s\n", url.c_str());
                     continue;
@@ -584,11 +720,158 @@ namespace tin::network
         return 0;
     }
 
+    int HTTPDownload::StreamDataRangeParallel(size_t offset, size_t size, u32 connectionCount, std::function<size_t (u8* bytes, size_t size)> streamFunc, std::function<bool()> retryConfirmFunc)
+    {
+        static constexpr size_t kPartSize = 0x400000; // 4MB
+        static constexpr size_t kMinParallelSize = 0x1000000; // 16MB
+
+        if (connectionCount <= 1 || size < kMinParallelSize)
+            return this->StreamDataRange(offset, size, streamFunc, retryConfirmFunc);
+
+        const size_t partCount = (size + kPartSize - 1) / kPartSize;
+        // Parts fetched ahead of the one being handed to streamFunc
+        const size_t window = static_cast<size_t>(connectionCount) * 2;
+
+        std::mutex mutex;
+        std::condition_variable partReady;
+        std::condition_variable windowOpen;
+        std::map<size_t, std::vector<u8>> fetchedParts;
+        size_t nextPartToFetch = 0;
+        size_t nextPartToEmit = 0;
+        std::atomic<bool> failed{false};
+        std::exception_ptr workerError;
+
+        // Only one connection at a time may ask the user whether to keep retrying
+        std::mutex retryConfirmMutex;
+        std::function<bool()> serializedRetryConfirm = nullptr;
+        if (retryConfirmFunc) {
+            serializedRetryConfirm = [&]() -> bool {
+                std::lock_guard<std::mutex> guard(retryConfirmMutex);
+                return !failed.load() && retryConfirmFunc();
+            };
+        }
+
+        auto fetchParts = [&]() {
+            while (true)
+            {
+                size_t partIdx = 0;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    windowOpen.wait(lock, [&]() {
+                        return failed.load() || nextPartToFetch >= partCount || nextPartToFetch < nextPartToEmit + window;
+                    });
+                    if (failed.load() || nextPartToFetch >= partCount)
+                        return;
+                    partIdx = nextPartToFetch++;
+                }
+
+                const size_t partOffset = partIdx * kPartSize;
+                const size_t partSize = std::min(kPartSize, size - partOffset);
+                std::vector<u8> data;
+                data.reserve(partSize);
+
+                auto collectFunc = [&](u8* bytes, size_t sz) -> size_t {
+                    if (failed.load() || data.size() + sz > partSize)
+                        return 0;
+                    data.insert(data.end(), bytes, bytes + sz);
+                    return sz;
+                };
+
+                // Each connection gets the usual per-request retry and fatal-code handling. An exception
+                // must not escape the worker thread, so it is handed to the consumer instead.
+                int rc = 0;
+                try {
+                    rc = this->StreamDataRange(offset + partOffset, partSize, collectFunc, serializedRetryConfirm);
+                } catch (std::exception& e) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    LOG_DEBUG("StreamDataRangeParallel: part %zu threw: %s\n", partIdx, e.what());
+                    if (!workerError)
+                        workerError = std::current_exception();
+                    failed.store(true);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    LOG_DEBUG("StreamDataRangeParallel: part %zu threw an unknown exception\n", partIdx);
+                    if (!workerError)
+                        workerError = std::current_exception();
+                    failed.store(true);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (rc != 0 || data.size() != partSize) {
+                        LOG_DEBUG("StreamDataRangeParallel: part %zu failed (rc=%d)\n", partIdx, rc);
+                        failed.store(true);
+                    } else {
+                        fetchedParts.emplace(partIdx, std::move(data));
+                    }
+                }
+                partReady.notify_all();
+                if (failed.load()) {
+                    windowOpen.notify_all();
+                    return;
+                }
+            }
+        };
+
+        const size_t workerCount = std::min<size_t>(connectionCount, partCount);
+        std::vector<std::thread> workers;
+        workers.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; i++)
+            workers.emplace_back(fetchParts);
+
+        auto stopWorkers = [&](bool abort) {
+            if (abort) {
+                std::lock_guard<std::mutex> lock(mutex);
+                failed.store(true);
+            }
+            windowOpen.notify_all();
+            for (auto& worker : workers) {
+                if (worker.joinable())
+                    worker.join();
+            }
+        };
+
+        int rc = 0;
+        try {
+            for (size_t partIdx = 0; partIdx < partCount; partIdx++)
+            {
+                std::vector<u8> data;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    partReady.wait(lock, [&]() { return failed.load() || fetchedParts.count(partIdx) != 0; });
+                    auto it = fetchedParts.find(partIdx);
+                    if (it == fetchedParts.end()) {
+                        rc = 1;
+                        break;
+                    }
+                    data = std::move(it->second);
+                    fetchedParts.erase(it);
+                    nextPartToEmit = partIdx + 1;
+                }
+                windowOpen.notify_all();
+
+                if (streamFunc(data.data(), data.size()) != data.size()) {
+                    rc = 1;
+                    break;
+                }
+            }
+        } catch (...) {
+            stopWorkers(true);
+            throw;
+        }
+
+        stopWorkers(rc != 0);
+        // Surface worker exceptions the same way the single-connection path would
+        if (workerError)
+            std::rethrow_exception(workerError);
+        return rc;
+    }
+
     void SetBasicAuth(const std::string& user, const std::string& pass)
     {
         g_basic_auth_user = user;
         g_basic_auth_pass = pass;
         g_basic_auth_set = true;
+        DropRangeHeaderLists(); // UAUTH depends on the credentials
     }
 
     void ClearBasicAuth()
@@ -596,6 +879,21 @@ namespace tin::network
         g_basic_auth_user.clear();
         g_basic_auth_pass.clear();
         g_basic_auth_set = false;
+        DropRangeHeaderLists();
+    }
+
+    void CloseHttpRangeSession()
+    {
+        std::lock_guard<std::mutex> lock(g_rangePoolMutex);
+        for (auto& entry : g_idleRangeHandles) {
+            for (CURL* curl : entry.second)
+                curl_easy_cleanup(curl);
+        }
+        g_idleRangeHandles.clear();
+        g_rangeHeaderLists.clear();
+
+        if (g_rangeShare && curl_share_cleanup(g_rangeShare) == CURLSHE_OK)
+            g_rangeShare = nullptr;
     }
 
     size_t WaitReceiveNetworkData(int sockfd, void* buf, size_t len)
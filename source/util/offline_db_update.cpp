@@ -36,6 +36,12 @@ namespace inst::offline::dbupdate
             ManifestFile iconsPack;
         };
 
+        struct ResumePart {
+            std::uint64_t start = 0;
+            std::uint64_t endInclusive = 0;
+            std::uint64_t done = 0;
+        };
+
         struct ReplaceState {
             std::string target;
             std::string tempPath;
@@ -53,6 +59,12 @@ namespace inst::offline::dbupdate
         constexpr const char* kOfflineDbTracePath = "sdmc:/switch/CyberFoil/offline_db_update.log";
         constexpr std::uint64_t kParallelDownloadMinSize = 16ULL * 1024ULL * 1024ULL;
         constexpr std::size_t kParallelDownloadParts = 4;
+        constexpr std::uint64_t kHashStepBytes = 4ULL * 1024ULL * 1024ULL;
+        // The resume sidecar is rewritten every few MB while downloading, not only once curl returns, so
+        // a crash or power-off still leaves a resumable file. Offsets are recorded this far behind what
+        // curl delivered, which covers the 1MB stdio buffer of the download file that may not be on disk yet.
+        constexpr std::uint64_t kResumeStateIntervalBytes = 8ULL * 1024ULL * 1024ULL;
+        constexpr std::uint64_t kResumeStateSlackBytes = 1ULL * 1024ULL * 1024ULL;
 
         void OfflineDbTrace(const char* fmt, ...)
         {
@@ -393,42 +405,131 @@ namespace inst::offline::dbupdate
             return false;
         }
 
-        bool ComputeFileSha256(const std::string& path, std::string& outHexHash, std::uint64_t& outSize,
-            const std::function<void(std::uint64_t read, std::uint64_t total)>& progress = {})
+        std::string ResumeStatePath(const std::string& tempPath)
         {
-            std::ifstream in(path, std::ios::binary);
+            return tempPath + ".resume";
+        }
+
+        void DiscardPartialDownload(const std::string& tempPath)
+        {
+            RemoveIfExists(tempPath);
+            RemoveIfExists(ResumeStatePath(tempPath));
+        }
+
+        std::vector<ResumePart> PlanDownloadParts(std::uint64_t size)
+        {
+            std::vector<ResumePart> parts;
+            if (size < kParallelDownloadMinSize) {
+                parts.push_back(ResumePart{0, size - 1, 0});
+                return parts;
+            }
+
+            const std::size_t partCount = std::min<std::size_t>(kParallelDownloadParts,
+                std::max<std::size_t>(2, static_cast<std::size_t>((size + kParallelDownloadMinSize - 1) / kParallelDownloadMinSize)));
+            const std::uint64_t partSize = (size + partCount - 1) / partCount;
+            for (std::size_t i = 0; i < partCount; i++) {
+                const std::uint64_t start = static_cast<std::uint64_t>(i) * partSize;
+                const std::uint64_t endInclusive = std::min<std::uint64_t>(size - 1, start + partSize - 1);
+                parts.push_back(ResumePart{start, endInclusive, 0});
+            }
+            return parts;
+        }
+
+        bool LoadResumeState(const ManifestFile& file, const std::string& tempPath, std::vector<ResumePart>& outParts)
+        {
+            std::ifstream in(ResumeStatePath(tempPath), std::ios::binary);
             if (!in)
                 return false;
 
-            std::uint64_t totalSize = 0;
-            std::error_code sizeEc;
-            totalSize = std::filesystem::file_size(path, sizeEc);
-            if (sizeEc)
-                totalSize = 0;
+            nlohmann::json root;
+            try {
+                in >> root;
+            } catch (...) {
+                return false;
+            }
 
-            Sha256Context ctx;
-            sha256ContextCreate(&ctx);
-            std::vector<char> buffer(256 * 1024);
-            if (buffer.empty())
+            if (!root.is_object() || !root.contains("parts") || !root["parts"].is_array())
                 return false;
-            outSize = 0;
-
-            while (true) {
-                in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
-                const std::streamsize got = in.gcount();
-                if (got > 0) {
-                    sha256ContextUpdate(&ctx, buffer.data(), static_cast<std::size_t>(got));
-                    outSize += static_cast<std::uint64_t>(got);
-                    if (progress)
-                        progress(outSize, totalSize);
-                }
-                if (!in)
-                    break;
+            if (!root.contains("url") || !root["url"].is_string() || root["url"].get<std::string>() != file.url)
+                return false;
+            if (!root.contains("sha256") || !root["sha256"].is_string() || root["sha256"].get<std::string>() != file.sha256)
+                return false;
+            std::uint64_t size = 0;
+            if (!root.contains("size") || !TryGetU64(root["size"], size) || size != file.size)
+                return false;
+
+            std::error_code ec;
+            const std::uint64_t tempSize = std::filesystem::file_size(tempPath, ec);
+            if (ec)
+                return false;
+
+            std::vector<ResumePart> parts;
+            std::uint64_t expectedStart = 0;
+            for (const auto& row : root["parts"]) {
+                ResumePart part;
+                if (!row.is_array() || row.size() != 3 ||
+                    !TryGetU64(row[0], part.start) || !TryGetU64(row[1], part.endInclusive) || !TryGetU64(row[2], part.done))
+                    return false;
+                if (part.start != expectedStart || part.endInclusive < part.start || part.endInclusive >= file.size)
+                    return false;
+                if (part.done > (part.endInclusive - part.start) + 1 || part.start + part.done > tempSize)
+                    return false;
+                expectedStart = part.endInclusive + 1;
+                parts.push_back(part);
             }
+            if (parts.empty() || expectedStart != file.size)
+                return false;
+            if (parts.size() > 1 && tempSize != file.size)
+                return false;
+
+            outParts = std::move(parts);
+            return true;
+        }
 
-            if (!in.eof())
+        void SaveResumeState(const ManifestFile& file, const std::string& tempPath, const std::vector<ResumePart>& parts)
+        {
+            nlohmann::json rows = nlohmann::json::array();
+            for (const auto& part : parts)
+                rows.push_back(nlohmann::json::array({part.start, part.endInclusive, part.done}));
+
+            nlohmann::json root;
+            root["url"] = file.url;
+            root["size"] = file.size;
+            root["sha256"] = file.sha256;
+            root["parts"] = std::move(rows);
+
+            std::ofstream out(ResumeStatePath(tempPath), std::ios::binary | std::ios::trunc);
+            if (out)
+                out << root.dump();
+        }
+
+        bool HashFileRange(const std::string& path, Sha256Context& ctx, std::uint64_t from, std::uint64_t to)
+        {
+            if (to <= from)
+                return true;
+
+            std::ifstream in(path, std::ios::binary);
+            if (!in)
+                return false;
+            in.seekg(static_cast<std::streamoff>(from), std::ios::beg);
+            if (!in)
                 return false;
 
+            std::vector<char> buffer(256 * 1024);
+            std::uint64_t remaining = to - from;
+            while (remaining > 0) {
+                const std::size_t chunk = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, buffer.size()));
+                in.read(buffer.data(), static_cast<std::streamsize>(chunk));
+                if (static_cast<std::size_t>(in.gcount()) != chunk)
+                    return false;
+                sha256ContextUpdate(&ctx, buffer.data(), chunk);
+                remaining -= chunk;
+            }
+            return true;
+        }
+
+        std::string FinishSha256Hex(Sha256Context& ctx)
+        {
             std::array<std::uint8_t, SHA256_HASH_SIZE> hash{};
             sha256ContextGetHash(&ctx, hash.data());
             std::ostringstream hex;
@@ -436,8 +537,7 @@ namespace inst::offline::dbupdate
             hex << std::hex;
             for (std::uint8_t b : hash)
                 hex << std::setw(2) << static_cast<int>(b);
-            outHexHash = ToLower(hex.str());
-            return true;
+            return ToLower(hex.str());
         }
 
         bool DownloadAndVerify(const ManifestFile& file, const std::string& tempPath, std::string& error,
@@ -535,23 +635,77 @@ namespace inst::offline::dbupdate
                 file.sha256.c_str());
             LOG_DEBUG("Offline DB download start: %s\n", file.url.c_str());
             try {
-                RemoveIfExists(tempPath);
-                auto singleStreamDownload = [&]() -> bool {
-                    RemoveIfExists(tempPath);
-                    if (!inst::curl::downloadFileWithProgress(file.url, tempPath.c_str(), 0,
-                            [&](std::uint64_t downloaded, std::uint64_t total) {
-                                reportDownloadProgress(downloaded, total, false);
-                            })) {
-                        RemoveIfExists(tempPath);
-                        error = "Download failed: " + file.url;
-                        OfflineDbTrace("DownloadAndVerify fail: download error url='%s'", file.url.c_str());
+                std::vector<ResumePart> plan;
+                const bool resumed = LoadResumeState(file, tempPath, plan);
+                if (resumed) {
+                    OfflineDbTrace("DownloadAndVerify resuming temp='%s' parts=%llu",
+                        tempPath.c_str(), static_cast<unsigned long long>(plan.size()));
+                    LOG_DEBUG("Offline DB download resuming: %s\n", file.url.c_str());
+                } else {
+                    DiscardPartialDownload(tempPath);
+                    plan = PlanDownloadParts(file.size);
+                }
+
+                // The hash covers [0, hashedBytes) of the temp file. Bytes that arrive in file order are hashed
+                // straight from the curl write callback; only data written ahead of that point is read back.
+                Sha256Context hashCtx;
+                sha256ContextCreate(&hashCtx);
+                std::uint64_t hashedBytes = 0;
+
+                auto singleStreamDownload = [&](std::uint64_t resumeOffset) -> bool {
+                    if (hashedBytes > resumeOffset) {
+                        sha256ContextCreate(&hashCtx);
+                        hashedBytes = 0;
+                    }
+                    if (HashFileRange(tempPath, hashCtx, hashedBytes, resumeOffset)) {
+                        hashedBytes = resumeOffset;
+                    } else {
+                        sha256ContextCreate(&hashCtx);
+                        hashedBytes = 0;
+                        resumeOffset = 0;
+                    }
+
+                    std::uint64_t written = resumeOffset;
+                    std::uint64_t savedAt = resumeOffset;
+                    const bool ok = inst::curl::downloadFileResumable(file.url, tempPath.c_str(), resumeOffset, 0,
+                        [&](std::uint64_t downloaded, std::uint64_t /*total*/) {
+                            reportDownloadProgress(resumeOffset + downloaded, file.size, false);
+                        },
+                        [&](const void* data, std::size_t size) {
+                            sha256ContextUpdate(&hashCtx, data, size);
+                            written += size;
+                            if (written - savedAt >= kResumeStateIntervalBytes && written > kResumeStateSlackBytes) {
+                                SaveResumeState(file, tempPath, {ResumePart{0, file.size - 1, std::min(written - kResumeStateSlackBytes, file.size)}});
+                                savedAt = written;
+                            }
+                        });
+                    hashedBytes = written;
+                    SaveResumeState(file, tempPath, {ResumePart{0, file.size - 1, std::min(written, file.size)}});
+                    if (!ok) {
+                        error = "Download interrupted: " + file.url;
+                        OfflineDbTrace("DownloadAndVerify fail: download error url='%s' resume_offset=%llu written=%llu",
+                            file.url.c_str(),
+                            static_cast<unsigned long long>(resumeOffset),
+                            static_cast<unsigned long long>(written));
                         LOG_DEBUG("Offline DB download failed: %s\n", file.url.c_str());
                         return false;
                     }
                     return true;
                 };
-                const bool useParallelDownload = file.size >= kParallelDownloadMinSize;
-                if (useParallelDownload) {
+
+                auto singleStreamWithRestart = [&](std::uint64_t resumeOffset) -> bool {
+                    if (resumeOffset >= file.size)
+                        return true;
+                    if (singleStreamDownload(resumeOffset))
+                        return true;
+                    // A server that ignores range requests fails the resume before writing anything.
+                    if (resumeOffset == 0 || hashedBytes != resumeOffset)
+                        return false;
+                    OfflineDbTrace("DownloadAndVerify resume rejected, restarting url='%s'", file.url.c_str());
+                    return singleStreamDownload(0);
+                };
+
+                if (plan.size() > 1) {
                     struct PartState {
                         std::uint64_t start = 0;
                         std::uint64_t endInclusive = 0;
@@ -560,58 +714,73 @@ namespace inst::offline::dbupdate
                         bool success = false;
                     };
 
-                    const std::size_t partCount = std::min<std::size_t>(kParallelDownloadParts,
-                        std::max<std::size_t>(2, static_cast<std::size_t>((file.size + kParallelDownloadMinSize - 1) / kParallelDownloadMinSize)));
-                    const std::uint64_t partSize = (file.size + partCount - 1) / partCount;
+                    const std::size_t partCount = plan.size();
                     std::vector<PartState> parts(partCount);
                     std::vector<std::thread> workers;
-                    std::mutex failureMutex;
                     bool failed = false;
 
                     OfflineDbTrace("DownloadAndVerify using parallel download parts=%llu size=%llu",
                         static_cast<unsigned long long>(partCount),
                         static_cast<unsigned long long>(file.size));
 
-                    {
-                        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
-                        if (!out) {
+                    if (!resumed) {
+                        {
+                            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+                            if (!out) {
+                                error = "Failed to prepare download file.";
+                                OfflineDbTrace("DownloadAndVerify fail: failed to create temp output '%s'", tempPath.c_str());
+                                return false;
+                            }
+                        }
+                        std::error_code resizeEc;
+                        std::filesystem::resize_file(tempPath, file.size, resizeEc);
+                        if (resizeEc) {
+                            DiscardPartialDownload(tempPath);
                             error = "Failed to prepare download file.";
-                            OfflineDbTrace("DownloadAndVerify fail: failed to create temp output '%s'", tempPath.c_str());
+                            OfflineDbTrace("DownloadAndVerify fail: resize_file failed temp='%s' ec=%d", tempPath.c_str(), resizeEc.value());
                             return false;
                         }
                     }
-                    std::error_code resizeEc;
-                    std::filesystem::resize_file(tempPath, file.size, resizeEc);
-                    if (resizeEc) {
-                        RemoveIfExists(tempPath);
-                        error = "Failed to prepare download file.";
-                        OfflineDbTrace("DownloadAndVerify fail: resize_file failed temp='%s' ec=%d", tempPath.c_str(), resizeEc.value());
+
+                    // Part 0 extends the hashed prefix from its write callback; later parts are read back in
+                    // order as soon as everything before them has been hashed.
+                    if (!HashFileRange(tempPath, hashCtx, 0, plan[0].done)) {
+                        DiscardPartialDownload(tempPath);
+                        error = "Failed to read partial download.";
+                        OfflineDbTrace("DownloadAndVerify fail: failed to hash resumed prefix temp='%s'", tempPath.c_str());
                         return false;
                     }
+                    hashedBytes = plan[0].done;
 
                     for (std::size_t i = 0; i < partCount; i++) {
-                        const std::uint64_t start = static_cast<std::uint64_t>(i) * partSize;
-                        const std::uint64_t endInclusive = std::min<std::uint64_t>(file.size - 1, start + partSize - 1);
-                        parts[i].start = start;
-                        parts[i].endInclusive = endInclusive;
+                        parts[i].start = plan[i].start;
+                        parts[i].endInclusive = plan[i].endInclusive;
+                        parts[i].downloaded.store(plan[i].done, std::memory_order_relaxed);
+                        if (plan[i].done == (plan[i].endInclusive - plan[i].start) + 1) {
+                            parts[i].success = true;
+                            parts[i].done.store(true, std::memory_order_release);
+                            continue;
+                        }
 
                         workers.emplace_back([&, i]() {
+                            const std::uint64_t resumeAt = parts[i].start + parts[i].downloaded.load(std::memory_order_relaxed);
                             const bool ok = inst::curl::downloadFileRangeToOffsetWithProgress(file.url, tempPath.c_str(),
-                                parts[i].start, parts[i].start, parts[i].endInclusive, 0,
-                                [&](std::uint64_t downloaded, std::uint64_t /*total*/) {
-                                    parts[i].downloaded.store(downloaded, std::memory_order_relaxed);
+                                resumeAt, resumeAt, parts[i].endInclusive, 0, {},
+                                [&, i](const void* data, std::size_t size) {
+                                    if (i == 0)
+                                        sha256ContextUpdate(&hashCtx, data, size);
+                                    parts[i].downloaded.fetch_add(size, std::memory_order_relaxed);
                                 });
                             parts[i].success = ok;
-                            if (!ok) {
-                                std::lock_guard<std::mutex> guard(failureMutex);
-                                failed = true;
-                            } else {
-                                parts[i].downloaded.store((parts[i].endInclusive - parts[i].start) + 1, std::memory_order_relaxed);
-                            }
                             parts[i].done.store(true, std::memory_order_release);
                         });
                     }
 
+                    std::size_t nextHashPart = 0;
+                    bool hashReadFailed = false;
+                    std::uint64_t savedDownloaded = 0;
+                    for (const auto& part : plan)
+                        savedDownloaded += part.done;
                     while (true) {
                         std::uint64_t totalDownloaded = 0;
                         bool allDone = true;
@@ -625,7 +794,42 @@ namespace inst::offline::dbupdate
                         if (allDone)
                             break;
 
-                        svcSleepThread(100'000'000ULL);
+                        if (totalDownloaded - savedDownloaded >= kResumeStateIntervalBytes) {
+                            std::vector<ResumePart> snapshot = plan;
+                            for (std::size_t i = 0; i < partCount; i++) {
+                                const std::uint64_t partBytes = (plan[i].endInclusive - plan[i].start) + 1;
+                                const std::uint64_t downloaded = parts[i].downloaded.load(std::memory_order_relaxed);
+                                // Finished parts were flushed when curl closed the file
+                                if (parts[i].done.load(std::memory_order_acquire) && parts[i].success)
+                                    snapshot[i].done = std::min(downloaded, partBytes);
+                                else if (downloaded > plan[i].done + kResumeStateSlackBytes)
+                                    snapshot[i].done = std::min(downloaded - kResumeStateSlackBytes, partBytes);
+                            }
+                            SaveResumeState(file, tempPath, snapshot);
+                            savedDownloaded = totalDownloaded;
+                        }
+
+                        bool hashedStep = false;
+                        if (!hashReadFailed && nextHashPart < partCount &&
+                            parts[nextHashPart].done.load(std::memory_order_acquire) && parts[nextHashPart].success) {
+                            const std::uint64_t partEnd = parts[nextHashPart].endInclusive + 1;
+                            if (nextHashPart == 0) {
+                                hashedBytes = partEnd;
+                            } else {
+                                const std::uint64_t stepEnd = std::min(partEnd, hashedBytes + kHashStepBytes);
+                                if (HashFileRange(tempPath, hashCtx, hashedBytes, stepEnd)) {
+                                    hashedBytes = stepEnd;
+                                    hashedStep = true;
+                                } else {
+                                    hashReadFailed = true;
+                                }
+                            }
+                            if (hashedBytes == partEnd)
+                                nextHashPart++;
+                        }
+
+                        if (!hashedStep)
+                            svcSleepThread(100'000'000ULL);
                     }
 
                     for (auto& worker : workers) {
@@ -633,66 +837,41 @@ namespace inst::offline::dbupdate
                             worker.join();
                     }
 
+                    for (std::size_t i = 0; i < partCount; i++) {
+                        const std::uint64_t partBytes = (plan[i].endInclusive - plan[i].start) + 1;
+                        plan[i].done = std::min(parts[i].downloaded.load(std::memory_order_relaxed), partBytes);
+                        if (!parts[i].success)
+                            failed = true;
+                    }
+                    if (nextHashPart == 0)
+                        hashedBytes = plan[0].done;
+                    SaveResumeState(file, tempPath, plan);
+
                     if (failed) {
-                        RemoveIfExists(tempPath);
-                        OfflineDbTrace("DownloadAndVerify parallel path failed, falling back to single-stream url='%s'", file.url.c_str());
+                        std::uint64_t frontier = 0;
+                        for (const auto& part : plan) {
+                            frontier += part.done;
+                            if (part.done != (part.endInclusive - part.start) + 1)
+                                break;
+                        }
+                        OfflineDbTrace("DownloadAndVerify parallel path failed, resuming single-stream at %llu url='%s'",
+                            static_cast<unsigned long long>(frontier), file.url.c_str());
                         LOG_DEBUG("Offline DB parallel download failed, retrying single-stream: %s\n", file.url.c_str());
-                        if (!singleStreamDownload())
+                        if (!singleStreamWithRestart(frontier))
                             return false;
                     }
-                } else if (!singleStreamDownload()) {
+                } else if (!singleStreamWithRestart(plan[0].done)) {
                     return false;
                 }
 
-                reportDownloadProgress(lastTotal ? lastTotal : file.size, lastTotal ? lastTotal : file.size, true);
+                reportDownloadProgress(file.size, file.size, true);
                 if (progress)
                     progress(stageLabel + " (verifying...)", verifyStart);
 
-                OfflineDbTrace("DownloadAndVerify download complete, starting hash temp='%s'", tempPath.c_str());
-                std::uint64_t actualSize = 0;
-                std::string actualSha;
-                u64 lastVerifyReportTick = 0;
-                double lastVerifyPercent = -1.0;
-                if (!ComputeFileSha256(tempPath, actualSha, actualSize,
-                        [&](std::uint64_t read, std::uint64_t total) {
-                            if (!progress)
-                                return;
-
-                            std::uint64_t effectiveTotal = total == 0 ? file.size : total;
-                            if (effectiveTotal == 0)
-                                effectiveTotal = 1;
-                            const std::uint64_t boundedRead = std::min(read, effectiveTotal);
-                            double ratio = static_cast<double>(boundedRead) / static_cast<double>(effectiveTotal);
-                            if (ratio < 0.0)
-                                ratio = 0.0;
-                            if (ratio > 1.0)
-                                ratio = 1.0;
-
-                            const double mappedPercent = verifyStart + ((clampedEnd - verifyStart) * ratio);
-                            const u64 nowTick = armGetSystemTick();
-                            const bool enoughTime = (lastVerifyReportTick == 0) || (tickFreq > 0 && (nowTick - lastVerifyReportTick) >= (tickFreq / 5));
-                            const bool enoughProgress = (lastVerifyPercent < 0.0) || (mappedPercent >= lastVerifyPercent + 0.5);
-                            if (!enoughTime && !enoughProgress)
-                                return;
-
-                            std::ostringstream status;
-                            status << stageLabel << " (verifying " << static_cast<int>(mappedPercent + 0.5) << "%)";
-                            progress(status.str(), mappedPercent);
-                            lastVerifyReportTick = nowTick;
-                            lastVerifyPercent = mappedPercent;
-                        })) {
-                    RemoveIfExists(tempPath);
-                    error = "Failed to verify downloaded file hash.";
-                    OfflineDbTrace("DownloadAndVerify fail: failed to hash temp='%s'", tempPath.c_str());
-                    LOG_DEBUG("Offline DB hash verify failed to read temp file: %s\n", tempPath.c_str());
-                    return false;
-                }
-
-                if (progress)
-                    progress(stageLabel + " (verified)", clampedEnd);
-
-                if (actualSize != file.size) {
-                    RemoveIfExists(tempPath);
+                std::error_code sizeEc;
+                const std::uint64_t actualSize = std::filesystem::file_size(tempPath, sizeEc);
+                if (sizeEc || actualSize != file.size) {
+                    DiscardPartialDownload(tempPath);
                     error = "Downloaded file size mismatch.";
                     OfflineDbTrace("DownloadAndVerify fail: size mismatch expected=%llu actual=%llu",
                         static_cast<unsigned long long>(file.size),
@@ -703,8 +882,22 @@ namespace inst::offline::dbupdate
                     return false;
                 }
 
+                OfflineDbTrace("DownloadAndVerify download complete, hashing remaining %llu bytes temp='%s'",
+                    static_cast<unsigned long long>(file.size - std::min(hashedBytes, file.size)), tempPath.c_str());
+                if (hashedBytes > file.size || !HashFileRange(tempPath, hashCtx, hashedBytes, file.size)) {
+                    DiscardPartialDownload(tempPath);
+                    error = "Failed to verify downloaded file hash.";
+                    OfflineDbTrace("DownloadAndVerify fail: failed to hash temp='%s'", tempPath.c_str());
+                    LOG_DEBUG("Offline DB hash verify failed to read temp file: %s\n", tempPath.c_str());
+                    return false;
+                }
+                const std::string actualSha = FinishSha256Hex(hashCtx);
+
+                if (progress)
+                    progress(stageLabel + " (verified)", clampedEnd);
+
                 if (actualSha != file.sha256) {
-                    RemoveIfExists(tempPath);
+                    DiscardPartialDownload(tempPath);
                     error = "Downloaded file sha256 mismatch.";
                     OfflineDbTrace("DownloadAndVerify fail: sha mismatch expected=%s actual=%s",
                         file.sha256.c_str(),
@@ -721,12 +914,12 @@ namespace inst::offline::dbupdate
                     file.url.c_str(), static_cast<unsigned long long>(actualSize));
                 return true;
             } catch (const std::exception& e) {
-                RemoveIfExists(tempPath);
+                DiscardPartialDownload(tempPath);
                 error = "Download verification threw exception.";
                 OfflineDbTrace("DownloadAndVerify exception: %s", e.what());
                 return false;
             } catch (...) {
-                RemoveIfExists(tempPath);
+                DiscardPartialDownload(tempPath);
                 error = "Download verification threw unknown exception.";
                 OfflineDbTrace("DownloadAndVerify exception: unknown");
                 return false;
@@ -774,12 +967,14 @@ namespace inst::offline::dbupdate
                 std::filesystem::rename(state.backupPath, state.target, ec);
             }
             RemoveIfExists(state.tempPath);
+            RemoveIfExists(ResumeStatePath(state.tempPath));
         }
 
         void CleanupReplace(const ReplaceState& state)
         {
             RemoveIfExists(state.backupPath);
             RemoveIfExists(state.tempPath);
+            RemoveIfExists(ResumeStatePath(state.tempPath));
         }
 
         void ReportProgress(const ProgressCallback& cb, const std::string& stage, double percent)
@@ -901,7 +1096,7 @@ namespace inst::offline::dbupdate
         OfflineDbTrace("ApplyUpdate progress: downloading icons.pack");
         if (!DownloadAndVerify(manifest.iconsPack, iconsTemp, result.error, progress,
                 "Downloading icons.pack", 45.0, 70.0)) {
-            RemoveIfExists(titlesTemp);
+            // Keep the verified titles.pack download; the next attempt resumes it without refetching.
             OfflineDbTrace("ApplyUpdate fail: icons.pack %s", result.error.c_str());
             return result;
         }
@@ -92,6 +92,10 @@ namespace inst::offline
         };
 
         std::unordered_map<std::uint64_t, TitleMetadata> g_metadataById;
+        std::vector<char> g_titlePackData;
+        std::vector<std::uint32_t> g_titlePackOrder;
+        std::uint32_t g_titlePackEntryCount = 0;
+        std::size_t g_titlePackStringsOffset = 0;
         bool g_metadataAttempted = false;
         bool g_metadataAvailable = false;
 
@@ -325,14 +329,14 @@ namespace inst::offline
             return !(out.name.empty() && out.publisher.empty() && !out.hasSize && !out.hasVersion && !out.hasReleaseDate && !out.hasIsDemo);
         }
 
-        std::string ReadPackedString(const std::vector<char>& blob, std::uint32_t offset)
+        std::string ReadPackedString(const char* strings, std::size_t stringsSize, std::uint32_t offset)
         {
             if (offset == 0)
                 return std::string();
-            if (offset >= blob.size())
+            if (offset >= stringsSize)
                 return std::string();
-            const char* start = blob.data() + offset;
-            const std::size_t remaining = blob.size() - offset;
+            const char* start = strings + offset;
+            const std::size_t remaining = stringsSize - offset;
             const void* endPtr = std::memchr(start, '\0', remaining);
             if (endPtr == nullptr)
                 return std::string();
@@ -340,6 +344,89 @@ namespace inst::offline
             return std::string(start, len);
         }
 
+        TitlePackEntryRecord GetPackedEntry(std::uint32_t index)
+        {
+            TitlePackEntryRecord rec = {};
+            std::memcpy(&rec, g_titlePackData.data() + sizeof(TitlePackHeader) + static_cast<std::size_t>(index) * kTitlePackEntrySize, sizeof(rec));
+            return rec;
+        }
+
+        std::uint64_t GetPackedEntryTitleId(std::uint32_t index)
+        {
+            std::uint64_t titleId = 0;
+            std::memcpy(&titleId, g_titlePackData.data() + sizeof(TitlePackHeader) + static_cast<std::size_t>(index) * kTitlePackEntrySize, sizeof(titleId));
+            return titleId;
+        }
+
+        bool TryMaterializePackedMetadata(const TitlePackEntryRecord& rec, TitleMetadata& out)
+        {
+            const char* strings = g_titlePackData.data() + g_titlePackStringsOffset;
+            const std::size_t stringsSize = g_titlePackData.size() - g_titlePackStringsOffset;
+            TitleMetadata meta;
+
+            if (rec.flags & kTitleFlagHasName)
+                meta.name = ReadPackedString(strings, stringsSize, rec.nameOffset);
+            if (rec.flags & kTitleFlagHasPublisher)
+                meta.publisher = ReadPackedString(strings, stringsSize, rec.publisherOffset);
+            if (rec.flags & kTitleFlagHasIntro)
+                meta.intro = ReadPackedString(strings, stringsSize, rec.introOffset);
+            if (rec.flags & kTitleFlagHasDescription)
+                meta.description = ReadPackedString(strings, stringsSize, rec.descriptionOffset);
+            if (rec.flags & kTitleFlagHasSize) {
+                meta.size = rec.size;
+                meta.hasSize = true;
+            }
+            if (rec.flags & kTitleFlagHasVersion) {
+                meta.version = rec.version;
+                meta.hasVersion = true;
+            }
+            if (rec.flags & kTitleFlagHasReleaseDate) {
+                meta.releaseDate = rec.releaseDate;
+                meta.hasReleaseDate = true;
+            }
+            if (rec.flags & kTitleFlagHasIsDemo) {
+                meta.isDemo = (rec.isDemo != 0);
+                meta.hasIsDemo = true;
+            }
+
+            if (meta.name.empty() && meta.publisher.empty() && meta.intro.empty() && meta.description.empty() &&
+                !meta.hasSize && !meta.hasVersion && !meta.hasReleaseDate && !meta.hasIsDemo) {
+                return false;
+            }
+            out = std::move(meta);
+            return true;
+        }
+
+        // Returns the metadata the old fully-expanded map held for titleId: when a pack lists a title
+        // id more than once, the last non-empty record in file order wins.
+        bool TryGetPackedMetadata(std::uint64_t titleId, TitleMetadata& out)
+        {
+            // Entries are looked up in place; only an index permutation is kept when the exporter
+            // did not write the table sorted by title id. The permutation is a stable sort, so
+            // records sharing a title id keep their file order.
+            auto indexAt = [](std::uint32_t pos) {
+                return g_titlePackOrder.empty() ? pos : g_titlePackOrder[pos];
+            };
+            std::uint32_t lo = 0;
+            std::uint32_t hi = g_titlePackEntryCount;
+            while (lo < hi) {
+                const std::uint32_t mid = lo + (hi - lo) / 2;
+                if (GetPackedEntryTitleId(indexAt(mid)) < titleId)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+
+            std::uint32_t end = lo;
+            while (end < g_titlePackEntryCount && GetPackedEntryTitleId(indexAt(end)) == titleId)
+                end++;
+            for (std::uint32_t pos = end; pos > lo; pos--) {
+                if (TryMaterializePackedMetadata(GetPackedEntry(indexAt(pos - 1)), out))
+                    return true;
+            }
+            return false;
+        }
+
         bool TryLoadMetadataFromPackedFile(const std::string& path)
         {
             std::error_code ec;
@@ -347,14 +434,15 @@ namespace inst::offline
             if (ec || fileSize < sizeof(TitlePackHeader))
                 return false;
 
-            std::ifstream in(path, std::ios::binary);
-            if (!in)
-                return false;
-
             TitlePackHeader header = {};
-            in.read(reinterpret_cast<char*>(&header), sizeof(header));
-            if (!in)
-                return false;
+            {
+                std::ifstream in(path, std::ios::binary);
+                if (!in)
+                    return false;
+                in.read(reinterpret_cast<char*>(&header), sizeof(header));
+                if (!in)
+                    return false;
+            }
 
             if (std::memcmp(header.magic, kTitlePackMagic.data(), kTitlePackMagic.size()) != 0)
                 return false;
@@ -373,61 +461,53 @@ namespace inst::offline
             if (stringsBytes > kMaxTitlePackStringsBytes)
                 return false;
 
-            std::vector<TitlePackEntryRecord> entries(header.entryCount);
-            in.read(reinterpret_cast<char*>(entries.data()), static_cast<std::streamsize>(tableBytes));
-            if (!in)
-                return false;
-
-            std::vector<char> stringBlob(static_cast<std::size_t>(stringsBytes));
-            if (!stringBlob.empty()) {
-                in.read(stringBlob.data(), static_cast<std::streamsize>(stringBlob.size()));
+            // Keep the pack as a single read-only buffer and materialize strings per lookup instead
+            // of copying every title into the metadata map up front.
+            std::vector<char> data(static_cast<std::size_t>(fileSize));
+            {
+                std::ifstream in(path, std::ios::binary);
                 if (!in)
                     return false;
+                in.read(data.data(), static_cast<std::streamsize>(data.size()));
+                if (static_cast<std::size_t>(in.gcount()) != data.size())
+                    return false;
             }
 
-            std::unordered_map<std::uint64_t, TitleMetadata> parsed;
-            parsed.reserve(entries.size());
-            for (const auto& rec : entries) {
-                TitleMetadata meta;
-
-                if (rec.flags & kTitleFlagHasName)
-                    meta.name = ReadPackedString(stringBlob, rec.nameOffset);
-                if (rec.flags & kTitleFlagHasPublisher)
-                    meta.publisher = ReadPackedString(stringBlob, rec.publisherOffset);
-                if (rec.flags & kTitleFlagHasIntro)
-                    meta.intro = ReadPackedString(stringBlob, rec.introOffset);
-                if (rec.flags & kTitleFlagHasDescription)
-                    meta.description = ReadPackedString(stringBlob, rec.descriptionOffset);
-                if (rec.flags & kTitleFlagHasSize) {
-                    meta.size = rec.size;
-                    meta.hasSize = true;
-                }
-                if (rec.flags & kTitleFlagHasVersion) {
-                    meta.version = rec.version;
-                    meta.hasVersion = true;
-                }
-                if (rec.flags & kTitleFlagHasReleaseDate) {
-                    meta.releaseDate = rec.releaseDate;
-                    meta.hasReleaseDate = true;
-                }
-                if (rec.flags & kTitleFlagHasIsDemo) {
-                    meta.isDemo = (rec.isDemo != 0);
-                    meta.hasIsDemo = true;
-                }
+            g_titlePackData = std::move(data);
+            g_titlePackEntryCount = header.entryCount;
+            g_titlePackStringsOffset = static_cast<std::size_t>(header.stringsOffset);
+            g_titlePackOrder.clear();
+
+            // A pack without a single usable record must not hide the JSON metadata
+            bool hasMetadata = false;
+            TitleMetadata probe;
+            for (std::uint32_t i = 0; i < header.entryCount && !hasMetadata; i++)
+                hasMetadata = TryMaterializePackedMetadata(GetPackedEntry(i), probe);
+            if (!hasMetadata) {
+                std::vector<char>().swap(g_titlePackData);
+                g_titlePackEntryCount = 0;
+                g_titlePackStringsOffset = 0;
+                return false;
+            }
 
-                if (meta.name.empty() && meta.publisher.empty() && meta.intro.empty() && meta.description.empty() &&
-                    !meta.hasSize && !meta.hasVersion && !meta.hasReleaseDate && !meta.hasIsDemo) {
-                    continue;
+            bool sorted = true;
+            for (std::uint32_t i = 1; i < header.entryCount; i++) {
+                if (GetPackedEntryTitleId(i - 1) > GetPackedEntryTitleId(i)) {
+                    sorted = false;
+                    break;
                 }
-                parsed[rec.titleId] = std::move(meta);
+            }
+            if (!sorted) {
+                g_titlePackOrder.resize(header.entryCount);
+                for (std::uint32_t i = 0; i < header.entryCount; i++)
+                    g_titlePackOrder[i] = i;
+                std::stable_sort(g_titlePackOrder.begin(), g_titlePackOrder.end(), [](std::uint32_t a, std::uint32_t b) {
+                    return GetPackedEntryTitleId(a) < GetPackedEntryTitleId(b);
+                });
             }
 
-            if (parsed.empty())
-                return false;
-
-            g_metadataById = std::move(parsed);
-            LOG_DEBUG("Offline DB: loaded %llu metadata entries from packed file %s\n",
-                static_cast<unsigned long long>(g_metadataById.size()), path.c_str());
+            LOG_DEBUG("Offline DB: mapped %u metadata entries from packed file %s (%s)\n",
+                header.entryCount, path.c_str(), sorted ? "sorted" : "indexed");
             return true;
         }
 
@@ -733,6 +813,10 @@ namespace inst::offline
     void Invalidate()
     {
         g_metadataById.clear();
+        std::vector<char>().swap(g_titlePackData);
+        std::vector<std::uint32_t>().swap(g_titlePackOrder);
+        g_titlePackEntryCount = 0;
+        g_titlePackStringsOffset = 0;
         g_metadataAttempted = false;
         g_metadataAvailable = false;
 
@@ -750,6 +834,9 @@ namespace inst::offline
     {
         if (!EnsureMetadataLoaded())
             return false;
+        if (g_titlePackEntryCount != 0) {
+            return TryGetPackedMetadata(baseTitleId, outMeta);
+        }
         const auto it = g_metadataById.find(baseTitleId);
         if (it == g_metadataById.end())
             return false;
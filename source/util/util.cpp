@@ -11,8 +11,12 @@
 #include "switch.h"
 #include "util/util.hpp"
 #include "nx/ipc/tin_ipc.h"
+#include "data/buffered_placeholder_writer.hpp"
+#include "nx/nca_writer.h"
 #include "util/config.hpp"
+#include "util/crypto.hpp"
 #include "util/curl.hpp"
+#include "util/network_util.hpp"
 #include "ui/MainApplication.hpp"
 #include "util/usb_comms_awoo.h"
 #include "util/json.hpp"
@@ -137,9 +141,13 @@ namespace inst::util {
     }
 
     void deinitInstallServices() {
+        tin::network::CloseHttpRangeSession();
+        NcaWriter::ReleaseDecompressionContexts();
+        tin::data::BufferedPlaceholderWriter::ReleaseSegmentMemory();
         ncmExit();
         nsextExit();
         esExit();
+        Crypto::InvalidateHeaderKey();
         splCryptoExit();
         splExit();
     }
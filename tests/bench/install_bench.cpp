@@ -0,0 +1,338 @@
+// Install throughput on the host: builds one title per package format, installs it from a
+// local file into the mock content storage and reports MB/s of NCA data registered.
+//
+//   host_bench [--size-mb N] [--runs N] [--write-mbps N] [--threads N] [format...]
+//
+// Formats: nsp, nsz, xcz, nczblock, plus http-range for per-request range latency over a
+// loopback server with and without the pooled connections, offline-pack for the load
+// time and resident memory of a 100k-title titles.pack, and shop-queue for the wall time of
+// a 50-item DLC shop queue with and without header prefetching, and shop-sections for the
+// time and peak memory of a 100k-item /api/shop/sections parse, streamed and as a DOM.
+// --write-mbps throttles placeholder writes like a slow SD card; --threads sets
+// nczDecompressThreads.
+
+#include "../host/fixtures.hpp"
+#include "../host/http_server.hpp"
+#include "../host/mock_ncm.hpp"
+
+#include "install/install_nsp.hpp"
+#include "install/install_xci.hpp"
+#include "install/sdmc_nsp.hpp"
+#include "install/sdmc_xci.hpp"
+#include "nx/nca_writer.h"
+#include "shopInstall.hpp"
+#include "util/config.hpp"
+#include "util/network_util.hpp"
+#include "util/offline_title_db.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <unistd.h>
+
+using namespace host::fixtures;
+
+namespace
+{
+    struct Format
+    {
+        const char* name;
+        bool xci;
+        bool compressed;
+        NczFormat nczFormat;
+    };
+
+    const Format kFormats[] = {
+        { "nsp", false, false, NczFormat::Stream },
+        { "nsz", false, true, NczFormat::Stream },
+        { "xcz", true, true, NczFormat::Block },
+        { "nczblock", false, true, NczFormat::Block },
+    };
+
+    double InstallOnce(const Format& format, const std::string& path)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        if (format.xci) {
+            auto xci = std::make_shared<tin::install::xci::SDMCXCI>(path);
+            tin::install::xci::XCIInstallTask task(NcmStorageId_SdCard, true, xci);
+            task.Prepare();
+            task.Begin();
+        }
+        else {
+            auto nsp = std::make_shared<tin::install::nsp::SDMCNSP>(path);
+            tin::install::nsp::NSPInstall task(NcmStorageId_SdCard, true, nsp);
+            task.Prepare();
+            task.Begin();
+        }
+        NcaWriter::ReleaseDecompressionContexts();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Average microseconds per 64KB range request; closing the session after every request
+    // makes each one pay for a new connection like the unpooled path did
+    double RangeLatencyUs(bool pooled)
+    {
+        const std::vector<u8> bytes = Filler(0x400000, 5);
+        const std::string blob(bytes.begin(), bytes.end());
+        host::http::Server server([&](const host::http::Request& request) { return host::http::ServeBytes(request, blob); });
+        tin::network::HTTPDownload download(server.Url("/title.nsp"));
+
+        constexpr size_t kChunk = 0x10000;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t offset = 0; offset < blob.size(); offset += kChunk) {
+            download.StreamDataRange(offset, kChunk, [](u8*, size_t sz) { return sz; });
+            if (!pooled)
+                tin::network::CloseHttpRangeSession();
+        }
+        tin::network::CloseHttpRangeSession();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return seconds * 1000000.0 / (blob.size() / kChunk);
+    }
+
+    // Seconds to install a queue of small DLC NSPs from a loopback shop
+    double ShopQueueSeconds(const std::string& ncmRoot, int prefetchDepth)
+    {
+        constexpr size_t kItems = 50;
+        std::map<std::string, std::string> packages;
+        for (size_t i = 0; i < kItems; i++) {
+            const Title dlc = MakeTitle({ .titleId = 0x0100000000011000 + i + 1, .type = NcmContentMetaType_AddOnContent, .seed = (u32)(300 + i) }, { 0x40000 });
+            const std::vector<u8> nsp = MakePfs0(TitleFiles(dlc, false));
+            packages["/dlc" + std::to_string(i) + ".nsp"] = std::string(nsp.begin(), nsp.end());
+        }
+        host::http::Server server([&](const host::http::Request& request) { return host::http::ServeBytes(request, packages.at(request.path)); });
+        std::vector<shopInstStuff::ShopItem> items(kItems);
+        for (size_t i = 0; i < kItems; i++) {
+            items[i].name = "dlc" + std::to_string(i) + ".nsp";
+            items[i].url = server.Url("/" + items[i].name);
+            items[i].size = packages.at("/" + items[i].name).size();
+        }
+
+        host::ncm::Reset(ncmRoot);
+        inst::config::shopPrefetchDepth = prefetchDepth;
+        const auto start = std::chrono::steady_clock::now();
+        shopInstStuff::installTitleShop(items, 0, "");
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        tin::network::CloseHttpRangeSession();
+        return seconds;
+    }
+
+    size_t ResidentBytes()
+    {
+        std::ifstream statm("/proc/self/statm");
+        size_t pages = 0, resident = 0;
+        statm >> pages >> resident;
+        return resident * (size_t)sysconf(_SC_PAGESIZE);
+    }
+
+    // Peak resident bytes since the last ResetPeakResident
+    size_t PeakResidentBytes()
+    {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.rfind("VmHWM:", 0) == 0)
+                return std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+        }
+        return 0;
+    }
+
+    void ResetPeakResident()
+    {
+        std::ofstream("/proc/self/clear_refs") << "5";
+    }
+
+    void BenchShopSections()
+    {
+        constexpr size_t kItems = 100000;
+        const char* ids[] = { "base", "updates", "dlc", "misc" };
+        std::string body = "{\"sections\":[";
+        for (size_t s = 0; s < 4; s++) {
+            body += std::string(s ? "," : "") + "{\"id\":\"" + ids[s] + "\",\"title\":\"" + ids[s] + "\",\"items\":[";
+            for (size_t i = s * kItems / 4; i < (s + 1) * kItems / 4; i++) {
+                char entry[384];
+                std::snprintf(entry, sizeof(entry),
+                    "%s{\"url\":\"/files/%zu.nsp#Item%%20%zu.nsp\",\"name\":\"Item %zu [01000000%08zX]\",\"size\":%zu,"
+                    "\"title_id\":\"01000000%08zX\",\"app_version\":%zu,\"icon_url\":\"/icons/%zu.jpg\"}",
+                    i % (kItems / 4) ? "," : "", i, i, i, i << 13, (i + 1) * 0x100000, i << 13, (i % 4) * 65536, i);
+                body += entry;
+            }
+            body += "]}";
+        }
+        body += "]}";
+        host::http::Server server([&](const host::http::Request&) {
+            host::http::Response response;
+            response.headers["Content-Type"] = "application/json";
+            response.body = body;
+            return response;
+        });
+
+        inst::config::shopCatalogCache = false;
+        std::string error;
+        size_t items = 0;
+        ResetPeakResident();
+        size_t before = PeakResidentBytes();
+        auto start = std::chrono::steady_clock::now();
+        {
+            const auto sections = shopInstStuff::FetchShopSections(server.Url(""), "", "", error);
+            for (const auto& section : sections)
+                items += section.items.size();
+        }
+        const double streamMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const size_t streamPeak = PeakResidentBytes() - before;
+
+        ResetPeakResident();
+        before = PeakResidentBytes();
+        start = std::chrono::steady_clock::now();
+        const size_t domItems = shopInstStuff::FetchShop(server.Url(""), "", "", error).size();
+        const double domMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const size_t domPeak = PeakResidentBytes() - before;
+
+        std::printf("shop-sections %zu items (%.1f MB): %.0f ms, %.1f MB peak streamed; %zu items %.0f ms, %.1f MB peak as a DOM\n",
+            items, body.size() / 1048576.0, streamMs, streamPeak / 1048576.0, domItems, domMs, domPeak / 1048576.0);
+    }
+
+    void BenchOfflinePack()
+    {
+        {
+            std::vector<std::pair<u64, inst::offline::TitleMetadata>> titles(100000);
+            for (u32 i = 0; i < titles.size(); i++) {
+                titles[i].first = 0x0100000000000000ULL | ((u64)(i + 1) << 13);
+                titles[i].second.name = "Title " + std::to_string(i);
+                titles[i].second.publisher = "Publisher " + std::to_string(i % 500);
+                titles[i].second.intro = "An intro line for title " + std::to_string(i);
+                titles[i].second.description = std::string(200, 'd');
+                titles[i].second.size = i;
+                titles[i].second.hasSize = true;
+            }
+            std::filesystem::create_directories(inst::offline::GetOfflineDbDir());
+            WriteFile(inst::offline::GetOfflineDbDir() + "/titles.pack", MakeTitlePack(titles));
+        }
+        inst::offline::Invalidate();
+
+        const size_t before = ResidentBytes();
+        const auto start = std::chrono::steady_clock::now();
+        inst::offline::TitleMetadata meta;
+        inst::offline::TryGetMetadata(0x0100000000000000ULL | (50000ULL << 13), meta);
+        const double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const size_t resident = ResidentBytes() - before;
+
+        const auto lookupStart = std::chrono::steady_clock::now();
+        for (u32 i = 0; i < 100000; i++)
+            inst::offline::TryGetMetadata(0x0100000000000000ULL | ((u64)(i + 1) << 13), meta);
+        const double lookupUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - lookupStart).count() / 100000;
+
+        std::printf("offline-pack 100k titles: %.1f ms load, %.1f MB resident, %.2f us/lookup\n",
+            loadMs, resident / 1048576.0, lookupUs);
+        inst::offline::Invalidate();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    u64 sizeMb = 64;
+    int runs = 3;
+    double writeMbps = 0.0;
+    int threads = -1;
+    std::vector<std::string> selected;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--size-mb") && i + 1 < argc)
+            sizeMb = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--runs") && i + 1 < argc)
+            runs = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--write-mbps") && i + 1 < argc)
+            writeMbps = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+            threads = std::atoi(argv[++i]);
+        else
+            selected.push_back(argv[i]);
+    }
+
+    char rootTemplate[] = "/tmp/cyberfoil-host-bench-XXXXXX";
+    if (mkdtemp(rootTemplate) == nullptr) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+    const std::filesystem::path root(rootTemplate);
+    std::filesystem::create_directories(root / "sdmc:/switch/CyberFoil");
+    if (chdir(root.c_str()) != 0)
+        return 1;
+
+    inst::config::parseConfig();
+    inst::config::validateNCAs = false;
+    if (threads > 0)
+        inst::config::nczDecompressThreads = threads;
+
+    auto isSelected = [&](const char* name) {
+        return selected.empty() || std::find(selected.begin(), selected.end(), name) != selected.end();
+    };
+    std::vector<const Format*> formats;
+    for (const Format& format : kFormats) {
+        if (isSelected(format.name))
+            formats.push_back(&format);
+    }
+
+    // One large program NCA plus the small control and data NCAs most titles carry
+    Title title;
+    u64 ncaBytes = 0;
+    if (!formats.empty()) {
+        const u64 total = sizeMb * 0x100000;
+        title = MakeTitle({}, { total - total / 16, total / 32, total / 32 });
+        ncaBytes = title.meta.data.size();
+        for (const Nca& nca : title.contents)
+            ncaBytes += nca.data.size();
+        std::printf("%-10s %10s %10s %10s\n", "format", "package", "best s", "MB/s");
+    }
+
+    int failures = 0;
+    for (const Format* format : formats) {
+        const auto files = TitleFiles(title, format->compressed, format->nczFormat);
+        const std::vector<u8> package = format->xci ? MakeXci(files) : MakePfs0(files);
+        const std::string path = std::string("title.") + format->name;
+        WriteFile(path, package);
+
+        double best = 0.0;
+        try {
+            for (int run = 0; run < runs; run++) {
+                host::ncm::Reset((root / "ncm").string());
+                if (writeMbps > 0.0)
+                    host::ncm::SetWriteThrottle(std::chrono::microseconds(0), writeMbps * 1000000.0);
+                const double seconds = InstallOnce(*format, path);
+                if (run == 0 || seconds < best)
+                    best = seconds;
+            }
+        }
+        catch (const std::exception& e) {
+            std::printf("%-10s failed: %s\n", format->name, e.what());
+            failures++;
+            continue;
+        }
+        std::printf("%-10s %9.1fM %10.3f %10.1f\n", format->name, package.size() / 1048576.0, best, ncaBytes / 1048576.0 / best);
+        std::filesystem::remove(path);
+    }
+
+    if (isSelected("http-range")) {
+        const double fresh = RangeLatencyUs(false);
+        const double pooled = RangeLatencyUs(true);
+        std::printf("http-range %.0f us/request with a new connection each, %.0f us/request pooled\n", fresh, pooled);
+    }
+
+    if (isSelected("offline-pack"))
+        BenchOfflinePack();
+
+    if (isSelected("shop-sections"))
+        BenchShopSections();
+
+    if (isSelected("shop-queue")) {
+        const double serial = ShopQueueSeconds((root / "ncm").string(), 0);
+        const double prefetched = ShopQueueSeconds((root / "ncm").string(), 2);
+        std::printf("shop-queue 50 DLC items: %.2f s serial, %.2f s with prefetch depth 2\n", serial, prefetched);
+    }
+
+    std::filesystem::remove_all(root);
+    return failures == 0 ? 0 : 1;
+}
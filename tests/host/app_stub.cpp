@@ -0,0 +1,84 @@
+// Host versions of the app helpers that live next to SDL/Plutonium code in
+// source/util/util.cpp and source/util/lang.cpp. Services and audio are no-ops; the string
+// helpers keep the app's behaviour since install and shop code depend on it.
+
+#include <switch.h>
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "util/crypto.hpp"
+#include "util/lang.hpp"
+#include "util/util.hpp"
+
+namespace Language {
+    // Keys are returned as-is so tests can match on them
+    std::string LanguageEntry(std::string key) {
+        return key;
+    }
+
+    std::string GetRandomMsg() {
+        return "";
+    }
+
+    std::string GetShopHeaderLanguage() {
+        return "en";
+    }
+}
+
+namespace inst::util {
+    void initInstallServices() {}
+
+    void deinitInstallServices() {
+        Crypto::InvalidateHeaderKey();
+    }
+
+    bool ignoreCaseCompare(const std::string &a, const std::string &b) {
+        const auto case_insensitive_less = [](char x, char y) {
+            return toupper(static_cast<unsigned char>(x)) < toupper(static_cast<unsigned char>(y));
+        };
+
+        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), case_insensitive_less);
+    }
+
+    std::string formatUrlString(std::string ourString) {
+        std::stringstream ourStream(ourString);
+        std::string segment;
+        std::vector<std::string> seglist;
+
+        while(std::getline(ourStream, segment, '/')) {
+            seglist.push_back(segment);
+        }
+
+        CURL *curl = curl_easy_init();
+        int outlength;
+        char* unescaped = curl_easy_unescape(curl, seglist[seglist.size() - 1].c_str(), seglist[seglist.size() - 1].length(), &outlength);
+        std::string finalString = unescaped;
+        curl_free(unescaped);
+        curl_easy_cleanup(curl);
+
+        return finalString;
+    }
+
+    std::string shortenString(std::string ourString, int ourLength, bool isFile) {
+        std::filesystem::path ourStringAsAPath = ourString;
+        std::string ourExtension = ourStringAsAPath.extension().string();
+        if (ourString.size() - ourExtension.size() > (unsigned long)ourLength) {
+            if(isFile) return (std::string)ourString.substr(0,ourLength) + "(...)" + ourExtension;
+            else return (std::string)ourString.substr(0,ourLength) + "...";
+        } else return ourString;
+    }
+
+    std::vector<uint32_t> setClockSpeed(int deviceToClock, uint32_t clockSpeed) {
+        // Callers index the { new, previous } pair the console returns
+        (void)deviceToClock; (void)clockSpeed;
+        return {0, 0};
+    }
+
+    void playAudio(std::string audioPath) {
+        (void)audioPath;
+    }
+}
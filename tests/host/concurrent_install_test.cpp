@@ -0,0 +1,137 @@
+// Install::Begin with several NCAs in flight: ncm must end up exactly as after a serial
+// install, the install page must only be driven from the calling thread, and a worker's
+// failure must surface there with nothing left registered.
+
+#include "test.hpp"
+
+#include "fixtures.hpp"
+#include "mock_ncm.hpp"
+#include "ui_stub.hpp"
+
+#include "install/install_nsp.hpp"
+#include "install/sdmc_nsp.hpp"
+#include "util/config.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace host::fixtures;
+
+namespace
+{
+    const std::vector<u64> kContentSizes = { 0x200000, 0x80000, 0x48000, 0x20000, 0x9000 };
+
+    struct StorageState
+    {
+        std::vector<std::pair<std::string, std::vector<u8>>> registered;
+        std::vector<std::vector<u8>> metaRecords;
+        size_t metaCommits = 0;
+        size_t applicationRecords = 0;
+    };
+
+    void InstallNsp(const std::string& path)
+    {
+        auto nsp = std::make_shared<tin::install::nsp::SDMCNSP>(path);
+        tin::install::nsp::NSPInstall task(NcmStorageId_SdCard, true, nsp);
+        task.Prepare();
+        task.Begin();
+    }
+
+    StorageState Snapshot()
+    {
+        StorageState state;
+        for (const NcmContentId& id : host::ncm::Registered(NcmStorageId_SdCard))
+            state.registered.emplace_back(IdString(id), host::ncm::ReadRegistered(NcmStorageId_SdCard, id));
+        std::sort(state.registered.begin(), state.registered.end());
+        for (const auto& record : host::ncm::MetaRecords())
+            state.metaRecords.push_back(record.data);
+        state.metaCommits = host::ncm::MetaCommitCount();
+        state.applicationRecords = host::ncm::ApplicationRecords().size();
+        return state;
+    }
+
+    StorageState InstallWith(int workers, const std::string& storageRoot)
+    {
+        host::ncm::Reset(storageRoot);
+        inst::config::concurrentNcaInstalls = workers;
+        InstallNsp("title.nsz");
+        return Snapshot();
+    }
+}
+
+TEST_CASE(concurrent_install_matches_serial_install)
+{
+    inst::config::validateNCAs = false;
+    const Title title = MakeTitle({}, kContentSizes);
+    WriteFile("title.nsz", MakePfs0(TitleFiles(title, true)));
+
+    const StorageState serial = InstallWith(1, "ncm-serial");
+    CHECK_EQ(host::ncm::PeakLivePlaceholderCount(), (size_t)1);
+    const StorageState concurrent = InstallWith(4, "ncm-concurrent");
+    CHECK(host::ncm::PeakLivePlaceholderCount() > 1);
+
+    CHECK_EQ(serial.registered.size(), kContentSizes.size() + 1);
+    CHECK(concurrent.registered == serial.registered);
+    CHECK(concurrent.metaRecords == serial.metaRecords);
+    // Meta records are still written in one batched commit
+    CHECK_EQ(concurrent.metaCommits, (size_t)1);
+    CHECK_EQ(concurrent.applicationRecords, serial.applicationRecords);
+    CHECK_EQ(host::ncm::LivePlaceholderCount(), (size_t)0);
+}
+
+TEST_CASE(concurrent_install_drives_progress_from_calling_thread)
+{
+    inst::config::validateNCAs = false;
+    inst::config::concurrentNcaInstalls = 4;
+    const Title title = MakeTitle({}, kContentSizes);
+    WriteFile("title.nsz", MakePfs0(TitleFiles(title, true)));
+
+    // Slow enough that the calling thread redraws the page several times
+    host::ncm::SetWriteThrottle(std::chrono::microseconds(2000), 8.0 * 1024 * 1024);
+    InstallNsp("title.nsz");
+
+    const std::thread::id mainThread = std::this_thread::get_id();
+    for (const auto& write : host::ncm::Writes())
+        CHECK(write.thread != mainThread);
+
+    size_t barUpdates = 0;
+    bool sawNcaCount = false;
+    for (const auto& event : host::ui::Events()) {
+        CHECK(event.thread == mainThread);
+        if (event.kind == host::ui::EventKind::BarPercent)
+            barUpdates++;
+        if (event.kind == host::ui::EventKind::DetailText && event.text.find("NCAs") != std::string::npos)
+            sawNcaCount = true;
+    }
+    CHECK(barUpdates >= 2);
+    CHECK(sawNcaCount);
+}
+
+TEST_CASE(concurrent_install_serializes_over_memory_budget)
+{
+    // Read-ahead alone exceeds the concurrent memory budget, so only one NCA may be in flight
+    inst::config::validateNCAs = false;
+    inst::config::concurrentNcaInstalls = 4;
+    inst::config::localReadAheadDepth = 8;
+    inst::config::localReadChunkMb = 16;
+    const Title title = MakeTitle({}, kContentSizes);
+    WriteFile("title.nsz", MakePfs0(TitleFiles(title, true)));
+
+    InstallNsp("title.nsz");
+    CHECK_EQ(host::ncm::PeakLivePlaceholderCount(), (size_t)1);
+    CHECK_EQ(host::ncm::Registered(NcmStorageId_SdCard).size(), kContentSizes.size() + 1);
+}
+
+TEST_CASE(concurrent_install_failure_rethrows_and_cleans_up)
+{
+    inst::config::validateNCAs = false;
+    inst::config::concurrentNcaInstalls = 4;
+    const Title title = MakeTitle({}, kContentSizes);
+    WriteFile("title.nsz", MakePfs0(TitleFiles(title, true)));
+
+    host::ncm::FailWritesAfter(6);
+    CHECK_THROWS(InstallNsp("title.nsz"));
+    CHECK_EQ(host::ncm::LivePlaceholderCount(), (size_t)0);
+    for (const Nca& nca : title.contents)
+        CHECK(!host::ncm::IsRegistered(NcmStorageId_SdCard, nca.id));
+}
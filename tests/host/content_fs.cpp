@@ -0,0 +1,227 @@
+// Host fs for the content meta file systems the install path opens on installed cnmt NCAs
+// (fsOpenFileSystemWithId with FsFileSystemType_ContentMeta). The NCA is read from the host
+// path the mock storage hands out, and the files of its section 0 PFS0 are served from
+// memory as a flat directory. Other file system types still report failure.
+
+#include <switch.h>
+
+#include "install/nca.hpp"
+#include "install/pfs0.hpp"
+#include "util/crypto.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using FileList = std::vector<std::pair<std::string, std::vector<u8>>>;
+
+    struct OpenFile
+    {
+        std::shared_ptr<const FileList> fileSystem;
+        size_t index;
+    };
+
+    std::mutex g_mutex;
+    std::map<u32, std::shared_ptr<const FileList>> g_fileSystems;
+    std::map<u32, OpenFile> g_files;
+    std::map<u32, std::shared_ptr<const FileList>> g_dirs;
+    u32 g_nextId = 1;
+
+    Result Fail(u32 error)
+    {
+        return MAKERESULT(Module_Libnx, error);
+    }
+
+    // Decrypts section 0 of a meta NCA and returns the files of the PFS0 inside it
+    bool ReadMetaPfs0(const std::vector<u8>& nca, FileList& out)
+    {
+        tin::install::NcaHeader header;
+        if (nca.size() < sizeof(header))
+            return false;
+        std::memcpy(&header, nca.data(), sizeof(header));
+        Crypto::AesXtr headerCrypto = Crypto::GetHeaderDecryptor();
+        headerCrypto.decrypt(&header, &header, sizeof(header), 0, 0x200);
+        if (header.magic != MAGIC_NCA3)
+            return false;
+
+        const tin::install::NcaFsHeader& fsHeader = header.fs_headers[0];
+        const u64 sectionStart = static_cast<u64>(header.section_entries[0].media_start_offset) * 0x200;
+        const u64 sectionEnd = static_cast<u64>(header.section_entries[0].media_end_offset) * 0x200;
+        if (fsHeader.partition_type != 1 || sectionEnd <= sectionStart || sectionEnd > nca.size())
+            return false;
+
+        std::vector<u8> section(nca.begin() + sectionStart, nca.begin() + sectionEnd);
+        if (fsHeader.crypt_type == 3) {
+            u8 key[0x10];
+            Crypto::DecryptNcaKeyAreaKey(header.m_kaekIndex, std::max(header.m_cryptoType, header.m_cryptoType2), header.m_keys + 0x20, key);
+            Crypto::Aes128Ctr sectionCrypto(key, Crypto::AesCtr(fsHeader.section_ctr));
+            sectionCrypto.seek(sectionStart);
+            sectionCrypto.decrypt(section.data(), section.data(), section.size());
+        }
+
+        u64 pfs0Offset = 0;
+        u64 pfs0Size = 0;
+        std::memcpy(&pfs0Offset, fsHeader.superblock_data + 0x38, sizeof(pfs0Offset));
+        std::memcpy(&pfs0Size, fsHeader.superblock_data + 0x40, sizeof(pfs0Size));
+        if (pfs0Offset > section.size() || pfs0Size > section.size() - pfs0Offset || pfs0Size < sizeof(tin::install::PFS0BaseHeader))
+            return false;
+
+        const u8* pfs0 = section.data() + pfs0Offset;
+        tin::install::PFS0BaseHeader pfs0Header;
+        std::memcpy(&pfs0Header, pfs0, sizeof(pfs0Header));
+        const u64 fileTableSize = static_cast<u64>(pfs0Header.numFiles) * sizeof(tin::install::PFS0FileEntry);
+        const u64 dataStart = sizeof(pfs0Header) + fileTableSize + pfs0Header.stringTableSize;
+        if (pfs0Header.magic != 0x30534650 || dataStart > pfs0Size)
+            return false;
+
+        const char* stringTable = reinterpret_cast<const char*>(pfs0 + sizeof(pfs0Header) + fileTableSize);
+        for (u32 i = 0; i < pfs0Header.numFiles; i++) {
+            tin::install::PFS0FileEntry entry;
+            std::memcpy(&entry, pfs0 + sizeof(pfs0Header) + i * sizeof(entry), sizeof(entry));
+            if (entry.stringTableOffset >= pfs0Header.stringTableSize || entry.dataOffset + entry.fileSize > pfs0Size - dataStart)
+                return false;
+            const u8* data = pfs0 + dataStart + entry.dataOffset;
+            out.emplace_back(std::string(stringTable + entry.stringTableOffset), std::vector<u8>(data, data + entry.fileSize));
+        }
+        return true;
+    }
+}
+
+extern "C"
+{
+    Result fsOpenFileSystemWithId(FsFileSystem* out, u64 id, FsFileSystemType fsType, const char* contentPath, FsContentAttributes attr)
+    {
+        (void)id; (void)attr;
+        if (fsType != FsFileSystemType_ContentMeta)
+            return Fail(LibnxError_NotInitialized);
+
+        std::ifstream in(contentPath, std::ios::binary);
+        if (!in)
+            return Fail(LibnxError_NotFound);
+        const std::vector<u8> nca((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        auto files = std::make_shared<FileList>();
+        if (!ReadMetaPfs0(nca, *files))
+            return Fail(LibnxError_IoError);
+
+        std::lock_guard<std::mutex> lock(g_mutex);
+        std::memset(out, 0, sizeof(*out));
+        out->s.object_id = g_nextId++;
+        g_fileSystems[out->s.object_id] = std::move(files);
+        return 0;
+    }
+
+    Result fsFsOpenFile(FsFileSystem* fs, const char* path, u32 mode, FsFile* out)
+    {
+        (void)mode;
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_fileSystems.find(fs->s.object_id);
+        if (it == g_fileSystems.end())
+            return Fail(LibnxError_NotFound);
+
+        // The PFS0 is flat, so only the last path component matters
+        std::string name = path;
+        name = name.substr(name.find_last_of('/') + 1);
+        for (size_t i = 0; i < it->second->size(); i++) {
+            if ((*it->second)[i].first != name)
+                continue;
+            std::memset(out, 0, sizeof(*out));
+            out->s.object_id = g_nextId++;
+            g_files[out->s.object_id] = { it->second, i };
+            return 0;
+        }
+        return Fail(LibnxError_NotFound);
+    }
+
+    Result fsFsOpenDirectory(FsFileSystem* fs, const char* path, u32 mode, FsDir* out)
+    {
+        (void)path; (void)mode;
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_fileSystems.find(fs->s.object_id);
+        if (it == g_fileSystems.end())
+            return Fail(LibnxError_NotFound);
+        std::memset(out, 0, sizeof(*out));
+        out->s.object_id = g_nextId++;
+        g_dirs[out->s.object_id] = it->second;
+        return 0;
+    }
+
+    void fsFsClose(FsFileSystem* fs)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_fileSystems.erase(fs->s.object_id);
+    }
+
+    Result fsFileRead(FsFile* f, s64 off, void* buf, u64 read_size, u32 option, u64* bytes_read)
+    {
+        (void)option;
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_files.find(f->s.object_id);
+        if (it == g_files.end() || off < 0)
+            return Fail(LibnxError_IoError);
+        const std::vector<u8>& data = (*it->second.fileSystem)[it->second.index].second;
+        const u64 start = std::min<u64>(static_cast<u64>(off), data.size());
+        const u64 size = std::min<u64>(read_size, data.size() - start);
+        std::memcpy(buf, data.data() + start, size);
+        *bytes_read = size;
+        return 0;
+    }
+
+    Result fsFileGetSize(FsFile* f, s64* out)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_files.find(f->s.object_id);
+        if (it == g_files.end())
+            return Fail(LibnxError_IoError);
+        *out = static_cast<s64>((*it->second.fileSystem)[it->second.index].second.size());
+        return 0;
+    }
+
+    void fsFileClose(FsFile* f)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_files.erase(f->s.object_id);
+    }
+
+    Result fsDirRead(FsDir* d, s64* total_entries, size_t max_entries, FsDirectoryEntry* buf)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_dirs.find(d->s.object_id);
+        if (it == g_dirs.end())
+            return Fail(LibnxError_IoError);
+        const size_t count = std::min(max_entries, it->second->size());
+        for (size_t i = 0; i < count; i++) {
+            std::memset(&buf[i], 0, sizeof(buf[i]));
+            std::strncpy(buf[i].name, (*it->second)[i].first.c_str(), sizeof(buf[i].name) - 1);
+            buf[i].type = FsDirEntryType_File;
+            buf[i].file_size = static_cast<s64>((*it->second)[i].second.size());
+        }
+        *total_entries = static_cast<s64>(count);
+        return 0;
+    }
+
+    Result fsDirGetEntryCount(FsDir* d, s64* count)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        auto it = g_dirs.find(d->s.object_id);
+        if (it == g_dirs.end())
+            return Fail(LibnxError_IoError);
+        *count = static_cast<s64>(it->second->size());
+        return 0;
+    }
+
+    void fsDirClose(FsDir* d)
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        g_dirs.erase(d->s.object_id);
+    }
+}
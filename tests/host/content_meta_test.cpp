@@ -0,0 +1,200 @@
+// ContentMeta parses a cnmt once and serializes install meta from the parsed form: the output
+// must keep the layout the record-by-record builder produced, and Begin must still install a
+// content shared by several metas only once.
+
+#include "test.hpp"
+
+#include "fixtures.hpp"
+#include "mock_ncm.hpp"
+
+#include "install/install_nsp.hpp"
+#include "install/sdmc_nsp.hpp"
+#include "nx/content_meta.hpp"
+#include "util/config.hpp"
+
+#include <cstring>
+
+using namespace host::fixtures;
+
+namespace
+{
+    struct CnmtSpec
+    {
+        NcmContentMetaType type = NcmContentMetaType_Application;
+        u32 contentCount = 3;
+        u32 extendedDataSize = 0;
+        bool withDeltaFragments = false;
+    };
+
+    NcmContentInfo Record(u32 index, u8 contentType)
+    {
+        NcmContentInfo info = {};
+        for (int i = 0; i < 0x10; i++)
+            info.content_id.c[i] = (u8)(index * 31 + i * 7 + 1);
+        ncmU64ToContentInfoSize(0x10000ull * (index + 1) + index, &info);
+        info.content_type = contentType;
+        info.id_offset = (u8)(index & 3);
+        return info;
+    }
+
+    std::vector<u8> MakeCnmt(const CnmtSpec& spec)
+    {
+        std::vector<u8> extendedHeader;
+        if (spec.type == NcmContentMetaType_Patch) {
+            NcmPatchMetaExtendedHeader ext = {};
+            ext.application_id = 0x0100000000010000;
+            ext.required_system_version = 0x0C000000;
+            ext.extended_data_size = spec.extendedDataSize;
+            extendedHeader.assign((const u8*)&ext, (const u8*)&ext + sizeof(ext));
+        }
+        else if (spec.type == NcmContentMetaType_AddOnContent) {
+            NcmAddOnContentMetaExtendedHeader ext = {};
+            ext.application_id = 0x0100000000010000;
+            ext.required_application_version = 0x10000;
+            extendedHeader.assign((const u8*)&ext, (const u8*)&ext + sizeof(ext));
+        }
+        else {
+            NcmApplicationMetaExtendedHeader ext = {};
+            ext.patch_id = 0x0100000000010800;
+            ext.required_system_version = 0x0C000000;
+            extendedHeader.assign((const u8*)&ext, (const u8*)&ext + sizeof(ext));
+        }
+
+        nx::ncm::PackagedContentMetaHeader header = {};
+        header.title_id = 0x0100000000010000;
+        header.version = 0x20000;
+        header.type = (u8)spec.type;
+        header.extended_header_size = (u16)extendedHeader.size();
+        header.content_count = (u16)spec.contentCount;
+        header.content_meta_count = 1;
+        header.attributes = 0x2;
+
+        std::vector<u8> cnmt((const u8*)&header, (const u8*)&header + sizeof(header));
+        cnmt.insert(cnmt.end(), extendedHeader.begin(), extendedHeader.end());
+        for (u32 i = 0; i < spec.contentCount; i++) {
+            // Every fourth record is a delta fragment when requested
+            const u8 type = spec.withDeltaFragments && i % 4 == 3 ? NcmContentType_DeltaFragment : (u8)(i % 6);
+            nx::ncm::PackagedContentInfo info = {};
+            std::memset(info.hash, (int)i, sizeof(info.hash));
+            info.content_info = Record(i, type);
+            cnmt.insert(cnmt.end(), (const u8*)&info, (const u8*)&info + sizeof(info));
+        }
+        const std::vector<u8> extendedData = Filler(spec.extendedDataSize, 5);
+        cnmt.insert(cnmt.end(), extendedData.begin(), extendedData.end());
+        return cnmt;
+    }
+
+    // Install meta built the way the record-by-record builder did it
+    std::vector<u8> ReferenceInstallMeta(const std::vector<u8>& cnmt, const NcmContentInfo& cnmtInfo, bool ignoreReqFirmVersion)
+    {
+        nx::ncm::PackagedContentMetaHeader packaged;
+        std::memcpy(&packaged, cnmt.data(), sizeof(packaged));
+        const u8* extendedHeader = cnmt.data() + sizeof(packaged);
+        const auto* records = (const nx::ncm::PackagedContentInfo*)(extendedHeader + packaged.extended_header_size);
+
+        std::vector<NcmContentInfo> infos;
+        for (u32 i = 0; i < packaged.content_count; i++) {
+            if (records[i].content_info.content_type <= 5)
+                infos.push_back(records[i].content_info);
+        }
+
+        NcmContentMetaHeader header = {};
+        header.extended_header_size = packaged.extended_header_size;
+        header.content_count = (u16)(infos.size() + 1);
+        header.content_meta_count = packaged.content_meta_count;
+        header.attributes = packaged.attributes;
+
+        std::vector<u8> out((const u8*)&header, (const u8*)&header + sizeof(header));
+        out.insert(out.end(), extendedHeader, extendedHeader + packaged.extended_header_size);
+        if (ignoreReqFirmVersion && (packaged.type == NcmContentMetaType_Application || packaged.type == NcmContentMetaType_Patch))
+            std::memset(out.data() + sizeof(header) + 8, 0, sizeof(u32));
+        out.insert(out.end(), (const u8*)&cnmtInfo, (const u8*)&cnmtInfo + sizeof(cnmtInfo));
+        for (const NcmContentInfo& info : infos)
+            out.insert(out.end(), (const u8*)&info, (const u8*)&info + sizeof(info));
+        if (packaged.type == NcmContentMetaType_Patch)
+            out.resize(out.size() + ((const NcmPatchMetaExtendedHeader*)extendedHeader)->extended_data_size);
+        return out;
+    }
+
+    void CheckInstallMeta(const CnmtSpec& spec)
+    {
+        std::vector<u8> cnmt = MakeCnmt(spec);
+        nx::ncm::ContentMeta meta(cnmt.data(), cnmt.size());
+        NcmContentInfo cnmtInfo = Record(9999, NcmContentType_Meta);
+
+        for (bool ignoreReqFirmVersion : { false, true }) {
+            tin::data::ByteBuffer buffer;
+            meta.GetInstallContentMeta(buffer, cnmtInfo, ignoreReqFirmVersion);
+            const std::vector<u8> actual(buffer.GetData(), buffer.GetData() + buffer.GetSize());
+            CHECK(actual == ReferenceInstallMeta(cnmt, cnmtInfo, ignoreReqFirmVersion));
+        }
+    }
+}
+
+TEST_CASE(content_meta_install_meta_matches_reference_layout)
+{
+    CheckInstallMeta({ NcmContentMetaType_Application, 3 });
+    CheckInstallMeta({ NcmContentMetaType_Application, 0 });
+    CheckInstallMeta({ NcmContentMetaType_Patch, 12, 0x4321, true });
+    CheckInstallMeta({ NcmContentMetaType_AddOnContent, 1 });
+    // Large DLC bundle
+    CheckInstallMeta({ NcmContentMetaType_AddOnContent, 4000, 0, true });
+}
+
+TEST_CASE(content_meta_parses_records_once)
+{
+    std::vector<u8> cnmt = MakeCnmt({ NcmContentMetaType_Patch, 8, 0x100, true });
+    nx::ncm::ContentMeta meta(cnmt.data(), cnmt.size());
+    // Changing the source afterwards must not affect the parsed meta
+    std::memset(cnmt.data(), 0xFF, cnmt.size());
+
+    const auto& infos = meta.GetContentInfos();
+    REQUIRE(infos.size() == 6);
+    const u32 expected[] = { 0, 1, 2, 4, 5, 6 };
+    for (size_t i = 0; i < infos.size(); i++) {
+        const NcmContentInfo record = Record(expected[i], (u8)(expected[i] % 6));
+        CHECK(std::memcmp(&infos[i], &record, sizeof(record)) == 0);
+    }
+    CHECK_EQ(meta.GetContentMetaKey().id, (u64)0x0100000000010000);
+    CHECK_EQ(meta.GetContentMetaKey().version, (u32)0x20000);
+    CHECK_EQ(meta.GetPackagedContentMetaHeader().content_count, (u16)8);
+}
+
+TEST_CASE(content_meta_rejects_truncated_records)
+{
+    std::vector<u8> cnmt = MakeCnmt({ NcmContentMetaType_Application, 4 });
+    cnmt.resize(cnmt.size() - 1);
+    CHECK_THROWS(nx::ncm::ContentMeta(cnmt.data(), cnmt.size()));
+    CHECK_THROWS(nx::ncm::ContentMeta(cnmt.data(), sizeof(nx::ncm::PackagedContentMetaHeader) - 1));
+}
+
+TEST_CASE(install_shared_content_is_written_once)
+{
+    inst::config::validateNCAs = false;
+    const Title app = MakeTitle({}, { 0x20000, 0x9000 });
+    // A DLC meta that lists the application's control NCA beside its own data NCA
+    NcaSpec dataSpec;
+    dataSpec.titleId = 0x0100000000011001;
+    dataSpec.contentType = NcmContentType_Data;
+    dataSpec.seed = 77;
+    const Nca data = MakeNca(dataSpec);
+    const Nca dlcMeta = MakeMetaNca({ .titleId = 0x0100000000011001, .type = NcmContentMetaType_AddOnContent, .seed = 300 },
+        { &app.contents[1], &data });
+
+    std::vector<PackageFile> files = TitleFiles(app, false);
+    files.push_back({ IdString(dlcMeta.id) + ".cnmt.nca", dlcMeta.data });
+    files.push_back({ IdString(data.id) + ".nca", data.data });
+    WriteFile("bundle.nsp", MakePfs0(files));
+
+    auto nsp = std::make_shared<tin::install::nsp::SDMCNSP>("bundle.nsp");
+    tin::install::nsp::NSPInstall task(NcmStorageId_SdCard, true, nsp);
+    task.Prepare();
+    task.Begin();
+
+    // Two metas plus three distinct contents
+    CHECK_EQ(host::ncm::CreatedPlaceholderCount(), (size_t)5);
+    CHECK_EQ(host::ncm::Registered(NcmStorageId_SdCard).size(), (size_t)5);
+    CHECK(host::ncm::ReadRegistered(NcmStorageId_SdCard, app.contents[1].id) == app.contents[1].data);
+    CHECK(host::ncm::ReadRegistered(NcmStorageId_SdCard, data.id) == data.data);
+    CHECK_EQ(host::ncm::MetaRecords().size(), (size_t)2);
+}
@@ -0,0 +1,437 @@
+#include "fixtures.hpp"
+
+#include "install/hfs0.hpp"
+#include "install/nca.hpp"
+#include "install/pfs0.hpp"
+#include "nx/content_meta.hpp"
+#include "util/crypto.hpp"
+#include "util/title_util.hpp"
+
+#include <zstd.h>
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace host::fixtures
+{
+    namespace
+    {
+        constexpr u64 kMediaUnit = 0x200;
+
+        struct Rng
+        {
+            u64 state;
+
+            explicit Rng(u32 seed) : state(0x9E3779B97F4A7C15ull ^ ((u64)seed * 0xBF58476D1CE4E5B9ull)) {}
+
+            u64 Next()
+            {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                return state;
+            }
+
+            void Fill(u8* out, size_t size)
+            {
+                for (size_t i = 0; i < size; i++)
+                    out[i] = (u8)(Next() >> 32);
+            }
+        };
+
+        u64 AlignUp(u64 value, u64 alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        NcmContentId IdFromData(const std::vector<u8>& data)
+        {
+            u8 hash[SHA256_HASH_SIZE];
+            sha256CalculateHash(hash, data.data(), data.size());
+            NcmContentId id;
+            std::memcpy(id.c, hash, sizeof(id.c));
+            return id;
+        }
+
+        // The NCZ counter holds the upper half of the CTR block in big-endian order
+        void CounterFromSectionCtr(u64 sectionCtr, u8* counter)
+        {
+            std::memset(counter, 0, 0x10);
+            for (int i = 0; i < 8; i++)
+                counter[i] = (u8)(sectionCtr >> (56 - 8 * i));
+        }
+
+        // Lays out sections after the 0x4000 header region and encrypts them in place
+        Nca BuildNca(tin::install::NcaHeader& header, const std::vector<u8>& sectionPlain, const std::vector<u64>& sectionSizes, u32 seed)
+        {
+            Rng rng(seed);
+            rng.Fill(header.m_keys, sizeof(header.m_keys));
+            u8 key[0x10];
+            Crypto::DecryptNcaKeyAreaKey(header.m_kaekIndex, std::max(header.m_cryptoType, header.m_cryptoType2), header.m_keys + 0x20, key);
+
+            Nca nca;
+            nca.contentType = (NcmContentType)header.content_type;
+            nca.plain.resize(NCA_HEADER_SIZE + sectionPlain.size());
+            std::memcpy(nca.plain.data() + NCA_HEADER_SIZE, sectionPlain.data(), sectionPlain.size());
+            nca.data = nca.plain;
+
+            u64 offset = NCA_HEADER_SIZE;
+            for (size_t i = 0; i < sectionSizes.size(); i++) {
+                const u64 size = sectionSizes[i];
+                header.section_entries[i].media_start_offset = (u32)(offset / kMediaUnit);
+                header.section_entries[i].media_end_offset = (u32)((offset + size) / kMediaUnit);
+
+                NczSection section = {};
+                section.offset = offset;
+                section.size = size;
+                section.cryptoType = header.fs_headers[i].crypt_type;
+                if (section.cryptoType == 3) {
+                    std::memcpy(section.key, key, sizeof(key));
+                    CounterFromSectionCtr(header.fs_headers[i].section_ctr, section.counter);
+
+                    Crypto::Aes128Ctr ctr(key, Crypto::AesCtr(header.fs_headers[i].section_ctr));
+                    ctr.seek(offset);
+                    ctr.encrypt(nca.data.data() + offset, nca.data.data() + offset, size);
+                }
+                nca.sections.push_back(section);
+                offset += size;
+            }
+
+            header.magic = MAGIC_NCA3;
+            header.nca_size = nca.data.size();
+
+            Crypto::AesXtr encryptor = Crypto::GetHeaderEncryptor();
+            encryptor.encrypt(nca.data.data(), &header, sizeof(header), 0, 0x200);
+            std::memcpy(nca.plain.data(), nca.data.data(), sizeof(header));
+            nca.id = IdFromData(nca.data);
+            return nca;
+        }
+
+        std::vector<u8> BuildPartition(u32 magic, size_t entrySize, const std::vector<PackageFile>& files, size_t alignment)
+        {
+            std::string stringTable;
+            std::vector<u32> nameOffsets;
+            for (const PackageFile& file : files) {
+                nameOffsets.push_back((u32)stringTable.size());
+                stringTable += file.name;
+                stringTable += '\0';
+            }
+            const size_t fixedSize = 0x10 + files.size() * entrySize;
+            stringTable.resize(AlignUp(fixedSize + stringTable.size(), alignment) - fixedSize, '\0');
+
+            std::vector<u8> out(fixedSize + stringTable.size());
+            const u32 header[4] = { magic, (u32)files.size(), (u32)stringTable.size(), 0 };
+            std::memcpy(out.data(), header, sizeof(header));
+            std::memcpy(out.data() + fixedSize, stringTable.data(), stringTable.size());
+
+            u64 dataOffset = 0;
+            for (size_t i = 0; i < files.size(); i++) {
+                u8* entry = out.data() + 0x10 + i * entrySize;
+                const u64 fileSize = files[i].data.size();
+                std::memcpy(entry, &dataOffset, sizeof(dataOffset));
+                std::memcpy(entry + 8, &fileSize, sizeof(fileSize));
+                std::memcpy(entry + 16, &nameOffsets[i], sizeof(u32));
+                dataOffset += fileSize;
+            }
+            for (const PackageFile& file : files)
+                out.insert(out.end(), file.data.begin(), file.data.end());
+            return out;
+        }
+    }
+
+    std::vector<u8> Filler(size_t size, u32 seed)
+    {
+        Rng rng(seed);
+        std::vector<u8> out(size);
+        constexpr size_t kChunk = 256;
+        for (size_t pos = 0; pos < size; pos += kChunk) {
+            const size_t n = std::min(kChunk, size - pos);
+            const u64 mode = rng.Next() % 4;
+            if (mode == 0 || pos < kChunk) {
+                rng.Fill(out.data() + pos, n);
+            }
+            else if (mode == 1) {
+                std::memset(out.data() + pos, (int)(rng.Next() & 0xFF), n);
+            }
+            else {
+                const size_t from = (size_t)(rng.Next() % (pos / kChunk)) * kChunk;
+                std::memcpy(out.data() + pos, out.data() + from, n);
+            }
+        }
+        return out;
+    }
+
+    Nca MakeNca(const NcaSpec& spec)
+    {
+        if (spec.sectionSizes.empty() || spec.sectionSizes.size() > 4)
+            throw std::invalid_argument("NCA needs 1-4 sections");
+
+        tin::install::NcaHeader header = {};
+        Rng rng(spec.seed);
+        rng.Fill(header.fixed_key_sig, sizeof(header.fixed_key_sig));
+        header.content_type = (u8)spec.contentType;
+        header.m_cryptoType2 = spec.keyGeneration;
+        header.m_titleId = spec.titleId;
+
+        std::vector<u64> sizes;
+        u64 total = 0;
+        const u64 sharedCtr = rng.Next() & ~0xFFFFull;
+        for (size_t i = 0; i < spec.sectionSizes.size(); i++) {
+            sizes.push_back(AlignUp(spec.sectionSizes[i], kMediaUnit));
+            total += sizes.back();
+            header.fs_headers[i].partition_type = 0;
+            header.fs_headers[i].fs_type = 3;
+            header.fs_headers[i].crypt_type = 3;
+            header.fs_headers[i].section_ctr = spec.sharedSectionCounter ? sharedCtr : (rng.Next() & ~0xFFFFull) | i;
+        }
+
+        return BuildNca(header, Filler(total, spec.seed), sizes, spec.seed);
+    }
+
+    std::vector<u8> MakeNcz(const Nca& nca, NczFormat format, u32 blockSizeExponent, int level)
+    {
+        std::vector<u8> out(nca.data.begin(), nca.data.begin() + NCA_HEADER_SIZE);
+
+        const u64 magic = 0x4E544345535A434E; // "NCZSECTN"
+        const u64 sectionCount = nca.sections.size();
+        out.insert(out.end(), (const u8*)&magic, (const u8*)&magic + sizeof(magic));
+        out.insert(out.end(), (const u8*)&sectionCount, (const u8*)&sectionCount + sizeof(sectionCount));
+        for (const NczSection& section : nca.sections) {
+            u8 raw[0x40] = {};
+            std::memcpy(raw, &section.offset, 8);
+            std::memcpy(raw + 8, &section.size, 8);
+            raw[16] = section.cryptoType;
+            std::memcpy(raw + 0x20, section.key, 0x10);
+            std::memcpy(raw + 0x30, section.counter, 0x10);
+            out.insert(out.end(), raw, raw + sizeof(raw));
+        }
+
+        const u8* body = nca.plain.data() + NCA_HEADER_SIZE;
+        const size_t bodySize = nca.plain.size() - NCA_HEADER_SIZE;
+
+        if (format == NczFormat::Stream) {
+            std::vector<u8> compressed(ZSTD_compressBound(bodySize));
+            const size_t size = ZSTD_compress(compressed.data(), compressed.size(), body, bodySize, level);
+            if (ZSTD_isError(size))
+                throw std::runtime_error(ZSTD_getErrorName(size));
+            out.insert(out.end(), compressed.begin(), compressed.begin() + size);
+            return out;
+        }
+
+        const u64 blockSize = 1ull << blockSizeExponent;
+        const u32 blockCount = (u32)((bodySize + blockSize - 1) / blockSize);
+        u8 blockHeader[0x18] = {};
+        const u64 blockMagic = 0x4B434F4C425A434E; // "NCZBLOCK"
+        const u64 decompressedSize = bodySize;
+        std::memcpy(blockHeader, &blockMagic, 8);
+        blockHeader[8] = 2;  // version
+        blockHeader[9] = 1;  // zstd
+        blockHeader[11] = (u8)blockSizeExponent;
+        std::memcpy(blockHeader + 12, &blockCount, 4);
+        std::memcpy(blockHeader + 16, &decompressedSize, 8);
+        out.insert(out.end(), blockHeader, blockHeader + sizeof(blockHeader));
+
+        std::vector<std::vector<u8>> blocks;
+        for (u32 i = 0; i < blockCount; i++) {
+            const size_t offset = (size_t)i * blockSize;
+            const size_t size = std::min<size_t>(blockSize, bodySize - offset);
+            std::vector<u8> compressed(ZSTD_compressBound(size));
+            const size_t compressedSize = ZSTD_compress(compressed.data(), compressed.size(), body + offset, size, level);
+            if (ZSTD_isError(compressedSize))
+                throw std::runtime_error(ZSTD_getErrorName(compressedSize));
+            // Blocks that don't shrink are stored raw, as the NCZ tools do
+            if (compressedSize >= size)
+                compressed.assign(body + offset, body + offset + size);
+            else
+                compressed.resize(compressedSize);
+            blocks.push_back(std::move(compressed));
+        }
+        for (const auto& block : blocks) {
+            const u32 size = (u32)block.size();
+            out.insert(out.end(), (const u8*)&size, (const u8*)&size + sizeof(size));
+        }
+        for (const auto& block : blocks)
+            out.insert(out.end(), block.begin(), block.end());
+        return out;
+    }
+
+    Nca MakeMetaNca(const ContentMetaSpec& spec, const std::vector<const Nca*>& contents)
+    {
+        // Packaged cnmt: header, extended header, content infos, then patch extended data
+        std::vector<u8> extendedHeader;
+        if (spec.type == NcmContentMetaType_Application) {
+            NcmApplicationMetaExtendedHeader ext = {};
+            ext.patch_id = spec.titleId | 0x800;
+            ext.required_system_version = spec.requiredSystemVersion;
+            extendedHeader.assign((const u8*)&ext, (const u8*)&ext + sizeof(ext));
+        }
+        else if (spec.type == NcmContentMetaType_Patch) {
+            NcmPatchMetaExtendedHeader ext = {};
+            ext.application_id = spec.titleId & ~0x800ull;
+            ext.required_system_version = spec.requiredSystemVersion;
+            ext.extended_data_size = spec.extendedDataSize;
+            extendedHeader.assign((const u8*)&ext, (const u8*)&ext + sizeof(ext));
+        }
+        else {
+            NcmAddOnContentMetaExtendedHeader ext = {};
+            ext.application_id = (spec.titleId & ~0xFFFull) - 0x1000;
+            extendedHeader.assign((const u8*)&ext, (const u8*)&ext + sizeof(ext));
+        }
+
+        nx::ncm::PackagedContentMetaHeader metaHeader = {};
+        metaHeader.title_id = spec.titleId;
+        metaHeader.version = spec.version;
+        metaHeader.type = (u8)spec.type;
+        metaHeader.extended_header_size = (u16)extendedHeader.size();
+        metaHeader.content_count = (u16)contents.size();
+        metaHeader.required_system_version = spec.requiredSystemVersion;
+
+        std::vector<u8> cnmt((const u8*)&metaHeader, (const u8*)&metaHeader + sizeof(metaHeader));
+        cnmt.insert(cnmt.end(), extendedHeader.begin(), extendedHeader.end());
+        for (const Nca* content : contents) {
+            NcmContentInfo contentInfo = {};
+            contentInfo.content_id = content->id;
+            ncmU64ToContentInfoSize(content->data.size(), &contentInfo);
+            contentInfo.content_type = (u8)content->contentType;
+
+            nx::ncm::PackagedContentInfo info = {};
+            sha256CalculateHash(info.hash, content->data.data(), content->data.size());
+            info.content_info = contentInfo;
+            cnmt.insert(cnmt.end(), (const u8*)&info, (const u8*)&info + sizeof(info));
+        }
+        const std::vector<u8> extendedData = Filler(spec.extendedDataSize, spec.seed + 1);
+        cnmt.insert(cnmt.end(), extendedData.begin(), extendedData.end());
+
+        char cnmtName[64];
+        std::snprintf(cnmtName, sizeof(cnmtName), "%s_%016lx.cnmt", spec.type == NcmContentMetaType_Patch ? "Patch" : spec.type == NcmContentMetaType_AddOnContent ? "AddOnContent" : "Application", spec.titleId);
+        const std::vector<u8> pfs0 = MakePfs0({ { cnmtName, cnmt } });
+
+        // Section 0: a hash table region, then the PFS0 the superblock points at
+        const u64 pfs0Offset = kMediaUnit;
+        std::vector<u8> section(AlignUp(pfs0Offset + pfs0.size(), kMediaUnit));
+        std::memcpy(section.data() + pfs0Offset, pfs0.data(), pfs0.size());
+
+        tin::install::NcaHeader header = {};
+        header.content_type = NcmContentType_Meta;
+        header.m_titleId = spec.titleId;
+        header.fs_headers[0].partition_type = 1;
+        header.fs_headers[0].fs_type = 2;
+        header.fs_headers[0].crypt_type = 3;
+        header.fs_headers[0].section_ctr = (u64)spec.seed << 32;
+        const u64 pfs0Size = pfs0.size();
+        std::memcpy(header.fs_headers[0].superblock_data + 0x38, &pfs0Offset, sizeof(pfs0Offset));
+        std::memcpy(header.fs_headers[0].superblock_data + 0x40, &pfs0Size, sizeof(pfs0Size));
+
+        return BuildNca(header, section, { section.size() }, spec.seed);
+    }
+
+    Title MakeTitle(const ContentMetaSpec& spec, const std::vector<u64>& contentSizes)
+    {
+        Title title;
+        for (size_t i = 0; i < contentSizes.size(); i++) {
+            NcaSpec ncaSpec;
+            ncaSpec.titleId = spec.titleId;
+            ncaSpec.contentType = i == 0 ? NcmContentType_Program : i == 1 ? NcmContentType_Control : NcmContentType_Data;
+            ncaSpec.sectionSizes = { contentSizes[i] };
+            ncaSpec.seed = spec.seed * 16 + (u32)i + 1;
+            title.contents.push_back(MakeNca(ncaSpec));
+        }
+        std::vector<const Nca*> contents;
+        for (const Nca& nca : title.contents)
+            contents.push_back(&nca);
+        title.meta = MakeMetaNca(spec, contents);
+        return title;
+    }
+
+    std::vector<PackageFile> TitleFiles(const Title& title, bool compressed, NczFormat format)
+    {
+        std::vector<PackageFile> files;
+        files.push_back({ IdString(title.meta.id) + ".cnmt.nca", title.meta.data });
+        for (const Nca& nca : title.contents) {
+            if (compressed)
+                files.push_back({ IdString(nca.id) + ".ncz", MakeNcz(nca, format) });
+            else
+                files.push_back({ IdString(nca.id) + ".nca", nca.data });
+        }
+        return files;
+    }
+
+    std::vector<u8> MakePfs0(const std::vector<PackageFile>& files)
+    {
+        return BuildPartition(0x30534650, sizeof(tin::install::PFS0FileEntry), files, 0x20);
+    }
+
+    std::vector<u8> MakeXci(const std::vector<PackageFile>& files)
+    {
+        const std::vector<u8> secure = BuildPartition(MAGIC_HFS0, sizeof(tin::install::HFS0FileEntry), files, 0x200);
+        const std::vector<u8> root = BuildPartition(MAGIC_HFS0, sizeof(tin::install::HFS0FileEntry), { { "update", {} }, { "secure", secure } }, 0x200);
+
+        std::vector<u8> out(0xF000);
+        out.insert(out.end(), root.begin(), root.end());
+        return out;
+    }
+
+    std::vector<u8> MakeTitlePack(const std::vector<std::pair<u64, inst::offline::TitleMetadata>>& titles)
+    {
+        constexpr size_t kHeaderSize = 0x20;
+        constexpr size_t kEntrySize = 0x30;
+        std::vector<u8> table(titles.size() * kEntrySize);
+        std::string strings(1, '\0'); // Offset 0 means no string
+
+        auto addString = [&](const std::string& value, u32 flag, u32& flags) -> u32 {
+            if (value.empty())
+                return 0;
+            flags |= flag;
+            const u32 offset = (u32)strings.size();
+            strings += value;
+            strings.push_back('\0');
+            return offset;
+        };
+
+        for (size_t i = 0; i < titles.size(); i++) {
+            const auto& meta = titles[i].second;
+            u8* entry = table.data() + i * kEntrySize;
+            u32 flags = 0;
+            const u32 offsets[4] = {
+                addString(meta.name, 1 << 0, flags),
+                addString(meta.publisher, 1 << 1, flags),
+                addString(meta.intro, 1 << 2, flags),
+                addString(meta.description, 1 << 3, flags),
+            };
+            const s32 isDemo = meta.isDemo ? 1 : 0;
+            flags |= (meta.hasSize ? 1 << 4 : 0) | (meta.hasVersion ? 1 << 5 : 0) |
+                (meta.hasReleaseDate ? 1 << 6 : 0) | (meta.hasIsDemo ? 1 << 7 : 0);
+            std::memcpy(entry, &titles[i].first, 8);
+            std::memcpy(entry + 0x08, offsets, sizeof(offsets));
+            std::memcpy(entry + 0x18, &meta.size, 8);
+            std::memcpy(entry + 0x20, &meta.version, 4);
+            std::memcpy(entry + 0x24, &meta.releaseDate, 4);
+            std::memcpy(entry + 0x28, &isDemo, 4);
+            std::memcpy(entry + 0x2C, &flags, 4);
+        }
+
+        std::vector<u8> out(kHeaderSize);
+        const u32 fields[4] = { 1, (u32)kEntrySize, (u32)titles.size(), 0 };
+        const u64 stringsOffset = kHeaderSize + table.size();
+        std::memcpy(out.data(), "CFTITLE1", 8);
+        std::memcpy(out.data() + 8, fields, sizeof(fields));
+        std::memcpy(out.data() + 0x18, &stringsOffset, 8);
+        out.insert(out.end(), table.begin(), table.end());
+        out.insert(out.end(), strings.begin(), strings.end());
+        return out;
+    }
+
+    std::string IdString(const NcmContentId& id)
+    {
+        return tin::util::GetNcaIdString(id);
+    }
+
+    void WriteFile(const std::string& path, const std::vector<u8>& data)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write((const char*)data.data(), (std::streamsize)data.size());
+        if (!file)
+            throw std::runtime_error("Failed to write " + path);
+    }
+}
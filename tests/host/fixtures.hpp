@@ -0,0 +1,95 @@
+// Builders for the packages the host tests and benchmarks install: NCAs encrypted with the
+// keys the host spl derives, their NCZ forms (zstd stream or NCZBLOCK), meta NCAs with a cnmt,
+// and NSP/XCI containers around them.
+#pragma once
+
+#include <switch.h>
+
+#include "util/offline_title_db.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace host::fixtures
+{
+    struct NcaSpec
+    {
+        u64 titleId = 0x0100000000010000;
+        NcmContentType contentType = NcmContentType_Program;
+        // Each section starts where the previous one ends; sizes are rounded up to 0x200
+        std::vector<u64> sectionSizes = { 0x40000 };
+        // Give every section the same key and counter, which NCZ section tables can merge
+        bool sharedSectionCounter = false;
+        u8 keyGeneration = 0;
+        u32 seed = 1;
+    };
+
+    struct NczSection
+    {
+        u64 offset;
+        u64 size;
+        u8 cryptoType;
+        u8 key[0x10];
+        u8 counter[0x10];
+    };
+
+    struct Nca
+    {
+        NcmContentId id;
+        NcmContentType contentType;
+        std::vector<u8> data;  // Encrypted NCA, as found in a package and as ncm should store it
+        std::vector<u8> plain; // Same bytes with the section data decrypted; the header stays encrypted
+        std::vector<NczSection> sections;
+    };
+
+    enum class NczFormat
+    {
+        Stream, // One zstd frame over the whole body
+        Block,  // NCZBLOCK with independently compressed blocks
+    };
+
+    struct ContentMetaSpec
+    {
+        u64 titleId = 0x0100000000010000;
+        u32 version = 0;
+        NcmContentMetaType type = NcmContentMetaType_Application;
+        u32 requiredSystemVersion = 0x0C000000;
+        u32 extendedDataSize = 0; // Patch metas only
+        u32 seed = 100;
+    };
+
+    struct PackageFile
+    {
+        std::string name;
+        std::vector<u8> data;
+    };
+
+    struct Title
+    {
+        Nca meta;
+        std::vector<Nca> contents;
+    };
+
+    // Semi-compressible filler, so NCZ bodies compress roughly like game data
+    std::vector<u8> Filler(size_t size, u32 seed);
+
+    Nca MakeNca(const NcaSpec& spec);
+    std::vector<u8> MakeNcz(const Nca& nca, NczFormat format, u32 blockSizeExponent = 16, int level = 1);
+    Nca MakeMetaNca(const ContentMetaSpec& spec, const std::vector<const Nca*>& contents);
+    // A meta NCA plus one content NCA per size
+    Title MakeTitle(const ContentMetaSpec& spec, const std::vector<u64>& contentSizes);
+
+    // Package entries for a title: "<id>.cnmt.nca" plus "<id>.nca" or "<id>.ncz" per content
+    std::vector<PackageFile> TitleFiles(const Title& title, bool compressed, NczFormat format = NczFormat::Stream);
+    std::vector<u8> MakePfs0(const std::vector<PackageFile>& files);
+    // Root HFS0 at 0xF000 with a single "secure" partition holding the files
+    std::vector<u8> MakeXci(const std::vector<PackageFile>& files);
+
+    // CFTITLE1 titles.pack with the records in the given order; empty strings and unset
+    // has* fields leave the matching flag clear
+    std::vector<u8> MakeTitlePack(const std::vector<std::pair<u64, inst::offline::TitleMetadata>>& titles);
+
+    std::string IdString(const NcmContentId& id);
+    void WriteFile(const std::string& path, const std::vector<u8>& data);
+}
@@ -0,0 +1,239 @@
+#include "http_server.hpp"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace host::http
+{
+    namespace
+    {
+        bool SendAll(int fd, const char* data, size_t size)
+        {
+            while (size > 0) {
+                const ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+                if (sent <= 0)
+                    return false;
+                data += sent;
+                size -= (size_t)sent;
+            }
+            return true;
+        }
+
+        const char* StatusText(int status)
+        {
+            switch (status) {
+                case 200: return "OK";
+                case 206: return "Partial Content";
+                case 304: return "Not Modified";
+                case 404: return "Not Found";
+                case 416: return "Range Not Satisfiable";
+                default: return "Status";
+            }
+        }
+    }
+
+    std::string Request::Header(const std::string& name) const
+    {
+        auto it = headers.find(name);
+        return it == headers.end() ? std::string() : it->second;
+    }
+
+    Response ServeBytes(const Request& request, const std::string& data)
+    {
+        Response response;
+        response.headers["Accept-Ranges"] = "bytes";
+        const std::string range = request.Header("range");
+        if (range.rfind("bytes=", 0) != 0) {
+            response.body = data;
+            return response;
+        }
+
+        const size_t dash = range.find('-');
+        const size_t first = std::strtoull(range.c_str() + 6, nullptr, 10);
+        size_t last = data.empty() ? 0 : data.size() - 1;
+        if (dash != std::string::npos && dash + 1 < range.size())
+            last = std::min<size_t>(last, std::strtoull(range.c_str() + dash + 1, nullptr, 10));
+        if (first >= data.size() || last < first) {
+            response.status = 416;
+            response.headers["Content-Range"] = "bytes */" + std::to_string(data.size());
+            return response;
+        }
+
+        response.status = 206;
+        response.headers["Content-Range"] = "bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" + std::to_string(data.size());
+        response.body = data.substr(first, last - first + 1);
+        return response;
+    }
+
+    Server::Server(Handler handler) :
+        m_handler(std::move(handler))
+    {
+        m_listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        if (m_listenFd < 0)
+            throw std::runtime_error("socket failed");
+        const int one = 1;
+        setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        socklen_t addrLen = sizeof(addr);
+        if (bind(m_listenFd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(m_listenFd, 64) != 0 ||
+            getsockname(m_listenFd, (sockaddr*)&addr, &addrLen) != 0) {
+            close(m_listenFd);
+            throw std::runtime_error("bind/listen failed");
+        }
+        m_port = ntohs(addr.sin_port);
+        m_acceptThread = std::thread(&Server::AcceptLoop, this);
+    }
+
+    Server::~Server()
+    {
+        m_stopping = true;
+        shutdown(m_listenFd, SHUT_RDWR);
+        close(m_listenFd);
+        if (m_acceptThread.joinable())
+            m_acceptThread.join();
+
+        std::vector<std::thread> threads;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (int fd : m_openFds)
+                shutdown(fd, SHUT_RDWR);
+            threads.swap(m_connectionThreads);
+        }
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    std::string Server::Url(const std::string& path) const
+    {
+        return "http://127.0.0.1:" + std::to_string(m_port) + path;
+    }
+
+    size_t Server::RequestCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_requests.size();
+    }
+
+    std::vector<Request> Server::Requests() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_requests;
+    }
+
+    void Server::AcceptLoop()
+    {
+        while (!m_stopping) {
+            const int fd = accept(m_listenFd, nullptr, nullptr);
+            if (fd < 0)
+                return;
+            const size_t connection = ++m_connections;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stopping) {
+                close(fd);
+                return;
+            }
+            m_openFds.push_back(fd);
+            m_connectionThreads.emplace_back(&Server::Serve, this, fd, connection);
+        }
+    }
+
+    void Server::Serve(int fd, size_t connection)
+    {
+        std::string pending;
+        char buffer[0x4000];
+        bool open = true;
+        while (open && !m_stopping) {
+            size_t headerEnd = pending.find("\r\n\r\n");
+            while (headerEnd == std::string::npos) {
+                const ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+                if (received <= 0) {
+                    open = false;
+                    break;
+                }
+                pending.append(buffer, (size_t)received);
+                headerEnd = pending.find("\r\n\r\n");
+            }
+            if (!open)
+                break;
+
+            Request request;
+            request.connection = connection;
+            const std::string head = pending.substr(0, headerEnd);
+            pending.erase(0, headerEnd + 4);
+            size_t lineEnd = head.find("\r\n");
+            const std::string requestLine = head.substr(0, lineEnd);
+            const size_t methodEnd = requestLine.find(' ');
+            const size_t pathEnd = requestLine.find(' ', methodEnd + 1);
+            request.method = requestLine.substr(0, methodEnd);
+            request.path = requestLine.substr(methodEnd + 1, pathEnd - methodEnd - 1);
+            while (lineEnd != std::string::npos) {
+                const size_t next = head.find("\r\n", lineEnd + 2);
+                const std::string line = head.substr(lineEnd + 2, next == std::string::npos ? std::string::npos : next - lineEnd - 2);
+                lineEnd = next;
+                const size_t colon = line.find(':');
+                if (colon == std::string::npos)
+                    continue;
+                std::string name = line.substr(0, colon);
+                std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+                size_t valueStart = colon + 1;
+                while (valueStart < line.size() && line[valueStart] == ' ')
+                    valueStart++;
+                request.headers[name] = line.substr(valueStart);
+            }
+
+            // Request bodies are never needed by the tests, but must not be parsed as requests
+            const size_t contentLength = std::strtoull(request.Header("content-length").c_str(), nullptr, 10);
+            while (pending.size() < contentLength) {
+                const ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+                if (received <= 0)
+                    break;
+                pending.append(buffer, (size_t)received);
+            }
+            pending.erase(0, std::min(contentLength, pending.size()));
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_requests.push_back(request);
+            }
+
+            Response response = m_handler(request);
+            std::string out = "HTTP/1.1 " + std::to_string(response.status) + " " + StatusText(response.status) + "\r\n";
+            for (const auto& header : response.headers)
+                out += header.first + ": " + header.second + "\r\n";
+            out += "Content-Length: " + std::to_string(response.body.size()) + "\r\n\r\n";
+            if (!SendAll(fd, out.data(), out.size()))
+                break;
+            if (request.method == "HEAD" || response.status == 304)
+                continue;
+
+            size_t sent = 0;
+            const size_t total = std::min(response.body.size(), response.dropAfter);
+            if (response.onPause && response.pauseAfter < total) {
+                if (!SendAll(fd, response.body.data(), response.pauseAfter))
+                    break;
+                sent = response.pauseAfter;
+                response.onPause();
+            }
+            if (!SendAll(fd, response.body.data() + sent, total - sent))
+                break;
+            if (total < response.body.size())
+                open = false;
+            if (request.Header("connection") == "close")
+                open = false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_openFds.erase(std::remove(m_openFds.begin(), m_openFds.end(), fd), m_openFds.end());
+        close(fd);
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+// Loopback HTTP/1.1 server for the network tests. Connections are kept alive, so the
+// connection count shows whether curl handles are being reused.
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace host::http
+{
+    struct Request
+    {
+        std::string method;
+        std::string path;
+        std::map<std::string, std::string> headers; // Lower-case names
+        size_t connection = 0;
+
+        std::string Header(const std::string& name) const;
+    };
+
+    struct Response
+    {
+        int status = 200;
+        std::map<std::string, std::string> headers;
+        std::string body;
+        // Close the connection after this many body bytes, as if the peer dropped
+        size_t dropAfter = std::string::npos;
+        // Called on the server thread once pauseAfter body bytes are out, before the rest
+        size_t pauseAfter = std::string::npos;
+        std::function<void()> onPause;
+    };
+
+    // Serves data with Range/HEAD support the way a file server would
+    Response ServeBytes(const Request& request, const std::string& data);
+
+    class Server
+    {
+        public:
+            using Handler = std::function<Response(const Request&)>;
+
+            explicit Server(Handler handler);
+            ~Server();
+
+            std::string Url(const std::string& path) const;
+            size_t ConnectionCount() const { return m_connections.load(); }
+            size_t RequestCount() const;
+            std::vector<Request> Requests() const;
+
+        private:
+            void AcceptLoop();
+            void Serve(int fd, size_t connection);
+
+            Handler m_handler;
+            int m_listenFd = -1;
+            int m_port = 0;
+            std::atomic<bool> m_stopping{false};
+            std::atomic<size_t> m_connections{0};
+            std::thread m_acceptThread;
+            mutable std::mutex m_mutex;
+            std::vector<std::thread> m_connectionThreads;
+            std::vector<int> m_openFds;
+            std::vector<Request> m_requests;
+    };
+}
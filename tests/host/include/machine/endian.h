@@ -0,0 +1,10 @@
+// newlib spells the byte swap helpers differently from glibc
+#pragma once
+
+#include <endian.h>
+
+#ifndef __bswap64
+#define __bswap16(x) __builtin_bswap16(x)
+#define __bswap32(x) __builtin_bswap32(x)
+#define __bswap64(x) __builtin_bswap64(x)
+#endif
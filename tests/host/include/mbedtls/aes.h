@@ -0,0 +1,28 @@
+// Host stand-in for the slice of mbedtls AES that shopInstall.cpp uses (legacy payload decode).
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MBEDTLS_AES_ENCRYPT 1
+#define MBEDTLS_AES_DECRYPT 0
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct mbedtls_aes_context {
+    int nr;
+    uint8_t rk[15][16];
+    int mode;
+} mbedtls_aes_context;
+
+void mbedtls_aes_init(mbedtls_aes_context* ctx);
+void mbedtls_aes_free(mbedtls_aes_context* ctx);
+int mbedtls_aes_setkey_enc(mbedtls_aes_context* ctx, const unsigned char* key, unsigned int keybits);
+int mbedtls_aes_setkey_dec(mbedtls_aes_context* ctx, const unsigned char* key, unsigned int keybits);
+int mbedtls_aes_crypt_ecb(mbedtls_aes_context* ctx, int mode, const unsigned char input[16], unsigned char output[16]);
+
+#ifdef __cplusplus
+}
+#endif
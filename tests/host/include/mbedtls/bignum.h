@@ -0,0 +1,26 @@
+// Host stand-in for the slice of mbedtls bignum that crypto.cpp uses (RSA-PSS verify).
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct mbedtls_mpi {
+    int s;
+    size_t n;
+    uint32_t* p;
+} mbedtls_mpi;
+
+void mbedtls_mpi_init(mbedtls_mpi* X);
+void mbedtls_mpi_free(mbedtls_mpi* X);
+int mbedtls_mpi_lset(mbedtls_mpi* X, int64_t z);
+int mbedtls_mpi_read_binary(mbedtls_mpi* X, const unsigned char* buf, size_t buflen);
+int mbedtls_mpi_write_binary(const mbedtls_mpi* X, unsigned char* buf, size_t buflen);
+int mbedtls_mpi_exp_mod(mbedtls_mpi* X, const mbedtls_mpi* A, const mbedtls_mpi* E, const mbedtls_mpi* N, mbedtls_mpi* prec_RR);
+
+#ifdef __cplusplus
+}
+#endif
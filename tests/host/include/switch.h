@@ -0,0 +1,36 @@
+// Host stand-in for <switch.h>. Services the host tests don't exercise are left out
+// on purpose, so new libnx uses in the install path show up as build errors here.
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "switch/types.h"
+#include "switch/result.h"
+#include "switch/sf/service.h"
+#include "switch/crypto/aes.h"
+#include "switch/crypto/sha256.h"
+#include "switch/services/fs.h"
+#include "switch/services/ncm.h"
+#include "switch/services/ns.h"
+#include "switch/services/hid.h"
+
+u64 armGetSystemTick(void);
+u64 armGetSystemTickFreq(void);
+void svcSleepThread(s64 nano);
+
+Result splCryptoGenerateAesKek(const void* wrapped_kek, u32 key_generation, u32 option, void* out_sealed_kek);
+Result splCryptoGenerateAesKey(const void* sealed_kek, const void* wrapped_key, void* out_sealed_key);
+
+typedef enum {
+    AppletFocusState_InFocus    = 1,
+    AppletFocusState_OutOfFocus = 2,
+    AppletFocusState_Background = 3,
+} AppletFocusState;
+
+Result appletSetMediaPlaybackState(bool state);
+
+#ifdef __cplusplus
+}
+#endif
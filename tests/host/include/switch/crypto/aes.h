@@ -0,0 +1,41 @@
+#pragma once
+
+#include "../types.h"
+
+#define AES_BLOCK_SIZE 0x10
+#define AES_128_KEY_SIZE 0x10
+#define AES_128_NUM_ROUNDS 10
+
+typedef struct {
+    u8 round_keys[AES_128_NUM_ROUNDS + 1][AES_BLOCK_SIZE];
+} Aes128Context;
+
+void aes128ContextCreate(Aes128Context* out, const void* key, bool is_encryptor);
+void aes128EncryptBlock(const Aes128Context* ctx, void* dst, const void* src);
+void aes128DecryptBlock(const Aes128Context* ctx, void* dst, const void* src);
+
+typedef struct {
+    Aes128Context aes_ctx;
+    u8 ctr[AES_BLOCK_SIZE];
+    u8 enc_ctr_buffer[AES_BLOCK_SIZE];
+    size_t buffer_offset;
+} Aes128CtrContext;
+
+void aes128CtrContextCreate(Aes128CtrContext* out, const void* key, const void* ctr);
+void aes128CtrContextResetCtr(Aes128CtrContext* ctx, const void* ctr);
+void aes128CtrCrypt(Aes128CtrContext* ctx, void* dst, const void* src, size_t size);
+
+typedef struct {
+    Aes128Context aes_ctx;
+    Aes128Context tweak_ctx;
+    u8 tweak[AES_BLOCK_SIZE];
+    u8 buffered_tweak[AES_BLOCK_SIZE];
+    u8 buffer[AES_BLOCK_SIZE];
+    size_t num_buffered;
+} Aes128XtsContext;
+
+void aes128XtsContextCreate(Aes128XtsContext* out, const void* key0, const void* key1, bool is_encryptor);
+void aes128XtsContextResetTweak(Aes128XtsContext* ctx, const void* tweak);
+void aes128XtsContextResetSector(Aes128XtsContext* ctx, uint64_t sector, bool is_nintendo);
+size_t aes128XtsEncrypt(Aes128XtsContext* ctx, void* dst, const void* src, size_t size);
+size_t aes128XtsDecrypt(Aes128XtsContext* ctx, void* dst, const void* src, size_t size);
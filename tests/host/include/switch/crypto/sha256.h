@@ -0,0 +1,19 @@
+#pragma once
+
+#include "../types.h"
+
+#define SHA256_HASH_SIZE 0x20
+#define SHA256_BLOCK_SIZE 0x40
+
+typedef struct {
+    u32 intermediate_hash[SHA256_HASH_SIZE / sizeof(u32)];
+    u8 buffer[SHA256_BLOCK_SIZE];
+    u64 bits_consumed;
+    size_t num_buffered;
+    bool finalized;
+} Sha256Context;
+
+void sha256ContextCreate(Sha256Context* out);
+void sha256ContextUpdate(Sha256Context* ctx, const void* src, size_t size);
+void sha256ContextGetHash(Sha256Context* ctx, void* dst);
+void sha256CalculateHash(void* dst, const void* src, size_t size);
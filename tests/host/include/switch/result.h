@@ -0,0 +1,22 @@
+#pragma once
+
+#include "types.h"
+
+#define R_SUCCEEDED(res) ((res) == 0)
+#define R_FAILED(res) ((res) != 0)
+#define R_MODULE(res) ((res) & 0x1FF)
+#define R_DESCRIPTION(res) (((res) >> 9) & 0x1FFF)
+#define R_VALUE(res) ((res) & 0x3FFFFF)
+
+#define MAKERESULT(module, description) ((((module) & 0x1FF)) | ((description) & 0x1FFF) << 9)
+
+enum {
+    Module_Libnx = 345,
+};
+
+enum {
+    LibnxError_BadInput = 2,
+    LibnxError_NotFound = 16,
+    LibnxError_IoError = 17,
+    LibnxError_NotInitialized = 23,
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "../types.h"
+#include "../result.h"
+#include "../sf/service.h"
+
+#define FS_MAX_PATH 0x301
+
+typedef struct {
+    u8 c[0x10];
+} FsRightsId;
+
+typedef struct {
+    Service s;
+} FsFileSystem;
+
+typedef struct {
+    Service s;
+} FsFile;
+
+typedef struct {
+    Service s;
+} FsDir;
+
+typedef struct {
+    Service s;
+} FsStorage;
+
+typedef struct {
+    Service s;
+} FsDeviceOperator;
+
+typedef struct {
+    char name[FS_MAX_PATH];
+    u8 pad[3];
+    s8 type;
+    u8 pad2[3];
+    s64 file_size;
+} FsDirectoryEntry;
+
+typedef enum {
+    FsFileSystemType_Logo               = 2,
+    FsFileSystemType_ContentControl     = 3,
+    FsFileSystemType_ContentManual      = 4,
+    FsFileSystemType_ContentMeta        = 5,
+    FsFileSystemType_ContentData        = 6,
+    FsFileSystemType_ApplicationPackage = 7,
+} FsFileSystemType;
+
+typedef enum {
+    FsOpenMode_Read   = BIT(0),
+    FsOpenMode_Write  = BIT(1),
+    FsOpenMode_Append = BIT(2),
+} FsOpenMode;
+
+typedef enum {
+    FsDirOpenMode_ReadDirs  = BIT(0),
+    FsDirOpenMode_ReadFiles = BIT(1),
+} FsDirOpenMode;
+
+typedef enum {
+    FsReadOption_None = 0,
+} FsReadOption;
+
+typedef enum {
+    FsDirEntryType_Dir  = 0,
+    FsDirEntryType_File = 1,
+} FsDirEntryType;
+
+typedef enum {
+    FsContentAttributes_None = 0x0,
+    FsContentAttributes_All  = 0xF,
+} FsContentAttributes;
+
+Result fsOpenSdCardFileSystem(FsFileSystem* out);
+Result fsOpenFileSystemWithId(FsFileSystem* out, u64 id, FsFileSystemType fsType, const char* contentPath, FsContentAttributes attr);
+Result fsFsOpenFile(FsFileSystem* fs, const char* path, u32 mode, FsFile* out);
+Result fsFsOpenDirectory(FsFileSystem* fs, const char* path, u32 mode, FsDir* out);
+void fsFsClose(FsFileSystem* fs);
+Result fsFileRead(FsFile* f, s64 off, void* buf, u64 read_size, u32 option, u64* bytes_read);
+Result fsFileGetSize(FsFile* f, s64* out);
+void fsFileClose(FsFile* f);
+Result fsDirRead(FsDir* d, s64* total_entries, size_t max_entries, FsDirectoryEntry* buf);
+Result fsDirGetEntryCount(FsDir* d, s64* count);
+void fsDirClose(FsDir* d);
+Result fsOpenDeviceOperator(FsDeviceOperator* out);
+Result fsDeviceOperatorGetMmcCid(FsDeviceOperator* d, void* dst, size_t dst_size, s64 size);
+void fsDeviceOperatorClose(FsDeviceOperator* d);
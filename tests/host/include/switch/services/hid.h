@@ -0,0 +1,12 @@
+#pragma once
+
+#include "../types.h"
+
+typedef enum {
+    HidNpadButton_A     = BIT(0),
+    HidNpadButton_B     = BIT(1),
+    HidNpadButton_X     = BIT(2),
+    HidNpadButton_Y     = BIT(3),
+    HidNpadButton_Plus  = BIT(10),
+    HidNpadButton_Minus = BIT(11),
+} HidNpadButton;
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "../types.h"
+#include "../result.h"
+#include "../sf/service.h"
+#include "fs.h"
+
+typedef enum {
+    NcmStorageId_None          = 0,
+    NcmStorageId_Host          = 1,
+    NcmStorageId_GameCard      = 2,
+    NcmStorageId_BuiltInSystem = 3,
+    NcmStorageId_BuiltInUser   = 4,
+    NcmStorageId_SdCard        = 5,
+    NcmStorageId_Any           = 6,
+} NcmStorageId;
+
+typedef enum {
+    NcmContentType_Meta             = 0,
+    NcmContentType_Program          = 1,
+    NcmContentType_Data             = 2,
+    NcmContentType_Control          = 3,
+    NcmContentType_HtmlDocument     = 4,
+    NcmContentType_LegalInformation = 5,
+    NcmContentType_DeltaFragment    = 6,
+} NcmContentType;
+
+typedef enum {
+    NcmContentMetaType_Unknown              = 0x0,
+    NcmContentMetaType_SystemProgram        = 0x1,
+    NcmContentMetaType_SystemData           = 0x2,
+    NcmContentMetaType_SystemUpdate         = 0x3,
+    NcmContentMetaType_BootImagePackage     = 0x4,
+    NcmContentMetaType_BootImagePackageSafe = 0x5,
+    NcmContentMetaType_Application          = 0x80,
+    NcmContentMetaType_Patch                = 0x81,
+    NcmContentMetaType_AddOnContent         = 0x82,
+    NcmContentMetaType_Delta                = 0x83,
+    NcmContentMetaType_DataPatch            = 0x84,
+} NcmContentMetaType;
+
+typedef struct {
+    Service s;
+} NcmContentStorage;
+
+typedef struct {
+    Service s;
+} NcmContentMetaDatabase;
+
+typedef struct {
+    u8 c[0x10];
+} NcmContentId;
+
+typedef struct {
+    u8 uuid[0x10];
+} NcmPlaceHolderId;
+
+typedef struct {
+    u64 id;
+    u32 version;
+    u8 type;
+    u8 install_type;
+    u8 padding[2];
+} NcmContentMetaKey;
+
+typedef struct {
+    NcmContentId content_id;
+    u32 size_low;
+    u8 size_high;
+    u8 attr;
+    u8 content_type;
+    u8 id_offset;
+} NcmContentInfo;
+
+typedef struct {
+    u16 extended_header_size;
+    u16 content_count;
+    u16 content_meta_count;
+    u8 attributes;
+    u8 storage_id;
+} NcmContentMetaHeader;
+
+typedef struct {
+    u64 patch_id;
+    u32 required_system_version;
+    u32 required_application_version;
+} NcmApplicationMetaExtendedHeader;
+
+typedef struct {
+    u64 application_id;
+    u32 required_system_version;
+    u32 extended_data_size;
+    u8 reserved[0x8];
+} NcmPatchMetaExtendedHeader;
+
+typedef struct {
+    u64 application_id;
+    u32 required_application_version;
+    u32 padding;
+} NcmAddOnContentMetaExtendedHeader;
+
+Result ncmOpenContentStorage(NcmContentStorage* out_content_storage, NcmStorageId storage_id);
+Result ncmOpenContentMetaDatabase(NcmContentMetaDatabase* out_db, NcmStorageId storage_id);
+Result ncmContentMetaDatabaseSet(NcmContentMetaDatabase* db, const NcmContentMetaKey* key, const void* data, u64 data_size);
+Result ncmContentMetaDatabaseCommit(NcmContentMetaDatabase* db);
+
+static inline void ncmU64ToContentInfoSize(const u64 size, NcmContentInfo* info) {
+    info->size_low = size & 0xFFFFFFFF;
+    info->size_high = (u8)(size >> 32);
+    info->attr = 0;
+}
+
+static inline void ncmContentInfoSizeToU64(const NcmContentInfo* info, u64* out_size) {
+    *out_size = ((u64)info->size_high << 32) | info->size_low;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "../types.h"
+#include "../result.h"
+#include "ncm.h"
+
+typedef struct {
+    char name[0x200];
+    char author[0x100];
+} NacpLanguageEntry;
+
+typedef struct {
+    NacpLanguageEntry lang[16];
+    u8 data[0x1000];
+} NacpStruct;
+
+typedef struct {
+    NacpStruct nacp;
+    u8 icon[0x20000];
+} NsApplicationControlData;
+
+typedef enum {
+    NsApplicationControlSource_CacheOnly = 0,
+    NsApplicationControlSource_Storage   = 1,
+    NsApplicationControlSource_StorageOnly = 2,
+} NsApplicationControlSource;
+
+typedef struct {
+    u8 meta_type;
+    u8 storageID;
+    u8 unk_x02;
+    u8 padding;
+    u32 version;
+    u64 application_id;
+} NsApplicationContentMetaStatus;
+
+Result nsGetApplicationControlData(NsApplicationControlSource source, u64 application_id, NsApplicationControlData* buffer, size_t size, u64* actual_size);
+Result nsCountApplicationContentMeta(u64 application_id, s32* out);
+Result nsListApplicationContentMetaStatus(u64 application_id, s32 index, NsApplicationContentMetaStatus* list, s32 count, s32* out_entrycount);
+Result nacpGetLanguageEntry(NacpStruct* nacp, NacpLanguageEntry** langentry);
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "../types.h"
+
+typedef struct Service {
+    Handle session;
+    u32 own_handle;
+    u32 object_id;
+    u16 pointer_buffer_size;
+} Service;
+
+void serviceClose(Service* s);
@@ -0,0 +1,28 @@
+// Host stand-in for the libnx headers: only what the install, shop and offline
+// DB code touches, with the same names and layouts as libnx.
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef int64_t s64;
+
+typedef u32 Handle;
+typedef u32 Result;
+
+#define BIT(n) (1U << (n))
+#define NX_PACKED __attribute__((packed))
+#define NX_INLINE __attribute__((always_inline)) static inline
+#define NX_CONSTEXPR static constexpr
+
+typedef struct {
+    u64 uid[2];
+} AccountUid;
@@ -0,0 +1,20 @@
+// Host replacement for the Plutonium application: dialogs return a scripted answer.
+#pragma once
+#include <string>
+#include <vector>
+#include <switch.h>
+#include "ui/instPage.hpp"
+
+namespace inst::ui {
+    class MainApplication
+    {
+        public:
+            int CreateShowDialog(const std::string& title, const std::string& content, const std::vector<std::string>& opts, bool useLastOptionAsCancel, const std::string& icon = "");
+            void CallForRender();
+            void RefreshInputDevice(bool force = false);
+            void UpdateButtons();
+            u64 GetButtonsDown();
+    };
+
+    extern MainApplication *mainApp;
+}
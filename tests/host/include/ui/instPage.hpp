@@ -0,0 +1,30 @@
+// Host replacement for the install page: same static API as include/ui/instPage.hpp,
+// without Plutonium. Calls land in inst::ui::host (see tests/host/ui_stub.cpp).
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <switch.h>
+
+namespace inst::ui {
+    class instPage
+    {
+        public:
+            static void setTopInstInfoText(std::string ourText);
+            static void setInstInfoText(std::string ourText);
+            static void setInstBarPerc(double ourPercent);
+            static void setProgressDetailText(const std::string& ourText);
+            static void clearProgressDetailText();
+            static void setInstallIconFromTitleId(u64 titleId);
+            static void setInstallIcon(const std::string& imagePath);
+            static void setInstallIconData(const void* imageData, std::uint32_t imageSize);
+            static void clearInstallIcon();
+            static void loadMainMenu();
+            static void loadInstallScreen();
+            static void requestInstallCancel();
+            static bool isInstallCancelRequested();
+            static void clearInstallCancel();
+            static void setProgressMutedOnThisThread(bool muted);
+            static void setProgressSinkOnThisThread(std::atomic<double>* sink);
+    };
+}
@@ -0,0 +1,173 @@
+// End-to-end installs from SD packages into the mock content storage: whatever the package
+// format, ncm must end up with the original NCA bytes and the same meta records.
+
+#include "test.hpp"
+
+#include "fixtures.hpp"
+#include "mock_ncm.hpp"
+#include "ui_stub.hpp"
+
+#include "install/install_nsp.hpp"
+#include "install/install_xci.hpp"
+#include "install/sdmc_nsp.hpp"
+#include "install/sdmc_xci.hpp"
+#include "util/config.hpp"
+
+using namespace host::fixtures;
+
+namespace
+{
+    const std::vector<u64> kContentSizes = { 0x180000, 0x24000, 0x9000 };
+
+    void InstallNsp(const std::string& path)
+    {
+        auto nsp = std::make_shared<tin::install::nsp::SDMCNSP>(path);
+        tin::install::nsp::NSPInstall task(NcmStorageId_SdCard, inst::config::ignoreReqVers, nsp);
+        task.Prepare();
+        task.Begin();
+    }
+
+    void InstallXci(const std::string& path)
+    {
+        auto xci = std::make_shared<tin::install::xci::SDMCXCI>(path);
+        tin::install::xci::XCIInstallTask task(NcmStorageId_SdCard, inst::config::ignoreReqVers, xci);
+        task.Prepare();
+        task.Begin();
+    }
+
+    void CheckInstalled(const Title& title)
+    {
+        CHECK(host::ncm::ReadRegistered(NcmStorageId_SdCard, title.meta.id) == title.meta.data);
+        for (const Nca& nca : title.contents)
+            CHECK(host::ncm::ReadRegistered(NcmStorageId_SdCard, nca.id) == nca.data);
+        CHECK_EQ(host::ncm::Registered(NcmStorageId_SdCard).size(), title.contents.size() + 1);
+        CHECK_EQ(host::ncm::LivePlaceholderCount(), (size_t)0);
+
+        const auto metas = host::ncm::MetaRecords();
+        REQUIRE(metas.size() == 1);
+        CHECK_EQ(metas[0].key.id, (u64)0x0100000000010000);
+        CHECK_EQ(host::ncm::MetaCommitCount(), (size_t)1);
+        const auto apps = host::ncm::ApplicationRecords();
+        REQUIRE(apps.size() == 1);
+        CHECK_EQ(apps[0].applicationId, (u64)0x0100000000010000);
+    }
+
+    void RunPackageInstall(bool xci, bool compressed, NczFormat format)
+    {
+        inst::config::validateNCAs = false;
+        const Title title = MakeTitle({}, kContentSizes);
+        const auto files = TitleFiles(title, compressed, format);
+        const std::string path = xci ? "title.xci" : "title.nsp";
+        WriteFile(path, xci ? MakeXci(files) : MakePfs0(files));
+
+        if (xci)
+            InstallXci(path);
+        else
+            InstallNsp(path);
+        CheckInstalled(title);
+    }
+}
+
+TEST_CASE(install_nsp_registers_original_ncas)
+{
+    RunPackageInstall(false, false, NczFormat::Stream);
+}
+
+TEST_CASE(install_nsz_stream_registers_original_ncas)
+{
+    RunPackageInstall(false, true, NczFormat::Stream);
+}
+
+TEST_CASE(install_nsz_block_registers_original_ncas)
+{
+    RunPackageInstall(false, true, NczFormat::Block);
+}
+
+TEST_CASE(install_xci_registers_original_ncas)
+{
+    RunPackageInstall(true, false, NczFormat::Stream);
+}
+
+TEST_CASE(install_xcz_registers_original_ncas)
+{
+    RunPackageInstall(true, true, NczFormat::Block);
+}
+
+TEST_CASE(install_serial_registers_original_ncas)
+{
+    inst::config::validateNCAs = false;
+    const Title title = MakeTitle({}, kContentSizes);
+    WriteFile("title.nsz", MakePfs0(TitleFiles(title, true)));
+
+    inst::config::concurrentNcaInstalls = 1;
+    InstallNsp("title.nsz");
+    CheckInstalled(title);
+}
+
+TEST_CASE(install_rejects_bad_nca_signature_unless_user_bypasses)
+{
+    // Fixture NCAs aren't signed with the retail key, so validation always trips the dialog
+    inst::config::validateNCAs = true;
+    const Title title = MakeTitle({}, { 0x8000 });
+    WriteFile("title.nsp", MakePfs0(TitleFiles(title, false)));
+
+    CHECK_THROWS(InstallNsp("title.nsp"));
+    CHECK(!host::ncm::IsRegistered(NcmStorageId_SdCard, title.contents[0].id));
+
+    host::ncm::Reset("ncm-bypass");
+    host::ui::SetDialogAnswer(1);
+    InstallNsp("title.nsp");
+    CheckInstalled(title);
+}
+
+TEST_CASE(install_write_failure_cleans_up)
+{
+    inst::config::validateNCAs = false;
+    const Title title = MakeTitle({}, kContentSizes);
+    WriteFile("title.nsz", MakePfs0(TitleFiles(title, true)));
+
+    host::ncm::FailWritesAfter(3);
+    CHECK_THROWS(InstallNsp("title.nsz"));
+    CHECK_EQ(host::ncm::LivePlaceholderCount(), (size_t)0);
+    for (const Nca& nca : title.contents)
+        CHECK(!host::ncm::IsRegistered(NcmStorageId_SdCard, nca.id));
+}
+
+TEST_CASE(nsp_header_lists_every_file)
+{
+    const Title title = MakeTitle({}, { 0x4000, 0x4000 });
+    const auto files = TitleFiles(title, false);
+    WriteFile("title.nsp", MakePfs0(files));
+
+    tin::install::nsp::SDMCNSP nsp("title.nsp");
+    nsp.RetrieveHeader();
+    CHECK_EQ(nsp.GetBaseHeader()->numFiles, (u32)files.size());
+    for (const PackageFile& file : files) {
+        const auto* entry = nsp.GetFileEntryByName(file.name);
+        REQUIRE(entry != nullptr);
+        CHECK_EQ(entry->fileSize, (u64)file.data.size());
+        std::vector<u8> data(file.data.size());
+        nsp.BufferData(data.data(), nsp.GetDataOffset() + entry->dataOffset, data.size());
+        CHECK(data == file.data);
+    }
+    CHECK(nsp.GetFileEntryByNcaId(title.contents[1].id) != nullptr);
+    CHECK_EQ(nsp.GetFileEntriesByExtension("cnmt.nca").size(), (size_t)1);
+}
+
+TEST_CASE(xci_header_finds_secure_partition)
+{
+    const Title title = MakeTitle({}, { 0x4000 });
+    const auto files = TitleFiles(title, true, NczFormat::Block);
+    WriteFile("title.xcz", MakeXci(files));
+
+    tin::install::xci::SDMCXCI xci("title.xcz");
+    xci.RetrieveHeader();
+    CHECK_EQ(xci.GetSecureHeader()->numFiles, (u32)files.size());
+    for (const PackageFile& file : files) {
+        const auto* entry = xci.GetFileEntryByName(file.name);
+        REQUIRE(entry != nullptr);
+        std::vector<u8> data(file.data.size());
+        xci.BufferData(data.data(), xci.GetDataOffset() + entry->dataOffset, data.size());
+        CHECK(data == file.data);
+    }
+}
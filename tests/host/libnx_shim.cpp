@@ -0,0 +1,511 @@
+// Host implementations of the libnx calls used by the install path: AES (ECB/CTR/XTS),
+// SHA-256, the system tick, and spl key derivation against a fixed set of test master keys.
+// Services that only exist on the console (SD mounts, ns control data) report failure, which
+// sends the callers down the same fallback paths as a missing title on the console. Content
+// file systems are served by content_fs.cpp.
+
+#include <switch.h>
+
+#include "libnx_shim.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#if defined(__AES__) && defined(__SSE2__)
+#include <wmmintrin.h>
+#define HOST_AES_NI 1
+#endif
+
+namespace {
+    std::atomic<size_t> g_ctrContextCreates{0};
+
+    const u8 kSbox[256] = {
+        0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+        0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+        0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+        0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+        0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+        0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+        0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+        0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+        0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+        0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+        0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+        0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+        0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+        0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+        0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+        0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+    };
+
+    void ExpandKey(const u8* key, u8 roundKeys[AES_128_NUM_ROUNDS + 1][AES_BLOCK_SIZE]) {
+        static const u8 kRcon[AES_128_NUM_ROUNDS] = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36 };
+        u8* w = &roundKeys[0][0];
+        std::memcpy(w, key, AES_128_KEY_SIZE);
+        for (int i = 4; i < 4 * (AES_128_NUM_ROUNDS + 1); i++) {
+            u8 t[4];
+            std::memcpy(t, w + (i - 1) * 4, 4);
+            if (i % 4 == 0) {
+                const u8 first = t[0];
+                t[0] = (u8)(kSbox[t[1]] ^ kRcon[i / 4 - 1]);
+                t[1] = kSbox[t[2]];
+                t[2] = kSbox[t[3]];
+                t[3] = kSbox[first];
+            }
+            for (int j = 0; j < 4; j++)
+                w[i * 4 + j] = (u8)(w[(i - 4) * 4 + j] ^ t[j]);
+        }
+    }
+
+#ifndef HOST_AES_NI
+    u8 g_invSbox[256];
+
+    struct InvSboxInit {
+        InvSboxInit() {
+            for (int i = 0; i < 256; i++)
+                g_invSbox[kSbox[i]] = (u8)i;
+        }
+    } g_invSboxInit;
+
+    u8 Xtime(u8 x) {
+        return (u8)((x << 1) ^ ((x & 0x80) ? 0x1B : 0x00));
+    }
+
+    u8 Mul(u8 a, u8 b) {
+        u8 result = 0;
+        while (b) {
+            if (b & 1)
+                result ^= a;
+            a = Xtime(a);
+            b >>= 1;
+        }
+        return result;
+    }
+
+    void AddRoundKey(u8* s, const u8* k) {
+        for (int i = 0; i < AES_BLOCK_SIZE; i++)
+            s[i] ^= k[i];
+    }
+
+    void EncryptBlockPortable(const u8 rk[AES_128_NUM_ROUNDS + 1][AES_BLOCK_SIZE], u8* s) {
+        AddRoundKey(s, rk[0]);
+        for (int round = 1; round <= AES_128_NUM_ROUNDS; round++) {
+            u8 t[AES_BLOCK_SIZE];
+            // SubBytes + ShiftRows
+            for (int c = 0; c < 4; c++)
+                for (int r = 0; r < 4; r++)
+                    t[c * 4 + r] = kSbox[s[((c + r) % 4) * 4 + r]];
+            if (round != AES_128_NUM_ROUNDS) {
+                // MixColumns
+                for (int c = 0; c < 4; c++) {
+                    u8* col = t + c * 4;
+                    const u8 a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+                    const u8 all = a0 ^ a1 ^ a2 ^ a3;
+                    col[0] ^= all ^ Xtime(a0 ^ a1);
+                    col[1] ^= all ^ Xtime(a1 ^ a2);
+                    col[2] ^= all ^ Xtime(a2 ^ a3);
+                    col[3] ^= all ^ Xtime(a3 ^ a0);
+                }
+            }
+            std::memcpy(s, t, AES_BLOCK_SIZE);
+            AddRoundKey(s, rk[round]);
+        }
+    }
+
+    void DecryptBlockPortable(const u8 rk[AES_128_NUM_ROUNDS + 1][AES_BLOCK_SIZE], u8* s) {
+        AddRoundKey(s, rk[AES_128_NUM_ROUNDS]);
+        for (int round = AES_128_NUM_ROUNDS - 1; round >= 0; round--) {
+            u8 t[AES_BLOCK_SIZE];
+            // InvShiftRows + InvSubBytes
+            for (int c = 0; c < 4; c++)
+                for (int r = 0; r < 4; r++)
+                    t[((c + r) % 4) * 4 + r] = g_invSbox[s[c * 4 + r]];
+            AddRoundKey(t, rk[round]);
+            if (round != 0) {
+                // InvMixColumns
+                for (int c = 0; c < 4; c++) {
+                    u8* col = t + c * 4;
+                    const u8 a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+                    col[0] = Mul(a0, 14) ^ Mul(a1, 11) ^ Mul(a2, 13) ^ Mul(a3, 9);
+                    col[1] = Mul(a0, 9) ^ Mul(a1, 14) ^ Mul(a2, 11) ^ Mul(a3, 13);
+                    col[2] = Mul(a0, 13) ^ Mul(a1, 9) ^ Mul(a2, 14) ^ Mul(a3, 11);
+                    col[3] = Mul(a0, 11) ^ Mul(a1, 13) ^ Mul(a2, 9) ^ Mul(a3, 14);
+                }
+            }
+            std::memcpy(s, t, AES_BLOCK_SIZE);
+        }
+    }
+
+#endif
+
+    // Round keys are always kept in encryption order; decryption walks them backwards
+    void EncryptBlock(const Aes128Context* ctx, void* dst, const void* src) {
+#ifdef HOST_AES_NI
+        __m128i block = _mm_loadu_si128((const __m128i*)src);
+        block = _mm_xor_si128(block, _mm_loadu_si128((const __m128i*)ctx->round_keys[0]));
+        for (int round = 1; round < AES_128_NUM_ROUNDS; round++)
+            block = _mm_aesenc_si128(block, _mm_loadu_si128((const __m128i*)ctx->round_keys[round]));
+        block = _mm_aesenclast_si128(block, _mm_loadu_si128((const __m128i*)ctx->round_keys[AES_128_NUM_ROUNDS]));
+        _mm_storeu_si128((__m128i*)dst, block);
+#else
+        u8 s[AES_BLOCK_SIZE];
+        std::memcpy(s, src, AES_BLOCK_SIZE);
+        EncryptBlockPortable(ctx->round_keys, s);
+        std::memcpy(dst, s, AES_BLOCK_SIZE);
+#endif
+    }
+
+    void DecryptBlock(const Aes128Context* ctx, void* dst, const void* src) {
+#ifdef HOST_AES_NI
+        __m128i block = _mm_loadu_si128((const __m128i*)src);
+        block = _mm_xor_si128(block, _mm_loadu_si128((const __m128i*)ctx->round_keys[AES_128_NUM_ROUNDS]));
+        for (int round = AES_128_NUM_ROUNDS - 1; round > 0; round--)
+            block = _mm_aesdec_si128(block, _mm_aesimc_si128(_mm_loadu_si128((const __m128i*)ctx->round_keys[round])));
+        block = _mm_aesdeclast_si128(block, _mm_loadu_si128((const __m128i*)ctx->round_keys[0]));
+        _mm_storeu_si128((__m128i*)dst, block);
+#else
+        u8 s[AES_BLOCK_SIZE];
+        std::memcpy(s, src, AES_BLOCK_SIZE);
+        DecryptBlockPortable(ctx->round_keys, s);
+        std::memcpy(dst, s, AES_BLOCK_SIZE);
+#endif
+    }
+
+    void IncrementCounter(u8* ctr) {
+        for (int i = AES_BLOCK_SIZE - 1; i >= 0; i--) {
+            if (++ctr[i] != 0)
+                break;
+        }
+    }
+
+    // Multiplies the XTS tweak by x in GF(2^128), little-endian convention
+    void MultiplyTweak(u8* tweak) {
+        u8 carry = 0;
+        for (int i = 0; i < AES_BLOCK_SIZE; i++) {
+            const u8 next = (u8)(tweak[i] >> 7);
+            tweak[i] = (u8)((tweak[i] << 1) | carry);
+            carry = next;
+        }
+        if (carry)
+            tweak[0] ^= 0x87;
+    }
+
+    size_t XtsCrypt(Aes128XtsContext* ctx, void* dst, const void* src, size_t size, bool encrypt) {
+        const size_t blocks = size / AES_BLOCK_SIZE;
+        u8* out = (u8*)dst;
+        const u8* in = (const u8*)src;
+        for (size_t i = 0; i < blocks; i++) {
+            u8 block[AES_BLOCK_SIZE];
+            for (int j = 0; j < AES_BLOCK_SIZE; j++)
+                block[j] = in[j] ^ ctx->tweak[j];
+            if (encrypt)
+                EncryptBlock(&ctx->aes_ctx, block, block);
+            else
+                DecryptBlock(&ctx->aes_ctx, block, block);
+            for (int j = 0; j < AES_BLOCK_SIZE; j++)
+                out[j] = block[j] ^ ctx->tweak[j];
+            MultiplyTweak(ctx->tweak);
+            in += AES_BLOCK_SIZE;
+            out += AES_BLOCK_SIZE;
+        }
+        return blocks * AES_BLOCK_SIZE;
+    }
+
+    // Stand-ins for the console master keys, one per key generation
+    void GetTestMasterKey(u32 generation, u8* out) {
+        for (int i = 0; i < AES_128_KEY_SIZE; i++)
+            out[i] = (u8)(0xA0 + generation * 0x11 + i);
+    }
+
+    const u32 kSha256Init[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+
+    const u32 kSha256K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+
+    u32 Rotr(u32 x, int n) {
+        return (x >> n) | (x << (32 - n));
+    }
+
+    void Sha256ProcessBlock(Sha256Context* ctx, const u8* block) {
+        u32 w[64];
+        for (int i = 0; i < 16; i++)
+            w[i] = ((u32)block[i * 4] << 24) | ((u32)block[i * 4 + 1] << 16) | ((u32)block[i * 4 + 2] << 8) | block[i * 4 + 3];
+        for (int i = 16; i < 64; i++) {
+            const u32 s0 = Rotr(w[i - 15], 7) ^ Rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const u32 s1 = Rotr(w[i - 2], 17) ^ Rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        u32 a = ctx->intermediate_hash[0], b = ctx->intermediate_hash[1], c = ctx->intermediate_hash[2], d = ctx->intermediate_hash[3];
+        u32 e = ctx->intermediate_hash[4], f = ctx->intermediate_hash[5], g = ctx->intermediate_hash[6], h = ctx->intermediate_hash[7];
+        for (int i = 0; i < 64; i++) {
+            const u32 t1 = h + (Rotr(e, 6) ^ Rotr(e, 11) ^ Rotr(e, 25)) + ((e & f) ^ (~e & g)) + kSha256K[i] + w[i];
+            const u32 t2 = (Rotr(a, 2) ^ Rotr(a, 13) ^ Rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        ctx->intermediate_hash[0] += a;
+        ctx->intermediate_hash[1] += b;
+        ctx->intermediate_hash[2] += c;
+        ctx->intermediate_hash[3] += d;
+        ctx->intermediate_hash[4] += e;
+        ctx->intermediate_hash[5] += f;
+        ctx->intermediate_hash[6] += g;
+        ctx->intermediate_hash[7] += h;
+    }
+}
+
+size_t host::shim::CtrContextCreateCount() {
+    return g_ctrContextCreates;
+}
+
+extern "C" {
+
+void aes128ContextCreate(Aes128Context* out, const void* key, bool is_encryptor) {
+    (void)is_encryptor;
+    ExpandKey((const u8*)key, out->round_keys);
+}
+
+void aes128EncryptBlock(const Aes128Context* ctx, void* dst, const void* src) {
+    EncryptBlock(ctx, dst, src);
+}
+
+void aes128DecryptBlock(const Aes128Context* ctx, void* dst, const void* src) {
+    DecryptBlock(ctx, dst, src);
+}
+
+void aes128CtrContextCreate(Aes128CtrContext* out, const void* key, const void* ctr) {
+    g_ctrContextCreates++;
+    aes128ContextCreate(&out->aes_ctx, key, true);
+    aes128CtrContextResetCtr(out, ctr);
+}
+
+void aes128CtrContextResetCtr(Aes128CtrContext* ctx, const void* ctr) {
+    std::memcpy(ctx->ctr, ctr, AES_BLOCK_SIZE);
+    std::memset(ctx->enc_ctr_buffer, 0, AES_BLOCK_SIZE);
+    ctx->buffer_offset = 0;
+}
+
+void aes128CtrCrypt(Aes128CtrContext* ctx, void* dst, const void* src, size_t size) {
+    u8* out = (u8*)dst;
+    const u8* in = (const u8*)src;
+
+    // Finish a keystream block left over from the previous call
+    while (size > 0 && ctx->buffer_offset > 0) {
+        *out++ = *in++ ^ ctx->enc_ctr_buffer[ctx->buffer_offset];
+        ctx->buffer_offset = (ctx->buffer_offset + 1) % AES_BLOCK_SIZE;
+        size--;
+    }
+
+    while (size >= AES_BLOCK_SIZE) {
+        u8 keystream[AES_BLOCK_SIZE];
+        EncryptBlock(&ctx->aes_ctx, keystream, ctx->ctr);
+        IncrementCounter(ctx->ctr);
+        for (int i = 0; i < AES_BLOCK_SIZE; i++)
+            out[i] = in[i] ^ keystream[i];
+        in += AES_BLOCK_SIZE;
+        out += AES_BLOCK_SIZE;
+        size -= AES_BLOCK_SIZE;
+    }
+
+    if (size > 0) {
+        EncryptBlock(&ctx->aes_ctx, ctx->enc_ctr_buffer, ctx->ctr);
+        IncrementCounter(ctx->ctr);
+        for (size_t i = 0; i < size; i++)
+            out[i] = in[i] ^ ctx->enc_ctr_buffer[i];
+        ctx->buffer_offset = size;
+    }
+}
+
+void aes128XtsContextCreate(Aes128XtsContext* out, const void* key0, const void* key1, bool is_encryptor) {
+    std::memset(out, 0, sizeof(*out));
+    aes128ContextCreate(&out->aes_ctx, key0, is_encryptor);
+    aes128ContextCreate(&out->tweak_ctx, key1, true);
+}
+
+void aes128XtsContextResetTweak(Aes128XtsContext* ctx, const void* tweak) {
+    EncryptBlock(&ctx->tweak_ctx, ctx->tweak, tweak);
+    ctx->num_buffered = 0;
+}
+
+void aes128XtsContextResetSector(Aes128XtsContext* ctx, uint64_t sector, bool is_nintendo) {
+    u8 tweak[AES_BLOCK_SIZE] = {0};
+    for (int i = 0; i < 8; i++) {
+        if (is_nintendo)
+            tweak[AES_BLOCK_SIZE - 1 - i] = (u8)(sector >> (8 * i));
+        else
+            tweak[i] = (u8)(sector >> (8 * i));
+    }
+    aes128XtsContextResetTweak(ctx, tweak);
+}
+
+size_t aes128XtsEncrypt(Aes128XtsContext* ctx, void* dst, const void* src, size_t size) {
+    return XtsCrypt(ctx, dst, src, size, true);
+}
+
+size_t aes128XtsDecrypt(Aes128XtsContext* ctx, void* dst, const void* src, size_t size) {
+    return XtsCrypt(ctx, dst, src, size, false);
+}
+
+void sha256ContextCreate(Sha256Context* out) {
+    std::memset(out, 0, sizeof(*out));
+    std::memcpy(out->intermediate_hash, kSha256Init, sizeof(kSha256Init));
+}
+
+void sha256ContextUpdate(Sha256Context* ctx, const void* src, size_t size) {
+    const u8* in = (const u8*)src;
+    ctx->bits_consumed += (u64)size * 8;
+    while (size > 0) {
+        const size_t take = std::min(size, (size_t)SHA256_BLOCK_SIZE - ctx->num_buffered);
+        std::memcpy(ctx->buffer + ctx->num_buffered, in, take);
+        ctx->num_buffered += take;
+        in += take;
+        size -= take;
+        if (ctx->num_buffered == SHA256_BLOCK_SIZE) {
+            Sha256ProcessBlock(ctx, ctx->buffer);
+            ctx->num_buffered = 0;
+        }
+    }
+}
+
+void sha256ContextGetHash(Sha256Context* ctx, void* dst) {
+    if (!ctx->finalized) {
+        const u64 bits = ctx->bits_consumed;
+        ctx->buffer[ctx->num_buffered++] = 0x80;
+        if (ctx->num_buffered > SHA256_BLOCK_SIZE - 8) {
+            std::memset(ctx->buffer + ctx->num_buffered, 0, SHA256_BLOCK_SIZE - ctx->num_buffered);
+            Sha256ProcessBlock(ctx, ctx->buffer);
+            ctx->num_buffered = 0;
+        }
+        std::memset(ctx->buffer + ctx->num_buffered, 0, SHA256_BLOCK_SIZE - 8 - ctx->num_buffered);
+        for (int i = 0; i < 8; i++)
+            ctx->buffer[SHA256_BLOCK_SIZE - 1 - i] = (u8)(bits >> (8 * i));
+        Sha256ProcessBlock(ctx, ctx->buffer);
+        ctx->finalized = true;
+    }
+
+    u8* out = (u8*)dst;
+    for (int i = 0; i < 8; i++) {
+        out[i * 4] = (u8)(ctx->intermediate_hash[i] >> 24);
+        out[i * 4 + 1] = (u8)(ctx->intermediate_hash[i] >> 16);
+        out[i * 4 + 2] = (u8)(ctx->intermediate_hash[i] >> 8);
+        out[i * 4 + 3] = (u8)ctx->intermediate_hash[i];
+    }
+}
+
+void sha256CalculateHash(void* dst, const void* src, size_t size) {
+    Sha256Context ctx;
+    sha256ContextCreate(&ctx);
+    sha256ContextUpdate(&ctx, src, size);
+    sha256ContextGetHash(&ctx, dst);
+}
+
+// The console ticks at 19.2MHz; keep that so tick math in the app behaves the same
+u64 armGetSystemTickFreq(void) {
+    return 19200000;
+}
+
+u64 armGetSystemTick(void) {
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    return (u64)((unsigned __int128)ns * 19200000 / 1000000000);
+}
+
+void svcSleepThread(s64 nano) {
+    if (nano > 0)
+        std::this_thread::sleep_for(std::chrono::nanoseconds(nano));
+    else
+        std::this_thread::yield();
+}
+
+// Same shape as the real derivation: the kek is unwrapped with the master key of the
+// generation, then the key with the kek
+Result splCryptoGenerateAesKek(const void* wrapped_kek, u32 key_generation, u32 option, void* out_sealed_kek) {
+    (void)option;
+    if (key_generation >= 0x20)
+        return MAKERESULT(Module_Libnx, LibnxError_BadInput);
+    u8 masterKey[AES_128_KEY_SIZE];
+    GetTestMasterKey(key_generation, masterKey);
+    Aes128Context ctx;
+    aes128ContextCreate(&ctx, masterKey, false);
+    aes128DecryptBlock(&ctx, out_sealed_kek, wrapped_kek);
+    return 0;
+}
+
+Result splCryptoGenerateAesKey(const void* sealed_kek, const void* wrapped_key, void* out_sealed_key) {
+    Aes128Context ctx;
+    aes128ContextCreate(&ctx, sealed_kek, false);
+    aes128DecryptBlock(&ctx, out_sealed_key, wrapped_key);
+    return 0;
+}
+
+Result appletSetMediaPlaybackState(bool state) {
+    (void)state;
+    return 0;
+}
+
+void serviceClose(Service* s) {
+    (void)s;
+}
+
+Result fsOpenSdCardFileSystem(FsFileSystem* out) {
+    (void)out;
+    return MAKERESULT(Module_Libnx, LibnxError_NotInitialized);
+}
+
+Result fsOpenDeviceOperator(FsDeviceOperator* out) {
+    (void)out;
+    return MAKERESULT(Module_Libnx, LibnxError_NotInitialized);
+}
+
+Result fsDeviceOperatorGetMmcCid(FsDeviceOperator* d, void* dst, size_t dst_size, s64 size) {
+    (void)d; (void)dst; (void)dst_size; (void)size;
+    return MAKERESULT(Module_Libnx, LibnxError_NotInitialized);
+}
+
+void fsDeviceOperatorClose(FsDeviceOperator* d) {
+    (void)d;
+}
+
+// Nothing is installed as far as ns is concerned; title names come from the offline DB
+Result nsGetApplicationControlData(NsApplicationControlSource source, u64 application_id, NsApplicationControlData* buffer, size_t size, u64* actual_size) {
+    (void)source; (void)application_id; (void)buffer; (void)size; (void)actual_size;
+    return MAKERESULT(Module_Libnx, LibnxError_NotFound);
+}
+
+Result nsCountApplicationContentMeta(u64 application_id, s32* out) {
+    (void)application_id;
+    *out = 0;
+    return MAKERESULT(Module_Libnx, LibnxError_NotFound);
+}
+
+Result nsListApplicationContentMetaStatus(u64 application_id, s32 index, NsApplicationContentMetaStatus* list, s32 count, s32* out_entrycount) {
+    (void)application_id; (void)index; (void)list; (void)count;
+    *out_entrycount = 0;
+    return MAKERESULT(Module_Libnx, LibnxError_NotFound);
+}
+
+Result nacpGetLanguageEntry(NacpStruct* nacp, NacpLanguageEntry** langentry) {
+    *langentry = &nacp->lang[0];
+    return 0;
+}
+
+}
@@ -0,0 +1,10 @@
+// Test controls for the host libnx shim (libnx_shim.cpp).
+#pragma once
+
+#include <cstddef>
+
+namespace host::shim
+{
+    // aes128CtrContextCreate calls made by this process so far
+    size_t CtrContextCreateCount();
+}
@@ -0,0 +1,200 @@
+// Host implementations of the mbedtls calls the app makes: the bignum modexp behind
+// rsa2048PssVerify and AES-128 ECB for the shop payload decode. Only the sizes those
+// callers use are supported; anything else returns an error like mbedtls would.
+
+#include <mbedtls/aes.h>
+#include <mbedtls/bignum.h>
+#include <switch.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+    using Limbs = std::vector<uint32_t>;
+
+    Limbs ToLimbs(const mbedtls_mpi* X, size_t count) {
+        Limbs out(count, 0);
+        for (size_t i = 0; i < X->n && i < count; i++)
+            out[i] = X->p[i];
+        return out;
+    }
+
+    size_t BitLength(const Limbs& a) {
+        for (size_t i = a.size(); i > 0; i--) {
+            if (a[i - 1])
+                return (i - 1) * 32 + (32 - __builtin_clz(a[i - 1]));
+        }
+        return 0;
+    }
+
+    bool GreaterOrEqual(const Limbs& a, const Limbs& b) {
+        for (size_t i = a.size(); i > 0; i--) {
+            if (a[i - 1] != b[i - 1])
+                return a[i - 1] > b[i - 1];
+        }
+        return true;
+    }
+
+    void Subtract(Limbs& a, const Limbs& b) {
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < a.size(); i++) {
+            const uint64_t diff = (uint64_t)a[i] - b[i] - borrow;
+            a[i] = (uint32_t)diff;
+            borrow = (diff >> 32) & 1;
+        }
+    }
+
+    // a = (a << 1) mod n, with a < n on entry; a carries one spare limb for the shift
+    void DoubleMod(Limbs& a, const Limbs& n) {
+        uint32_t carry = 0;
+        for (size_t i = 0; i < a.size(); i++) {
+            const uint32_t next = a[i] >> 31;
+            a[i] = (a[i] << 1) | carry;
+            carry = next;
+        }
+        if (GreaterOrEqual(a, n))
+            Subtract(a, n);
+    }
+
+    void AddMod(Limbs& a, const Limbs& b, const Limbs& n) {
+        uint64_t carry = 0;
+        for (size_t i = 0; i < a.size(); i++) {
+            const uint64_t sum = (uint64_t)a[i] + b[i] + carry;
+            a[i] = (uint32_t)sum;
+            carry = sum >> 32;
+        }
+        if (GreaterOrEqual(a, n))
+            Subtract(a, n);
+    }
+
+    // Shift-and-add modular multiply; slow but plenty for a handful of 2048-bit verifies
+    Limbs MulMod(const Limbs& a, const Limbs& b, const Limbs& n) {
+        Limbs result(n.size(), 0);
+        for (size_t bit = BitLength(b); bit > 0; bit--) {
+            DoubleMod(result, n);
+            if ((b[(bit - 1) / 32] >> ((bit - 1) % 32)) & 1)
+                AddMod(result, a, n);
+        }
+        return result;
+    }
+
+    Limbs Reduce(const Limbs& a, const Limbs& n) {
+        Limbs one(n.size(), 0);
+        one[0] = 1;
+        return MulMod(a, one, n);
+    }
+
+    int Assign(mbedtls_mpi* X, const Limbs& value) {
+        std::free(X->p);
+        X->p = (uint32_t*)std::calloc(value.size() ? value.size() : 1, sizeof(uint32_t));
+        if (X->p == nullptr) {
+            X->n = 0;
+            return -0x0010;
+        }
+        X->n = value.size();
+        X->s = 1;
+        if (!value.empty())
+            std::memcpy(X->p, value.data(), value.size() * sizeof(uint32_t));
+        return 0;
+    }
+}
+
+extern "C" {
+
+void mbedtls_mpi_init(mbedtls_mpi* X) {
+    X->s = 1;
+    X->n = 0;
+    X->p = nullptr;
+}
+
+void mbedtls_mpi_free(mbedtls_mpi* X) {
+    std::free(X->p);
+    mbedtls_mpi_init(X);
+}
+
+int mbedtls_mpi_lset(mbedtls_mpi* X, int64_t z) {
+    const uint64_t magnitude = z < 0 ? (uint64_t)-z : (uint64_t)z;
+    const int ret = Assign(X, Limbs{ (uint32_t)magnitude, (uint32_t)(magnitude >> 32) });
+    X->s = z < 0 ? -1 : 1;
+    return ret;
+}
+
+int mbedtls_mpi_read_binary(mbedtls_mpi* X, const unsigned char* buf, size_t buflen) {
+    Limbs value((buflen + 3) / 4, 0);
+    for (size_t i = 0; i < buflen; i++)
+        value[i / 4] |= (uint32_t)buf[buflen - 1 - i] << (8 * (i % 4));
+    return Assign(X, value);
+}
+
+int mbedtls_mpi_write_binary(const mbedtls_mpi* X, unsigned char* buf, size_t buflen) {
+    const Limbs value = ToLimbs(X, X->n);
+    if ((BitLength(value) + 7) / 8 > buflen)
+        return -0x0008; // MBEDTLS_ERR_MPI_BUFFER_TOO_SMALL
+    for (size_t i = 0; i < buflen; i++) {
+        const size_t limb = i / 4;
+        buf[buflen - 1 - i] = limb < value.size() ? (unsigned char)(value[limb] >> (8 * (i % 4))) : 0;
+    }
+    return 0;
+}
+
+int mbedtls_mpi_exp_mod(mbedtls_mpi* X, const mbedtls_mpi* A, const mbedtls_mpi* E, const mbedtls_mpi* N, mbedtls_mpi* prec_RR) {
+    (void)prec_RR;
+    // One spare limb so DoubleMod never loses the top bit before reducing
+    const size_t width = N->n + 1;
+    const Limbs n = ToLimbs(N, width);
+    if (BitLength(n) == 0 || (n[0] & 1) == 0)
+        return -0x0004; // MBEDTLS_ERR_MPI_BAD_INPUT_DATA
+
+    const Limbs base = Reduce(ToLimbs(A, width), n);
+    const Limbs e = ToLimbs(E, E->n);
+    Limbs result(width, 0);
+    result[0] = 1;
+    for (size_t bit = BitLength(e); bit > 0; bit--) {
+        result = MulMod(result, result, n);
+        if ((e[(bit - 1) / 32] >> ((bit - 1) % 32)) & 1)
+            result = MulMod(result, base, n);
+    }
+    result.resize(N->n);
+    return Assign(X, result);
+}
+
+void mbedtls_aes_init(mbedtls_aes_context* ctx) {
+    std::memset(ctx, 0, sizeof(*ctx));
+}
+
+void mbedtls_aes_free(mbedtls_aes_context* ctx) {
+    std::memset(ctx, 0, sizeof(*ctx));
+}
+
+int mbedtls_aes_setkey_enc(mbedtls_aes_context* ctx, const unsigned char* key, unsigned int keybits) {
+    if (keybits != 128)
+        return -0x0020; // MBEDTLS_ERR_AES_INVALID_KEY_LENGTH
+    Aes128Context aes;
+    aes128ContextCreate(&aes, key, true);
+    static_assert(sizeof(aes.round_keys) <= sizeof(ctx->rk), "mbedtls_aes_context too small");
+    std::memcpy(ctx->rk, aes.round_keys, sizeof(aes.round_keys));
+    ctx->nr = AES_128_NUM_ROUNDS;
+    ctx->mode = MBEDTLS_AES_ENCRYPT;
+    return 0;
+}
+
+int mbedtls_aes_setkey_dec(mbedtls_aes_context* ctx, const unsigned char* key, unsigned int keybits) {
+    const int ret = mbedtls_aes_setkey_enc(ctx, key, keybits);
+    ctx->mode = MBEDTLS_AES_DECRYPT;
+    return ret;
+}
+
+int mbedtls_aes_crypt_ecb(mbedtls_aes_context* ctx, int mode, const unsigned char input[16], unsigned char output[16]) {
+    if (ctx->nr != AES_128_NUM_ROUNDS)
+        return -0x0021; // MBEDTLS_ERR_AES_BAD_INPUT_DATA
+    Aes128Context aes;
+    std::memcpy(aes.round_keys, ctx->rk, sizeof(aes.round_keys));
+    if (mode == MBEDTLS_AES_DECRYPT)
+        aes128DecryptBlock(&aes, output, input);
+    else
+        aes128EncryptBlock(&aes, output, input);
+    return 0;
+}
+
+}
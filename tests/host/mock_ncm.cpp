@@ -0,0 +1,381 @@
+// Host nx::ncm::ContentStorage, built in place of source/nx/ncm.cpp. It keeps the real
+// class's contract: placeholders must be created before they are written, writes may not run
+// past the placeholder size, and registering over existing content fails. The ncm meta
+// database, ns application records and es tickets are recorded for the tests to inspect.
+
+#include "mock_ncm.hpp"
+
+#include "nx/ncm.hpp"
+#include "util/error.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    struct Placeholder
+    {
+        NcmContentId contentId;
+        size_t size;
+    };
+
+    struct State
+    {
+        std::mutex mutex;
+        std::filesystem::path root;
+        std::map<std::string, Placeholder> placeholders;
+        std::vector<host::ncm::WriteRecord> writes;
+        size_t createdPlaceholders = 0;
+        size_t peakLivePlaceholders = 0;
+        std::chrono::microseconds writeLatency{0};
+        double writeBytesPerSecond = 0.0;
+        int failWritesAfter = -1;
+        std::vector<host::ncm::MetaRecord> metaRecords;
+        size_t metaCommits = 0;
+        std::vector<host::ncm::ApplicationRecord> applicationRecords;
+        std::vector<host::ncm::Ticket> tickets;
+    };
+
+    State& GetState()
+    {
+        static State state;
+        return state;
+    }
+
+    std::string ToHex(const u8* data, size_t size)
+    {
+        static const char kDigits[] = "0123456789abcdef";
+        std::string out;
+        for (size_t i = 0; i < size; i++) {
+            out += kDigits[data[i] >> 4];
+            out += kDigits[data[i] & 0xF];
+        }
+        return out;
+    }
+
+    std::string StorageKey(NcmStorageId storageId, const u8* id)
+    {
+        return std::to_string((int)storageId) + "/" + ToHex(id, 0x10);
+    }
+
+    std::filesystem::path PlaceholderPath(const State& state, NcmStorageId storageId, const NcmPlaceHolderId& placeholderId)
+    {
+        return state.root / std::to_string((int)storageId) / "placeholder" / (ToHex(placeholderId.uuid, 0x10) + ".nca");
+    }
+
+    std::filesystem::path RegisteredPath(const State& state, NcmStorageId storageId, const NcmContentId& contentId)
+    {
+        return state.root / std::to_string((int)storageId) / "registered" / (ToHex(contentId.c, 0x10) + ".nca");
+    }
+
+    Result Fail(u32 description)
+    {
+        return MAKERESULT(Module_Libnx, description);
+    }
+}
+
+namespace host::ncm
+{
+    void Reset(const std::string& root)
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.root = root;
+        std::filesystem::remove_all(state.root);
+        std::filesystem::create_directories(state.root);
+        state.placeholders.clear();
+        state.writes.clear();
+        state.createdPlaceholders = 0;
+        state.peakLivePlaceholders = 0;
+        state.writeLatency = std::chrono::microseconds(0);
+        state.writeBytesPerSecond = 0.0;
+        state.failWritesAfter = -1;
+        state.metaRecords.clear();
+        state.metaCommits = 0;
+        state.applicationRecords.clear();
+        state.tickets.clear();
+    }
+
+    void SetWriteThrottle(std::chrono::microseconds latency, double bytesPerSecond)
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.writeLatency = latency;
+        state.writeBytesPerSecond = bytesPerSecond;
+    }
+
+    void FailWritesAfter(int n)
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.failWritesAfter = n;
+    }
+
+    std::vector<WriteRecord> Writes()
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return state.writes;
+    }
+
+    size_t CreatedPlaceholderCount()
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return state.createdPlaceholders;
+    }
+
+    size_t LivePlaceholderCount()
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return state.placeholders.size();
+    }
+
+    size_t PeakLivePlaceholderCount()
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return state.peakLivePlaceholders;
+    }
+
+    bool IsRegistered(NcmStorageId storageId, const NcmContentId& contentId)
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return std::filesystem::exists(RegisteredPath(state, storageId, contentId));
+    }
+
+    std::vector<NcmContentId> Registered(NcmStorageId storageId)
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        std::vector<NcmContentId> out;
+        const std::filesystem::path dir = state.root / std::to_string((int)storageId) / "registered";
+        if (!std::filesystem::exists(dir))
+            return out;
+        for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+            const std::string hex = entry.path().stem().string();
+            NcmContentId id = {};
+            for (size_t i = 0; i < sizeof(id.c) && i * 2 + 1 < hex.size(); i++)
+                id.c[i] = (u8)std::stoul(hex.substr(i * 2, 2), nullptr, 16);
+            out.push_back(id);
+        }
+        return out;
+    }
+
+    std::vector<u8> ReadRegistered(NcmStorageId storageId, const NcmContentId& contentId)
+    {
+        std::filesystem::path path;
+        {
+            State& state = GetState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            path = RegisteredPath(state, storageId, contentId);
+        }
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<u8>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    std::vector<MetaRecord> MetaRecords()
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return state.metaRecords;
+    }
+
+    size_t MetaCommitCount()
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return state.metaCommits;
+    }
+
+    std::vector<ApplicationRecord> ApplicationRecords()
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return state.applicationRecords;
+    }
+
+    std::vector<Ticket> Tickets()
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return state.tickets;
+    }
+}
+
+namespace nx::ncm
+{
+    // The storage id lives in the service object id, which is otherwise unused on the host
+    ContentStorage::ContentStorage(NcmStorageId storageId)
+    {
+        m_contentStorage = {};
+        m_contentStorage.s.object_id = (u32)storageId;
+    }
+
+    ContentStorage::~ContentStorage()
+    {
+        serviceClose(&m_contentStorage.s);
+    }
+
+    void ContentStorage::CreatePlaceholder(const NcmContentId &placeholderId, const NcmPlaceHolderId &registeredId, size_t size)
+    {
+        // Same swapped parameter names as the real header: the first argument is the content id
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        const NcmStorageId storageId = (NcmStorageId)m_contentStorage.s.object_id;
+        const std::string key = StorageKey(storageId, registeredId.uuid);
+        if (state.placeholders.count(key) != 0)
+            ASSERT_OK(Fail(LibnxError_BadInput), "Failed to create placeholder");
+
+        const std::filesystem::path path = PlaceholderPath(state, storageId, registeredId);
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path, std::ios::binary | std::ios::trunc).close();
+        std::filesystem::resize_file(path, size);
+        state.placeholders[key] = { placeholderId, size };
+        state.createdPlaceholders++;
+        state.peakLivePlaceholders = std::max(state.peakLivePlaceholders, state.placeholders.size());
+    }
+
+    void ContentStorage::DeletePlaceholder(const NcmPlaceHolderId &placeholderId)
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        const NcmStorageId storageId = (NcmStorageId)m_contentStorage.s.object_id;
+        if (state.placeholders.erase(StorageKey(storageId, placeholderId.uuid)) == 0)
+            ASSERT_OK(Fail(LibnxError_NotFound), "Failed to delete placeholder");
+        std::filesystem::remove(PlaceholderPath(state, storageId, placeholderId));
+    }
+
+    void ContentStorage::WritePlaceholder(const NcmPlaceHolderId &placeholderId, u64 offset, void *buffer, size_t bufSize)
+    {
+        const NcmStorageId storageId = (NcmStorageId)m_contentStorage.s.object_id;
+        std::filesystem::path path;
+        std::chrono::microseconds delay{0};
+        Result rc = 0;
+        {
+            State& state = GetState();
+            std::lock_guard<std::mutex> lock(state.mutex);
+            auto it = state.placeholders.find(StorageKey(storageId, placeholderId.uuid));
+            if (it == state.placeholders.end())
+                rc = Fail(LibnxError_NotFound);
+            else if (offset + bufSize > it->second.size)
+                rc = Fail(LibnxError_BadInput);
+            else if (state.failWritesAfter >= 0 && (int)state.writes.size() >= state.failWritesAfter)
+                rc = Fail(LibnxError_IoError);
+            else
+                state.writes.push_back({ storageId, placeholderId, offset, bufSize, std::this_thread::get_id() });
+
+            path = PlaceholderPath(state, storageId, placeholderId);
+            delay = state.writeLatency;
+            if (state.writeBytesPerSecond > 0.0)
+                delay += std::chrono::microseconds((long long)(bufSize / state.writeBytesPerSecond * 1000000.0));
+        }
+        ASSERT_OK(rc, "Failed to write to placeholder");
+
+        // Sleep outside the lock so concurrent installs overlap their writes like on the console
+        if (delay.count() > 0)
+            std::this_thread::sleep_for(delay);
+
+        std::FILE* file = std::fopen(path.c_str(), "r+b");
+        if (file == nullptr)
+            ASSERT_OK(Fail(LibnxError_IoError), "Failed to write to placeholder");
+        const bool ok = std::fseek(file, (long)offset, SEEK_SET) == 0 && std::fwrite(buffer, 1, bufSize, file) == bufSize;
+        std::fclose(file);
+        if (!ok)
+            ASSERT_OK(Fail(LibnxError_IoError), "Failed to write to placeholder");
+    }
+
+    void ContentStorage::Register(const NcmPlaceHolderId &placeholderId, const NcmContentId &registeredId)
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        const NcmStorageId storageId = (NcmStorageId)m_contentStorage.s.object_id;
+        auto it = state.placeholders.find(StorageKey(storageId, placeholderId.uuid));
+        const std::filesystem::path target = RegisteredPath(state, storageId, registeredId);
+        if (it == state.placeholders.end() || std::filesystem::exists(target))
+            ASSERT_OK(Fail(LibnxError_BadInput), "Failed to register placeholder NCA");
+
+        std::filesystem::create_directories(target.parent_path());
+        std::filesystem::rename(PlaceholderPath(state, storageId, placeholderId), target);
+        state.placeholders.erase(it);
+    }
+
+    void ContentStorage::Delete(const NcmContentId &registeredId)
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!std::filesystem::remove(RegisteredPath(state, (NcmStorageId)m_contentStorage.s.object_id, registeredId)))
+            ASSERT_OK(Fail(LibnxError_NotFound), "Failed to delete registered NCA");
+    }
+
+    bool ContentStorage::Has(const NcmContentId &registeredId)
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return std::filesystem::exists(RegisteredPath(state, (NcmStorageId)m_contentStorage.s.object_id, registeredId));
+    }
+
+    std::string ContentStorage::GetPath(const NcmContentId &registeredId)
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        const std::filesystem::path path = RegisteredPath(state, (NcmStorageId)m_contentStorage.s.object_id, registeredId);
+        if (!std::filesystem::exists(path))
+            ASSERT_OK(Fail(LibnxError_NotFound), "Failed to get installed NCA path");
+        return path.string();
+    }
+}
+
+extern "C"
+{
+    Result ncmOpenContentMetaDatabase(NcmContentMetaDatabase* out_db, NcmStorageId storage_id)
+    {
+        *out_db = {};
+        out_db->s.object_id = (u32)storage_id;
+        return 0;
+    }
+
+    Result ncmContentMetaDatabaseSet(NcmContentMetaDatabase* db, const NcmContentMetaKey* key, const void* data, u64 data_size)
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        const u8* bytes = (const u8*)data;
+        state.metaRecords.push_back({ (NcmStorageId)db->s.object_id, *key, std::vector<u8>(bytes, bytes + data_size) });
+        return 0;
+    }
+
+    Result ncmContentMetaDatabaseCommit(NcmContentMetaDatabase* db)
+    {
+        (void)db;
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.metaCommits++;
+        return 0;
+    }
+
+    Result nsPushApplicationRecord(u64 application_id, NsApplicationRecordType last_modified_event, ContentStorageRecord *content_records, u32 count)
+    {
+        (void)last_modified_event;
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.applicationRecords.push_back({ application_id, std::vector<ContentStorageRecord>(content_records, content_records + count) });
+        return 0;
+    }
+
+    Result esImportTicket(void const *tikBuf, size_t tikSize, void const *certBuf, size_t certSize)
+    {
+        State& state = GetState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        const u8* tik = (const u8*)tikBuf;
+        const u8* cert = (const u8*)certBuf;
+        state.tickets.push_back({ std::vector<u8>(tik, tik + tikSize), std::vector<u8>(cert, cert + certSize) });
+        return 0;
+    }
+}
@@ -0,0 +1,68 @@
+// Test controls for the host nx::ncm::ContentStorage (mock_ncm.cpp). Placeholders and
+// registered NCAs live as plain files under a per-test root, and every write is logged so
+// tests can assert on batching as well as on the installed bytes.
+#pragma once
+
+#include <switch.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nx/ipc/tin_ipc.h"
+
+namespace host::ncm
+{
+    struct WriteRecord
+    {
+        NcmStorageId storageId;
+        NcmPlaceHolderId placeholderId;
+        u64 offset;
+        size_t size;
+        std::thread::id thread;
+    };
+
+    struct MetaRecord
+    {
+        NcmStorageId storageId;
+        NcmContentMetaKey key;
+        std::vector<u8> data;
+    };
+
+    struct ApplicationRecord
+    {
+        u64 applicationId;
+        std::vector<ContentStorageRecord> records;
+    };
+
+    struct Ticket
+    {
+        std::vector<u8> tik;
+        std::vector<u8> cert;
+    };
+
+    // Clears all recorded state and places storage under root (created if missing)
+    void Reset(const std::string& root);
+
+    // Every WritePlaceholder call sleeps for latency plus size / bytesPerSecond, like a
+    // slow SD card. Zero disables the throttle.
+    void SetWriteThrottle(std::chrono::microseconds latency, double bytesPerSecond);
+    // The write after the first n succeed returns an error; negative disables
+    void FailWritesAfter(int n);
+
+    std::vector<WriteRecord> Writes();
+    size_t CreatedPlaceholderCount();
+    size_t LivePlaceholderCount();
+    // Most placeholders that existed at once since the last Reset
+    size_t PeakLivePlaceholderCount();
+
+    bool IsRegistered(NcmStorageId storageId, const NcmContentId& contentId);
+    std::vector<NcmContentId> Registered(NcmStorageId storageId);
+    std::vector<u8> ReadRegistered(NcmStorageId storageId, const NcmContentId& contentId);
+
+    std::vector<MetaRecord> MetaRecords();
+    size_t MetaCommitCount();
+    std::vector<ApplicationRecord> ApplicationRecords();
+    std::vector<Ticket> Tickets();
+}
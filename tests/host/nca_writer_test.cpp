@@ -0,0 +1,76 @@
+// NCZ section tables: runs of contiguous sections that share a key and counter are encrypted
+// through one cipher, and the installed NCA must match the original byte for byte either way.
+
+#include "test.hpp"
+
+#include "fixtures.hpp"
+#include "libnx_shim.hpp"
+#include "mock_ncm.hpp"
+
+#include "install/install_nsp.hpp"
+#include "install/sdmc_nsp.hpp"
+#include "util/config.hpp"
+
+using namespace host::fixtures;
+
+namespace
+{
+    const std::vector<u64> kSectionSizes = { 0x30000, 0x8000, 0x20000, 0x18000 };
+
+    Title MakeSectionedTitle(const std::vector<u64>& sectionSizes, bool sharedCounter)
+    {
+        NcaSpec spec;
+        spec.sectionSizes = sectionSizes;
+        spec.sharedSectionCounter = sharedCounter;
+        spec.seed = 7;
+
+        Title title;
+        title.contents.push_back(MakeNca(spec));
+        title.meta = MakeMetaNca({}, { &title.contents[0] });
+        return title;
+    }
+
+    // Installs the title as an NSZ and returns how many CTR ciphers the install created
+    size_t InstallNsz(const Title& title, NczFormat format)
+    {
+        WriteFile("title.nsz", MakePfs0(TitleFiles(title, true, format)));
+        const size_t before = host::shim::CtrContextCreateCount();
+
+        auto nsp = std::make_shared<tin::install::nsp::SDMCNSP>("title.nsz");
+        tin::install::nsp::NSPInstall task(NcmStorageId_SdCard, true, nsp);
+        task.Prepare();
+        task.Begin();
+
+        CHECK(host::ncm::ReadRegistered(NcmStorageId_SdCard, title.contents[0].id) == title.contents[0].data);
+        return host::shim::CtrContextCreateCount() - before;
+    }
+
+    void CheckMergedSections(NczFormat format)
+    {
+        inst::config::validateNCAs = false;
+        u64 total = 0;
+        for (u64 size : kSectionSizes)
+            total += size;
+
+        host::ncm::Reset("ncm-single");
+        const size_t single = InstallNsz(MakeSectionedTitle({ total }, true), format);
+        host::ncm::Reset("ncm-shared");
+        const size_t shared = InstallNsz(MakeSectionedTitle(kSectionSizes, true), format);
+        host::ncm::Reset("ncm-distinct");
+        const size_t distinct = InstallNsz(MakeSectionedTitle(kSectionSizes, false), format);
+
+        // All four shared-counter sections collapse into one range, not just the first pair
+        CHECK_EQ(shared, single);
+        CHECK_EQ(distinct, single + kSectionSizes.size() - 1);
+    }
+}
+
+TEST_CASE(ncz_stream_merges_contiguous_sections)
+{
+    CheckMergedSections(NczFormat::Stream);
+}
+
+TEST_CASE(ncz_block_merges_contiguous_sections)
+{
+    CheckMergedSections(NczFormat::Block);
+}
@@ -0,0 +1,90 @@
+// NCZ decompression settings: sequential and parallel NCZBLOCK decoding, with the output
+// window larger or smaller than a block, must all install the original NCA bytes.
+
+#include "test.hpp"
+
+#include "fixtures.hpp"
+#include "mock_ncm.hpp"
+
+#include "install/install_nsp.hpp"
+#include "install/sdmc_nsp.hpp"
+#include "util/config.hpp"
+
+using namespace host::fixtures;
+
+namespace
+{
+    // Sizes that leave a short last block at every block size used below
+    const std::vector<u64> kContentSizes = { 0x1A2200, 0x24200, 0x9000 };
+
+    void InstallCompressed(const Title& title, NczFormat format, u32 blockSizeExponent)
+    {
+        std::vector<PackageFile> files;
+        files.push_back({ IdString(title.meta.id) + ".cnmt.nca", title.meta.data });
+        for (const Nca& nca : title.contents)
+            files.push_back({ IdString(nca.id) + ".ncz", MakeNcz(nca, format, blockSizeExponent) });
+        WriteFile("title.nsz", MakePfs0(files));
+
+        auto nsp = std::make_shared<tin::install::nsp::SDMCNSP>("title.nsz");
+        tin::install::nsp::NSPInstall task(NcmStorageId_SdCard, true, nsp);
+        task.Prepare();
+        task.Begin();
+    }
+
+    void CheckInstalled(const Title& title)
+    {
+        for (const Nca& nca : title.contents)
+            CHECK(host::ncm::ReadRegistered(NcmStorageId_SdCard, nca.id) == nca.data);
+        CHECK_EQ(host::ncm::LivePlaceholderCount(), (size_t)0);
+    }
+}
+
+TEST_CASE(ncz_block_sequential_and_parallel_match)
+{
+    inst::config::validateNCAs = false;
+    const Title title = MakeTitle({}, kContentSizes);
+
+    int run = 0;
+    for (int threads : { 1, 4 }) {
+        for (int windowMb : { 1, 8 }) {
+            // 16KB blocks (the smallest NCZBLOCK allows) are far smaller than the output window, 1MB
+            // blocks fill the 1MB one exactly
+            for (u32 exponent : { 14u, 20u }) {
+                host::ncm::Reset("ncm-" + std::to_string(run++));
+                inst::config::nczDecompressThreads = threads;
+                inst::config::zstdOutputWindowMb = windowMb;
+                InstallCompressed(title, NczFormat::Block, exponent);
+                CheckInstalled(title);
+            }
+        }
+    }
+}
+
+TEST_CASE(ncz_stream_output_window_sizes_match)
+{
+    inst::config::validateNCAs = false;
+    const Title title = MakeTitle({}, kContentSizes);
+
+    for (int windowMb : { 0, 1, 8, 64 }) {
+        // Out-of-range settings are clamped rather than rejected
+        host::ncm::Reset("ncm-" + std::to_string(windowMb));
+        inst::config::zstdOutputWindowMb = windowMb;
+        InstallCompressed(title, NczFormat::Stream, 16);
+        CheckInstalled(title);
+    }
+}
+
+TEST_CASE(ncz_decompression_contexts_serve_consecutive_installs)
+{
+    // Pooled contexts carry over between NCAs and between installs; stale state must not leak
+    inst::config::validateNCAs = false;
+    inst::config::concurrentNcaInstalls = 1;
+    const Title first = MakeTitle({}, kContentSizes);
+    const Title second = MakeTitle({ .titleId = 0x0100000000020000, .seed = 200 }, { 0x9000, 0x1A2200 });
+
+    InstallCompressed(first, NczFormat::Stream, 16);
+    InstallCompressed(second, NczFormat::Block, 14);
+    InstallCompressed(first, NczFormat::Block, 16);
+    CheckInstalled(first);
+    CheckInstalled(second);
+}
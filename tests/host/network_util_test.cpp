@@ -0,0 +1,113 @@
+// HTTP range streaming against a loopback server: pooled handles must keep riding the same
+// keep-alive connections and still return the requested bytes.
+
+#include "test.hpp"
+
+#include "fixtures.hpp"
+#include "http_server.hpp"
+
+#include "util/config.hpp"
+#include "util/network_util.hpp"
+
+#include <cstring>
+
+namespace
+{
+    std::string Blob(size_t size)
+    {
+        const std::vector<u8> bytes = host::fixtures::Filler(size, 3);
+        return std::string(bytes.begin(), bytes.end());
+    }
+
+    std::string ReadRange(tin::network::HTTPDownload& download, size_t offset, size_t size)
+    {
+        std::string out;
+        const int rc = download.StreamDataRange(offset, size, [&](u8* bytes, size_t sz) {
+            out.append((const char*)bytes, sz);
+            return sz;
+        });
+        CHECK_EQ(rc, 0);
+        return out;
+    }
+}
+
+TEST_CASE(http_range_chunks_share_one_connection)
+{
+    const std::string blob = Blob(0x100000);
+    host::http::Server server([&](const host::http::Request& request) { return host::http::ServeBytes(request, blob); });
+    tin::network::HTTPDownload download(server.Url("/title.nsp"));
+
+    for (size_t offset = 0; offset < blob.size(); offset += 0x10000)
+        CHECK(ReadRange(download, offset, 0x10000) == blob.substr(offset, 0x10000));
+    CHECK_EQ(server.RequestCount(), (size_t)16);
+    CHECK_EQ(server.ConnectionCount(), (size_t)1);
+
+    // Every chunk carries the cached shop headers and its own range
+    const auto requests = server.Requests();
+    CHECK(!requests.back().Header("uid").empty());
+    CHECK(!requests.back().Header("hauth").empty());
+    CHECK_EQ(requests.back().Header("range"), std::string("bytes=983040-1048575"));
+
+    tin::network::CloseHttpRangeSession();
+    CHECK(ReadRange(download, 0, 0x1000) == blob.substr(0, 0x1000));
+    CHECK_EQ(server.ConnectionCount(), (size_t)2);
+    tin::network::CloseHttpRangeSession();
+}
+
+TEST_CASE(http_range_parallel_connections_stay_pooled)
+{
+    inst::config::httpRangeConnections = 4;
+    const std::string blob = Blob(0x1000000);
+    host::http::Server server([&](const host::http::Request& request) { return host::http::ServeBytes(request, blob); });
+    tin::network::HTTPDownload download(server.Url("/title.nsp"));
+
+    for (int pass = 0; pass < 2; pass++) {
+        std::string out;
+        const int rc = download.StreamDataRangeParallel(0, blob.size(), 4, [&](u8* bytes, size_t sz) {
+            out.append((const char*)bytes, sz);
+            return sz;
+        });
+        CHECK_EQ(rc, 0);
+        CHECK(out == blob);
+    }
+    // The second pass reuses the idle handles the first pass handed back
+    CHECK(server.ConnectionCount() <= (size_t)4);
+    tin::network::CloseHttpRangeSession();
+}
+
+TEST_CASE(http_range_reconnects_after_dropped_response)
+{
+    const std::string blob = Blob(0x40000);
+    bool dropped = false;
+    host::http::Server server([&](const host::http::Request& request) {
+        auto response = host::http::ServeBytes(request, blob);
+        if (!dropped) {
+            dropped = true;
+            response.dropAfter = 0x8000;
+        }
+        return response;
+    });
+    tin::network::HTTPDownload download(server.Url("/title.nsp"));
+
+    // The retry resumes at the first byte that didn't arrive, on a fresh connection
+    CHECK(ReadRange(download, 0, blob.size()) == blob);
+    CHECK_EQ(server.ConnectionCount(), (size_t)2);
+    const auto requests = server.Requests();
+    REQUIRE(requests.size() == 2);
+    CHECK_EQ(requests[1].Header("range"), std::string("bytes=32768-262143"));
+    tin::network::CloseHttpRangeSession();
+}
+
+TEST_CASE(http_range_fails_fast_on_missing_file)
+{
+    host::http::Server server([](const host::http::Request&) {
+        host::http::Response response;
+        response.status = 404;
+        return response;
+    });
+    tin::network::HTTPDownload download(server.Url("/missing.nsp"));
+    const int rc = download.StreamDataRange(0, 0x1000, [](u8*, size_t sz) { return sz; });
+    CHECK(rc != 0);
+    CHECK_EQ(server.RequestCount(), (size_t)1);
+    tin::network::CloseHttpRangeSession();
+}
@@ -0,0 +1,195 @@
+// Offline DB updates against a loopback server that drops or stalls pack downloads: the
+// packs must still verify, and an interrupted download must resume instead of restarting.
+
+#include "test.hpp"
+
+#include "fixtures.hpp"
+#include "http_server.hpp"
+
+#include "util/json.hpp"
+#include "util/offline_db_update.hpp"
+#include "util/offline_title_db.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+    std::string Blob(size_t size, u32 seed)
+    {
+        const std::vector<u8> bytes = host::fixtures::Filler(size, seed);
+        return std::string(bytes.begin(), bytes.end());
+    }
+
+    std::string Sha256Hex(const std::string& data)
+    {
+        u8 hash[SHA256_HASH_SIZE];
+        sha256CalculateHash(hash, data.data(), data.size());
+        std::string hex;
+        char byte[3];
+        for (u8 b : hash) {
+            std::snprintf(byte, sizeof(byte), "%02x", b);
+            hex += byte;
+        }
+        return hex;
+    }
+
+    std::string ReadAll(const std::string& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        return ss.str();
+    }
+
+    // Serves /manifest.json, /titles.pack and /icons.pack; hook may adjust pack responses
+    struct PackServer
+    {
+        std::string titles;
+        std::string icons;
+        std::function<void(const host::http::Request&, host::http::Response&)> hook;
+        host::http::Server server;
+
+        PackServer(size_t titlesSize, size_t iconsSize) :
+            titles(Blob(titlesSize, 11)), icons(Blob(iconsSize, 12)),
+            server([this](const host::http::Request& request) { return Handle(request); })
+        {
+        }
+
+        host::http::Response Handle(const host::http::Request& request)
+        {
+            if (request.path == "/manifest.json") {
+                nlohmann::json manifest;
+                manifest["db_version"] = "2026.10.01";
+                manifest["files"]["titles.pack"] = { { "url", "/titles.pack" }, { "size", titles.size() }, { "sha256", Sha256Hex(titles) } };
+                manifest["files"]["icons.pack"] = { { "url", "/icons.pack" }, { "size", icons.size() }, { "sha256", Sha256Hex(icons) } };
+                host::http::Response response;
+                response.body = manifest.dump();
+                return response;
+            }
+            host::http::Response response = host::http::ServeBytes(request, request.path == "/titles.pack" ? titles : icons);
+            if (hook)
+                hook(request, response);
+            return response;
+        }
+
+        std::vector<host::http::Request> PackRequests(const std::string& path) const
+        {
+            std::vector<host::http::Request> out;
+            for (const auto& request : server.Requests()) {
+                if (request.path == path)
+                    out.push_back(request);
+            }
+            return out;
+        }
+    };
+
+    void CheckInstalledPacks(const PackServer& packs)
+    {
+        const std::string dir = inst::offline::GetOfflineDbDir();
+        CHECK(ReadAll(dir + "/titles.pack") == packs.titles);
+        CHECK(ReadAll(dir + "/icons.pack") == packs.icons);
+        CHECK_EQ(inst::offline::dbupdate::GetInstalledVersion(), std::string("2026.10.01"));
+        CHECK(!std::filesystem::exists(dir + "/titles.pack.download"));
+        CHECK(!std::filesystem::exists(dir + "/titles.pack.download.resume"));
+        CHECK(!std::filesystem::exists(dir + "/icons.pack.download.resume"));
+    }
+}
+
+TEST_CASE(offline_db_update_installs_verified_packs)
+{
+    // titles.pack takes the single-stream path, icons.pack the parallel part path
+    PackServer packs(0x200000, 0x1400000);
+    const auto result = inst::offline::dbupdate::ApplyUpdate(packs.server.Url("/manifest.json"), true);
+    CHECK(result.success);
+    CHECK(result.updated);
+    CheckInstalledPacks(packs);
+    CHECK_EQ(packs.PackRequests("/titles.pack").size(), (size_t)1);
+    CHECK_EQ(packs.PackRequests("/icons.pack").size(), (size_t)2);
+}
+
+TEST_CASE(offline_db_update_resumes_dropped_download)
+{
+    PackServer packs(0xC00000, 0x100000);
+    bool dropped = false;
+    packs.hook = [&](const host::http::Request& request, host::http::Response& response) {
+        if (request.path == "/titles.pack" && !dropped) {
+            dropped = true;
+            response.dropAfter = 0xA00000;
+        }
+    };
+
+    const auto first = inst::offline::dbupdate::ApplyUpdate(packs.server.Url("/manifest.json"), true);
+    CHECK(!first.success);
+    CHECK(std::filesystem::exists(inst::offline::GetOfflineDbDir() + "/titles.pack.download.resume"));
+
+    const auto second = inst::offline::dbupdate::ApplyUpdate(packs.server.Url("/manifest.json"), true);
+    CHECK(second.success);
+    CheckInstalledPacks(packs);
+
+    // The retry asks only for what the first attempt didn't get
+    const auto requests = packs.PackRequests("/titles.pack");
+    REQUIRE(requests.size() == 2);
+    CHECK_EQ(requests[1].Header("range"), std::string("bytes=10485760-"));
+}
+
+TEST_CASE(offline_db_update_finishes_dropped_part_in_one_attempt)
+{
+    PackServer packs(0x100000, 0x1400000);
+    bool dropped = false;
+    packs.hook = [&](const host::http::Request& request, host::http::Response& response) {
+        // The second of the two parallel parts starts at 10MB
+        if (request.path == "/icons.pack" && request.Header("range").rfind("bytes=10485760-", 0) == 0 && !dropped) {
+            dropped = true;
+            response.dropAfter = 0x100000;
+        }
+    };
+
+    const auto result = inst::offline::dbupdate::ApplyUpdate(packs.server.Url("/manifest.json"), true);
+    CHECK(result.success);
+    CheckInstalledPacks(packs);
+
+    // Part one is not fetched again; the single-stream fallback picks up inside part two
+    const auto requests = packs.PackRequests("/icons.pack");
+    REQUIRE(requests.size() == 3);
+    const std::string fallback = requests[2].Header("range");
+    REQUIRE(fallback.rfind("bytes=", 0) == 0);
+    CHECK(std::strtoull(fallback.c_str() + 6, nullptr, 10) >= 0xA00000);
+}
+
+TEST_CASE(offline_db_resume_state_is_saved_while_download_stalls)
+{
+    PackServer packs(0xF00000, 0x100000);
+    const std::string temp = inst::offline::GetOfflineDbDir() + "/titles.pack.download";
+    u64 savedDone = 0;
+    std::string savedPrefix;
+    packs.hook = [&](const host::http::Request& request, host::http::Response& response) {
+        if (request.path != "/titles.pack")
+            return;
+        // While the server holds the rest back, the sidecar must already describe bytes on disk
+        response.pauseAfter = 0xC00000;
+        response.onPause = [&]() {
+            for (int i = 0; i < 100 && savedDone == 0; i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                try {
+                    const auto state = nlohmann::json::parse(ReadAll(temp + ".resume"));
+                    savedDone = state["parts"][0][2].get<u64>();
+                } catch (...) {
+                }
+            }
+            savedPrefix = ReadAll(temp).substr(0, savedDone);
+        };
+    };
+
+    const auto result = inst::offline::dbupdate::ApplyUpdate(packs.server.Url("/manifest.json"), true);
+    CHECK(result.success);
+    CHECK(savedDone >= 0x600000);
+    CHECK(savedPrefix.size() == savedDone);
+    CHECK(savedPrefix == packs.titles.substr(0, savedDone));
+    CheckInstalledPacks(packs);
+}
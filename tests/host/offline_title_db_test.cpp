@@ -0,0 +1,147 @@
+// titles.pack lookups are done in place on the loaded pack; they must answer exactly what the
+// old fully-expanded map did, including duplicate ids and the JSON fallback.
+
+#include "test.hpp"
+
+#include "fixtures.hpp"
+
+#include "util/offline_title_db.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+using inst::offline::TitleMetadata;
+
+namespace
+{
+    using PackTitles = std::vector<std::pair<u64, TitleMetadata>>;
+
+    TitleMetadata Meta(const std::string& name, u32 version = 0)
+    {
+        TitleMetadata meta;
+        meta.name = name;
+        meta.publisher = "Publisher " + name;
+        meta.intro = "Intro for " + name;
+        meta.description = "A longer description of " + name + " that is mostly filler text.";
+        meta.size = 0x10000000ULL + version;
+        meta.hasSize = true;
+        meta.version = version;
+        meta.hasVersion = true;
+        meta.releaseDate = 20240101;
+        meta.hasReleaseDate = true;
+        meta.isDemo = (version & 1) != 0;
+        meta.hasIsDemo = true;
+        return meta;
+    }
+
+    u64 TitleId(u32 index)
+    {
+        return 0x0100000000000000ULL | ((u64)index << 13);
+    }
+
+    void WritePack(const PackTitles& titles)
+    {
+        std::filesystem::create_directories(inst::offline::GetOfflineDbDir());
+        host::fixtures::WriteFile(inst::offline::GetOfflineDbDir() + "/titles.pack", host::fixtures::MakeTitlePack(titles));
+        inst::offline::Invalidate();
+    }
+
+    void CheckMeta(const TitleMetadata& actual, const TitleMetadata& expected)
+    {
+        CHECK_EQ(actual.name, expected.name);
+        CHECK_EQ(actual.publisher, expected.publisher);
+        CHECK_EQ(actual.intro, expected.intro);
+        CHECK_EQ(actual.description, expected.description);
+        CHECK_EQ(actual.hasSize, expected.hasSize);
+        CHECK_EQ(actual.size, expected.size);
+        CHECK_EQ(actual.hasVersion, expected.hasVersion);
+        CHECK_EQ(actual.version, expected.version);
+        CHECK_EQ(actual.releaseDate, expected.releaseDate);
+        CHECK_EQ(actual.isDemo, expected.isDemo);
+    }
+
+    size_t ResidentBytes()
+    {
+        std::ifstream statm("/proc/self/statm");
+        size_t pages = 0, resident = 0;
+        statm >> pages >> resident;
+        return resident * (size_t)sysconf(_SC_PAGESIZE);
+    }
+}
+
+TEST_CASE(offline_pack_lookups_match_records)
+{
+    // Reverse order forces the index permutation instead of the sorted in-place search
+    PackTitles titles;
+    for (u32 i = 2000; i > 0; i--)
+        titles.emplace_back(TitleId(i), Meta("Title " + std::to_string(i), i));
+    WritePack(titles);
+
+    for (const auto& title : titles) {
+        TitleMetadata meta;
+        REQUIRE(inst::offline::TryGetMetadata(title.first, meta));
+        CheckMeta(meta, title.second);
+    }
+    TitleMetadata missing;
+    CHECK(!inst::offline::TryGetMetadata(TitleId(0), missing));
+    CHECK(!inst::offline::TryGetMetadata(TitleId(2001), missing));
+}
+
+TEST_CASE(offline_pack_duplicate_ids_prefer_last_non_empty)
+{
+    PackTitles titles;
+    titles.emplace_back(TitleId(1), Meta("First", 1));
+    titles.emplace_back(TitleId(2), Meta("Other", 2));
+    titles.emplace_back(TitleId(1), Meta("Second", 3));
+    titles.emplace_back(TitleId(1), TitleMetadata()); // Empty record, as the map never stored
+    WritePack(titles);
+
+    TitleMetadata meta;
+    REQUIRE(inst::offline::TryGetMetadata(TitleId(1), meta));
+    CheckMeta(meta, titles[2].second);
+    REQUIRE(inst::offline::TryGetMetadata(TitleId(2), meta));
+    CheckMeta(meta, titles[1].second);
+}
+
+TEST_CASE(offline_pack_without_records_falls_back_to_json)
+{
+    PackTitles titles;
+    titles.emplace_back(TitleId(1), TitleMetadata());
+    titles.emplace_back(TitleId(2), TitleMetadata());
+    WritePack(titles);
+
+    std::ofstream json(inst::offline::GetOfflineDbDir() + "/titles.US.en.json");
+    json << "{\"0100000000002000\": {\"name\": \"From JSON\", \"publisher\": \"Json Co\", \"version\": 65536}}";
+    json.close();
+    inst::offline::Invalidate();
+
+    TitleMetadata meta;
+    REQUIRE(inst::offline::TryGetMetadata(TitleId(1), meta));
+    CHECK_EQ(meta.name, std::string("From JSON"));
+    CHECK_EQ(meta.publisher, std::string("Json Co"));
+    CHECK_EQ(meta.version, (u32)65536);
+    CHECK(!inst::offline::TryGetMetadata(TitleId(2), meta));
+}
+
+TEST_CASE(offline_pack_100k_titles_loads_in_place)
+{
+    PackTitles titles;
+    titles.reserve(100000);
+    for (u32 i = 1; i <= 100000; i++)
+        titles.emplace_back(TitleId(i), Meta("Title " + std::to_string(i), i));
+    WritePack(titles);
+    const size_t packSize = std::filesystem::file_size(inst::offline::GetOfflineDbDir() + "/titles.pack");
+
+    const size_t before = ResidentBytes();
+    TitleMetadata meta;
+    REQUIRE(inst::offline::TryGetMetadata(TitleId(50000), meta));
+    CheckMeta(meta, titles[49999].second);
+    // The pack is kept as one buffer; expanding it into a map of strings costs well over that
+    CHECK(ResidentBytes() - before < packSize + packSize / 4);
+
+    for (u32 i = 0; i < titles.size(); i += 997) {
+        REQUIRE(inst::offline::TryGetMetadata(titles[i].first, meta));
+        CHECK_EQ(meta.name, titles[i].second.name);
+    }
+}
@@ -0,0 +1,115 @@
+// Placeholder writes go through a queue thread that merges buffers when storage falls behind:
+// the merged writes must still tile the NCA exactly, and a failed write must stop the
+// install instead of leaving the producer waiting on a full queue.
+
+#include "test.hpp"
+
+#include "fixtures.hpp"
+#include "mock_ncm.hpp"
+
+#include "install/install_nsp.hpp"
+#include "install/sdmc_nsp.hpp"
+#include "util/config.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace host::fixtures;
+
+namespace
+{
+    // Six content buffers' worth, so the queue has room to back up
+    const u64 kLargeContentSize = 0x3000000;
+    const u64 kContentBufferSize = 0x800000;
+
+    void InstallNsp(const std::string& path)
+    {
+        auto nsp = std::make_shared<tin::install::nsp::SDMCNSP>(path);
+        tin::install::nsp::NSPInstall task(NcmStorageId_SdCard, true, nsp);
+        task.Prepare();
+        task.Begin();
+    }
+
+    std::vector<host::ncm::WriteRecord> WritesFor(const Nca& nca)
+    {
+        std::vector<host::ncm::WriteRecord> out;
+        for (const auto& write : host::ncm::Writes()) {
+            if (std::memcmp(&write.placeholderId, &nca.id, sizeof(nca.id)) == 0)
+                out.push_back(write);
+        }
+        return out;
+    }
+
+    void CheckWritesTile(const std::vector<host::ncm::WriteRecord>& writes, u64 size)
+    {
+        auto sorted = writes;
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.offset < b.offset; });
+        u64 next = 0;
+        for (const auto& write : sorted) {
+            CHECK_EQ(write.offset, next);
+            next = write.offset + write.size;
+        }
+        CHECK_EQ(next, size);
+    }
+}
+
+TEST_CASE(placeholder_writes_coalesce_on_slow_storage)
+{
+    inst::config::validateNCAs = false;
+    inst::config::concurrentNcaInstalls = 1;
+    const Title title = MakeTitle({}, { kLargeContentSize });
+    WriteFile("title.nsp", MakePfs0(TitleFiles(title, false)));
+
+    host::ncm::SetWriteThrottle(std::chrono::microseconds(20000), 200.0 * 1024 * 1024);
+    InstallNsp("title.nsp");
+
+    const Nca& nca = title.contents[0];
+    CHECK(host::ncm::ReadRegistered(NcmStorageId_SdCard, nca.id) == nca.data);
+    const auto writes = WritesFor(nca);
+    CheckWritesTile(writes, nca.data.size());
+
+    size_t merged = 0;
+    for (const auto& write : writes) {
+        // At most the queued buffers are merged into one staging write
+        CHECK(write.size <= kContentBufferSize * 2);
+        if (write.size > kContentBufferSize)
+            merged++;
+    }
+    CHECK(merged > 0);
+    CHECK(writes.size() < nca.data.size() / kContentBufferSize);
+}
+
+TEST_CASE(placeholder_writes_match_on_fast_storage)
+{
+    inst::config::validateNCAs = false;
+    inst::config::concurrentNcaInstalls = 1;
+    const Title title = MakeTitle({}, { kLargeContentSize, 0x9000 });
+    WriteFile("title.nsz", MakePfs0(TitleFiles(title, true)));
+
+    InstallNsp("title.nsz");
+    const std::thread::id mainThread = std::this_thread::get_id();
+    for (const Nca& nca : title.contents) {
+        CHECK(host::ncm::ReadRegistered(NcmStorageId_SdCard, nca.id) == nca.data);
+        const auto writes = WritesFor(nca);
+        CheckWritesTile(writes, nca.data.size());
+        // Only the header goes out from the installing thread
+        for (const auto& write : writes)
+            CHECK(write.offset == 0 || write.thread != mainThread);
+    }
+}
+
+TEST_CASE(placeholder_write_failure_releases_stalled_producer)
+{
+    inst::config::validateNCAs = false;
+    inst::config::concurrentNcaInstalls = 1;
+    const Title title = MakeTitle({}, { kLargeContentSize });
+    WriteFile("title.nsp", MakePfs0(TitleFiles(title, false)));
+
+    // Slow enough that the producer is waiting for queue space when a body write fails
+    host::ncm::SetWriteThrottle(std::chrono::microseconds(50000), 100.0 * 1024 * 1024);
+    host::ncm::FailWritesAfter(3);
+    CHECK_THROWS(InstallNsp("title.nsp"));
+    CHECK_EQ(host::ncm::LivePlaceholderCount(), (size_t)0);
+    CHECK(!host::ncm::IsRegistered(NcmStorageId_SdCard, title.contents[0].id));
+    CHECK_EQ(host::ncm::Writes().size(), (size_t)3);
+}
@@ -0,0 +1,135 @@
+// Known-answer checks for the host crypto, so install failures can't come from the shim.
+
+#include "test.hpp"
+
+#include <switch.h>
+#include <mbedtls/aes.h>
+#include <mbedtls/bignum.h>
+
+#include <cstring>
+
+TEST_CASE(shim_aes128_matches_fips197)
+{
+    const u8 key[16] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+    const u8 plain[16] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff };
+    const u8 expected[16] = { 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30, 0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a };
+
+    Aes128Context ctx;
+    aes128ContextCreate(&ctx, key, true);
+    u8 out[16];
+    aes128EncryptBlock(&ctx, out, plain);
+    CHECK(std::memcmp(out, expected, sizeof(out)) == 0);
+    aes128DecryptBlock(&ctx, out, out);
+    CHECK(std::memcmp(out, plain, sizeof(out)) == 0);
+
+    mbedtls_aes_context mbed;
+    mbedtls_aes_init(&mbed);
+    REQUIRE(mbedtls_aes_setkey_dec(&mbed, key, 128) == 0);
+    mbedtls_aes_crypt_ecb(&mbed, MBEDTLS_AES_DECRYPT, expected, out);
+    mbedtls_aes_free(&mbed);
+    CHECK(std::memcmp(out, plain, sizeof(out)) == 0);
+}
+
+TEST_CASE(shim_aes128_ctr_streams_across_calls)
+{
+    u8 key[16], ctr[16];
+    for (int i = 0; i < 16; i++) {
+        key[i] = (u8)(i * 7);
+        ctr[i] = (u8)(0xF0 + i);
+    }
+    std::vector<u8> data(1000);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = (u8)i;
+
+    Aes128CtrContext whole;
+    aes128CtrContextCreate(&whole, key, ctr);
+    std::vector<u8> expected(data.size());
+    aes128CtrCrypt(&whole, expected.data(), data.data(), data.size());
+
+    // Odd split points exercise the buffered keystream and the counter carry
+    Aes128CtrContext pieces;
+    aes128CtrContextCreate(&pieces, key, ctr);
+    std::vector<u8> out(data.size());
+    const size_t splits[] = { 0, 7, 16, 33, 500, 1000 };
+    for (size_t i = 0; i + 1 < sizeof(splits) / sizeof(splits[0]); i++)
+        aes128CtrCrypt(&pieces, out.data() + splits[i], data.data() + splits[i], splits[i + 1] - splits[i]);
+    CHECK(out == expected);
+
+    aes128CtrContextResetCtr(&pieces, ctr);
+    aes128CtrCrypt(&pieces, out.data(), expected.data(), expected.size());
+    CHECK(out == data);
+}
+
+TEST_CASE(shim_aes128_xts_round_trips_per_sector)
+{
+    u8 key0[16], key1[16];
+    for (int i = 0; i < 16; i++) {
+        key0[i] = (u8)(i + 1);
+        key1[i] = (u8)(0x80 - i);
+    }
+    std::vector<u8> data(0x400);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = (u8)(i * 13);
+
+    Aes128XtsContext enc, dec;
+    aes128XtsContextCreate(&enc, key0, key1, true);
+    aes128XtsContextCreate(&dec, key0, key1, false);
+    std::vector<u8> cipher(data.size()), plain(data.size());
+    for (size_t sector = 0; sector < 2; sector++) {
+        aes128XtsContextResetSector(&enc, sector, true);
+        CHECK_EQ(aes128XtsEncrypt(&enc, cipher.data() + sector * 0x200, data.data() + sector * 0x200, 0x200), (size_t)0x200);
+        aes128XtsContextResetSector(&dec, sector, true);
+        CHECK_EQ(aes128XtsDecrypt(&dec, plain.data() + sector * 0x200, cipher.data() + sector * 0x200, 0x200), (size_t)0x200);
+    }
+    CHECK(plain == data);
+    // Same plaintext in both sectors must not encrypt the same way
+    CHECK(std::memcmp(cipher.data(), cipher.data() + 0x200, 0x200) != 0);
+}
+
+TEST_CASE(shim_sha256_matches_known_digests)
+{
+    const u8 abc[32] = {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+    };
+    u8 out[32];
+    sha256CalculateHash(out, "abc", 3);
+    CHECK(std::memcmp(out, abc, sizeof(out)) == 0);
+
+    // 56 bytes forces the length into a second padding block
+    const char* twoBlocks = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    const u8 expected[32] = {
+        0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+        0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1,
+    };
+    Sha256Context ctx;
+    sha256ContextCreate(&ctx);
+    sha256ContextUpdate(&ctx, twoBlocks, 20);
+    sha256ContextUpdate(&ctx, twoBlocks + 20, std::strlen(twoBlocks) - 20);
+    sha256ContextGetHash(&ctx, out);
+    CHECK(std::memcmp(out, expected, sizeof(out)) == 0);
+}
+
+TEST_CASE(shim_mpi_exp_mod_small_values)
+{
+    // 4^13 mod 497 = 445
+    const u8 base[] = { 4 };
+    const u8 exponent[] = { 13 };
+    const u8 modulus[] = { 0x01, 0xF1 };
+    mbedtls_mpi A, E, N, X;
+    mbedtls_mpi_init(&A);
+    mbedtls_mpi_init(&E);
+    mbedtls_mpi_init(&N);
+    mbedtls_mpi_init(&X);
+    mbedtls_mpi_read_binary(&A, base, sizeof(base));
+    mbedtls_mpi_read_binary(&E, exponent, sizeof(exponent));
+    mbedtls_mpi_read_binary(&N, modulus, sizeof(modulus));
+    REQUIRE(mbedtls_mpi_exp_mod(&X, &A, &E, &N, nullptr) == 0);
+    u8 out[2];
+    REQUIRE(mbedtls_mpi_write_binary(&X, out, sizeof(out)) == 0);
+    CHECK_EQ(((int)out[0] << 8) | out[1], 445);
+    mbedtls_mpi_free(&A);
+    mbedtls_mpi_free(&E);
+    mbedtls_mpi_free(&N);
+    mbedtls_mpi_free(&X);
+}
@@ -0,0 +1,328 @@
+// Shop catalog fetches against a loopback shop: /api/shop/sections is parsed by the streaming
+// handler and must give the same items as the DOM parse of the same sections, and a response
+// it can't use must still fall back to the legacy files list. With the catalog cache on, a
+// payload with validators is kept and revalidated with a conditional request, and a cache that
+// no longer matches the shop, the credentials or its own files is not served.
+
+#include "test.hpp"
+
+#include "http_server.hpp"
+
+#include "shopInstall.hpp"
+#include "util/config.hpp"
+#include "util/json.hpp"
+
+#include <switch.h>
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+
+namespace
+{
+    using shopInstStuff::ShopItem;
+    using shopInstStuff::ShopSection;
+
+    host::http::Response Json(const std::string& body, int status = 200)
+    {
+        host::http::Response response;
+        response.status = status;
+        response.headers["Content-Type"] = "application/json";
+        response.body = body;
+        return response;
+    }
+
+    // One item entry; the index picks which optional fields and key spellings it uses
+    nlohmann::json ItemEntry(size_t index)
+    {
+        nlohmann::json entry;
+        entry["url"] = "/files/item" + std::to_string(index) + ".nsp#Item%20" + std::to_string(index) + ".nsp";
+        if (index % 3 != 0)
+            entry["name"] = "Item " + std::to_string(index) + " [0100000000" + std::to_string(100000 + index) + "]";
+        if (index % 4 != 1)
+            entry["size"] = 0x100000ull * (index + 1);
+        if (index % 5 == 0)
+            entry["title_id"] = "01000000000" + std::to_string(10000 + index) + "0";
+        else if (index % 5 == 1)
+            entry["app_id"] = "01000000000" + std::to_string(10000 + index) + "800";
+        if (index % 6 == 2)
+            entry["app_version"] = (int)(index * 65536);
+        if (index % 7 == 3)
+            entry["release_date"] = 20240101 + (int)index % 28;
+        if (index % 2 == 0)
+            entry["icon_url"] = "/icons/" + std::to_string(index) + ".jpg";
+        else if (index % 9 == 1)
+            entry["iconUrl"] = "https://cdn.example.com/" + std::to_string(index) + ".png";
+        if (index % 8 == 5) {
+            entry["save_id"] = "save-" + std::to_string(index);
+            entry["note"] = "note " + std::to_string(index);
+            entry["created_at"] = "2026-01-0" + std::to_string(1 + index % 9);
+            entry["created_ts"] = index % 16 == 5 ? -(long long)index : (long long)(1700000000 + index);
+        }
+        // Fields the app doesn't read, nested the way richer shops send them
+        if (index % 10 == 7) {
+            entry["extra"] = { { "tags", { "a", "b", { { "deep", { 1, 2, 3 } } } } }, { "rating", 4.5 }, { "hidden", false }, { "none", nullptr } };
+            entry["screenshots"] = nlohmann::json::array({ "/s/1.jpg", "/s/2.jpg" });
+        }
+        return entry;
+    }
+
+    // Sections with the id before, after or without items, plus entries the parser must skip
+    std::string SectionsBody(size_t itemsPerSection)
+    {
+        const char* ids[] = { "base", "updates", "dlc", "misc" };
+        std::string body = "{\"sections\":[";
+        size_t index = 0;
+        for (size_t s = 0; s < 4; s++) {
+            nlohmann::json items = nlohmann::json::array();
+            for (size_t i = 0; i < itemsPerSection; i++)
+                items.push_back(ItemEntry(index++));
+            items.push_back({ { "name", "missing url" } });
+            const std::string itemsJson = "\"items\":" + items.dump();
+            const std::string idJson = std::string("\"id\":\"") + ids[s] + "\",\"title\":\"Section " + ids[s] + "\"";
+            if (s > 0)
+                body += ",";
+            // The updates section names its id after the items, so type inference has to wait for it
+            body += s == 1 ? "{" + itemsJson + "," + idJson + "}" : "{" + idJson + "," + itemsJson + "}";
+        }
+        body += ",{\"id\":\"empty\",\"title\":\"Empty\",\"items\":[]},{\"id\":\"no-items\"}]}";
+        return body;
+    }
+
+    void CheckSameItem(const ShopItem& a, const ShopItem& b)
+    {
+        CHECK_EQ(a.name, b.name);
+        CHECK_EQ(a.url, b.url);
+        CHECK_EQ(a.iconUrl, b.iconUrl);
+        CHECK_EQ(a.appId, b.appId);
+        CHECK_EQ(a.saveId, b.saveId);
+        CHECK_EQ(a.saveNote, b.saveNote);
+        CHECK_EQ(a.saveCreatedAt, b.saveCreatedAt);
+        CHECK_EQ(a.saveCreatedTs, b.saveCreatedTs);
+        CHECK_EQ(a.size, b.size);
+        CHECK_EQ(a.titleId, b.titleId);
+        CHECK_EQ(a.appVersion, b.appVersion);
+        CHECK_EQ(a.releaseDate, b.releaseDate);
+        CHECK_EQ(a.appType, b.appType);
+        CHECK_EQ(a.hasTitleId, b.hasTitleId);
+        CHECK_EQ(a.hasAppVersion, b.hasAppVersion);
+        CHECK_EQ(a.hasReleaseDate, b.hasReleaseDate);
+        CHECK_EQ(a.hasIconUrl, b.hasIconUrl);
+        CHECK_EQ(a.hasAppId, b.hasAppId);
+    }
+
+    std::vector<std::string> ItemUrls(const std::vector<ShopSection>& sections)
+    {
+        std::vector<std::string> urls;
+        for (const ShopSection& section : sections) {
+            for (const ShopItem& item : section.items)
+                urls.push_back(item.url);
+        }
+        return urls;
+    }
+
+    // A shop that answers the sections with an ETag and honours If-None-Match
+    struct CachingShop
+    {
+        std::string body = SectionsBody(5);
+        std::string etag = "\"v1\"";
+        host::http::Server server{ [this](const host::http::Request& request) {
+            if (request.path != "/api/shop/sections")
+                return Json("{\"files\":[]}");
+            if (!etag.empty() && request.Header("if-none-match") == etag)
+                return Json("", 304);
+            host::http::Response response = Json(body);
+            if (!etag.empty())
+                response.headers["ETag"] = etag;
+            return response;
+        } };
+
+        std::vector<ShopSection> Fetch(const std::string& pass = "")
+        {
+            std::string error;
+            const auto sections = shopInstStuff::FetchShopSections(server.Url(""), "user", pass, error);
+            CHECK(error.empty());
+            return sections;
+        }
+
+        std::string LastValidator() const
+        {
+            const auto requests = server.Requests();
+            return requests.empty() ? std::string() : requests.back().Header("if-none-match");
+        }
+    };
+
+    std::vector<std::filesystem::path> CacheFiles(const std::string& extension)
+    {
+        std::vector<std::filesystem::path> files;
+        for (const auto& entry : std::filesystem::directory_iterator(inst::config::appDir + "/shop_cache")) {
+            if (entry.path().extension() == extension)
+                files.push_back(entry.path());
+        }
+        return files;
+    }
+}
+
+TEST_CASE(shop_sections_stream_parse_matches_dom_parse)
+{
+    inst::config::shopCatalogCache = false;
+    const std::string body = SectionsBody(60);
+    // The root manifest carries the same sections, which the legacy path parses as a DOM
+    host::http::Server server([&](const host::http::Request&) { return Json(body); });
+
+    std::string error;
+    const std::vector<ShopSection> sections = shopInstStuff::FetchShopSections(server.Url(""), "", "", error);
+    CHECK(error.empty());
+    const std::vector<ShopItem> reference = shopInstStuff::FetchShop(server.Url(""), "", "", error);
+    CHECK(error.empty());
+
+    REQUIRE(sections.size() == 4);
+    const char* ids[] = { "base", "updates", "dlc", "misc" };
+    std::map<std::string, const ShopItem*> byUrl;
+    for (const ShopItem& item : reference)
+        byUrl[item.url] = &item;
+    size_t total = 0;
+    for (size_t s = 0; s < sections.size(); s++) {
+        CHECK_EQ(sections[s].id, std::string(ids[s]));
+        CHECK_EQ(sections[s].title, "Section " + std::string(ids[s]));
+        CHECK_EQ(sections[s].items.size(), (size_t)60);
+        for (const ShopItem& item : sections[s].items) {
+            auto it = byUrl.find(item.url);
+            REQUIRE(it != byUrl.end());
+            CheckSameItem(item, *it->second);
+        }
+        total += sections[s].items.size();
+    }
+    CHECK_EQ(total, reference.size());
+
+    // Items without ids take their type from a section id that came after them
+    for (const ShopItem& item : sections[1].items) {
+        if (!item.hasTitleId)
+            CHECK_EQ(item.appType, (std::int32_t)NcmContentMetaType_Patch);
+    }
+}
+
+TEST_CASE(shop_sections_unusable_response_falls_back_to_files)
+{
+    inst::config::shopCatalogCache = false;
+    const std::string files = "{\"files\":[{\"url\":\"/a.nsp\",\"size\":1},{\"url\":\"/b.nsp\",\"size\":2}]}";
+    const std::vector<std::string> unusable = {
+        "{\"sections\":[{\"id\":\"base\",\"title\":7,\"items\":[{\"url\":\"/x.nsp\"}]}]}",
+        "{\"sections\":[{\"id\":\"base\",\"items\":[{\"url\":\"/x.nsp\"",
+        "{\"catalog\":[]}",
+    };
+
+    for (const std::string& sections : unusable) {
+        host::http::Server server([&](const host::http::Request& request) {
+            return Json(request.path == "/api/shop/sections" ? sections : files);
+        });
+        std::string error;
+        bool usedLegacyFallback = false;
+        const auto result = shopInstStuff::FetchShopSections(server.Url(""), "", "", error, &usedLegacyFallback);
+        CHECK(error.empty());
+        CHECK(usedLegacyFallback);
+        REQUIRE(result.size() == 1);
+        CHECK_EQ(result[0].id, std::string("all"));
+        REQUIRE(result[0].items.size() == 2);
+        CHECK_EQ(result[0].items[0].url, server.Url("/a.nsp"));
+    }
+}
+
+TEST_CASE(shop_sections_login_error_is_reported)
+{
+    inst::config::shopCatalogCache = false;
+    host::http::Server server([](const host::http::Request&) { return Json("{\"error\":\"bad password\"}"); });
+    std::string error;
+    const auto result = shopInstStuff::FetchShopSections(server.Url(""), "", "", error);
+    CHECK(result.empty());
+    CHECK(error.find("bad password") != std::string::npos);
+}
+
+TEST_CASE(shop_catalog_cache_revalidates_with_etag)
+{
+    inst::config::shopCatalogCache = true;
+    CachingShop shop;
+    const auto first = shop.Fetch();
+    REQUIRE(first.size() == 4);
+    CHECK(shop.LastValidator().empty());
+
+    // Not modified: the stored sections are served as they were
+    const auto second = shop.Fetch();
+    CHECK_EQ(shop.LastValidator(), shop.etag);
+    CHECK_EQ(shop.server.RequestCount(), (size_t)2);
+    CHECK(ItemUrls(second) == ItemUrls(first));
+
+    std::vector<ShopSection> cached;
+    CHECK(shopInstStuff::LoadCachedShopSections(shop.server.Url(""), "user", "", cached));
+    CHECK(ItemUrls(cached) == ItemUrls(first));
+    // The key covers the credentials, so another login never sees this catalog
+    CHECK(!shopInstStuff::LoadCachedShopSections(shop.server.Url(""), "user", "other", cached));
+    CHECK(cached.empty());
+    CHECK(!shopInstStuff::LoadCachedShopSections(shop.server.Url(""), "other", "", cached));
+    shop.Fetch("other");
+    CHECK(shop.LastValidator().empty());
+}
+
+TEST_CASE(shop_catalog_cache_replaced_by_changed_payload)
+{
+    inst::config::shopCatalogCache = true;
+    CachingShop shop;
+    const auto first = shop.Fetch();
+
+    shop.body = SectionsBody(7);
+    shop.etag = "\"v2\"";
+    const auto changed = shop.Fetch();
+    CHECK_EQ(shop.LastValidator(), std::string("\"v1\""));
+    REQUIRE(changed.size() == 4);
+    CHECK_EQ(changed[0].items.size(), (size_t)7);
+    CHECK(ItemUrls(changed) != ItemUrls(first));
+
+    shop.Fetch();
+    CHECK_EQ(shop.LastValidator(), std::string("\"v2\""));
+    std::vector<ShopSection> cached;
+    CHECK(shopInstStuff::LoadCachedShopSections(shop.server.Url(""), "user", "", cached));
+    CHECK(ItemUrls(cached) == ItemUrls(changed));
+
+    // A payload without validators can't be revalidated, so it replaces nothing and is not kept
+    shop.etag.clear();
+    shop.Fetch();
+    CHECK(!shopInstStuff::LoadCachedShopSections(shop.server.Url(""), "user", "", cached));
+    CHECK(CacheFiles(".json").empty());
+}
+
+TEST_CASE(shop_catalog_cache_drops_corrupt_files)
+{
+    inst::config::shopCatalogCache = true;
+    CachingShop shop;
+    const auto expected = shop.Fetch();
+    const auto bodies = CacheFiles(".body");
+    REQUIRE(bodies.size() == 1);
+    {
+        // Same size, so only parsing it can tell
+        std::fstream body(bodies[0], std::ios::in | std::ios::out | std::ios::binary);
+        body.write("not json", 8);
+    }
+    // Another shop's catalog replaces the parsed copy kept in memory
+    CachingShop other;
+    other.body = SectionsBody(2);
+    other.Fetch();
+
+    // The 304 can't be served from the corrupt body, so the catalog is fetched again in full
+    const size_t before = shop.server.RequestCount();
+    const auto refetched = shop.Fetch();
+    CHECK_EQ(shop.server.RequestCount(), before + 2);
+    CHECK(shop.LastValidator().empty());
+    CHECK(ItemUrls(refetched) == ItemUrls(expected));
+    std::vector<ShopSection> cached;
+    CHECK(shopInstStuff::LoadCachedShopSections(shop.server.Url(""), "user", "", cached));
+
+    // Metadata that doesn't describe the stored body is ignored
+    for (const auto& body : CacheFiles(".body"))
+        std::filesystem::resize_file(body, 16);
+    CHECK(!shopInstStuff::LoadCachedShopSections(shop.server.Url(""), "user", "", cached));
+    for (const auto& meta : CacheFiles(".json"))
+        std::ofstream(meta, std::ios::trunc) << "{\"key\":";
+    CHECK(!shopInstStuff::LoadCachedShopSections(other.server.Url(""), "user", "", cached));
+    shop.Fetch();
+    CHECK(shop.LastValidator().empty());
+}
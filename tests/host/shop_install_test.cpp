@@ -0,0 +1,253 @@
+// Shop XCI installs streamed from a loopback server into the mock content storage: the
+// secure partition must install the original NCAs with their meta committed, and the
+// header reads and the data stream must not download any byte twice. A failed placeholder
+// write must not leave the entry being written behind. Queued NSP items prefetch the next
+// headers while the current one installs, and a failed item must abort those prefetches.
+
+#include "test.hpp"
+
+#include "fixtures.hpp"
+#include "http_server.hpp"
+#include "mock_ncm.hpp"
+#include "ui_stub.hpp"
+
+#include "shopInstall.hpp"
+#include "util/config.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+
+using namespace host::fixtures;
+
+namespace
+{
+    struct ByteRange
+    {
+        size_t first;
+        size_t last;
+    };
+
+    std::vector<ByteRange> ServedRanges(const host::http::Server& server, size_t fileSize)
+    {
+        std::vector<ByteRange> ranges;
+        for (const auto& request : server.Requests()) {
+            if (request.method != "GET")
+                continue;
+            const std::string range = request.Header("range");
+            if (range.rfind("bytes=", 0) != 0) {
+                ranges.push_back({ 0, fileSize - 1 });
+                continue;
+            }
+            const size_t dash = range.find('-');
+            const size_t first = std::strtoull(range.c_str() + 6, nullptr, 10);
+            size_t last = fileSize - 1;
+            if (dash != std::string::npos && dash + 1 < range.size())
+                last = std::min<size_t>(last, std::strtoull(range.c_str() + dash + 1, nullptr, 10));
+            if (first < fileSize)
+                ranges.push_back({ first, last });
+        }
+        return ranges;
+    }
+
+    void InstallFromShop(const std::vector<shopInstStuff::ShopItem>& items)
+    {
+        shopInstStuff::installTitleShop(items, 0, "");
+    }
+
+    shopInstStuff::ShopItem Item(const host::http::Server& server, const std::string& name)
+    {
+        shopInstStuff::ShopItem item;
+        item.name = name;
+        item.url = server.Url("/" + name);
+        item.size = 0;
+        return item;
+    }
+
+    bool InstallFailed()
+    {
+        for (const auto& event : host::ui::Events()) {
+            if (event.kind == host::ui::EventKind::Dialog && event.text.rfind("inst.info_page.failed", 0) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    // Small DLC packages, one per queue item
+    std::map<std::string, std::string> MakeDlcQueue(size_t count, std::vector<Title>& titles)
+    {
+        std::map<std::string, std::string> packages;
+        for (size_t i = 0; i < count; i++) {
+            const u64 titleId = 0x0100000000011000 + i + 1;
+            titles.push_back(MakeTitle({ .titleId = titleId, .type = NcmContentMetaType_AddOnContent, .seed = (u32)(300 + i) }, { 0x9000 }));
+            const std::vector<u8> nsp = MakePfs0(TitleFiles(titles.back(), false));
+            packages["/dlc" + std::to_string(i) + ".nsp"] = std::string(nsp.begin(), nsp.end());
+        }
+        return packages;
+    }
+
+    void CheckInstalled(const Title& title)
+    {
+        CHECK(!InstallFailed());
+        CHECK(host::ncm::ReadRegistered(NcmStorageId_SdCard, title.meta.id) == title.meta.data);
+        for (const Nca& nca : title.contents)
+            CHECK(host::ncm::ReadRegistered(NcmStorageId_SdCard, nca.id) == nca.data);
+        CHECK_EQ(host::ncm::LivePlaceholderCount(), (size_t)0);
+        // Each cnmt is committed as soon as it lands and again once the whole XCI is in
+        const auto metas = host::ncm::MetaRecords();
+        REQUIRE(!metas.empty());
+        for (const auto& meta : metas) {
+            CHECK_EQ(meta.key.id, (u64)0x0100000000010000);
+            CHECK(meta.data == metas[0].data);
+        }
+        CHECK_EQ(host::ncm::MetaCommitCount(), metas.size());
+        const auto apps = host::ncm::ApplicationRecords();
+        REQUIRE(!apps.empty());
+        CHECK_EQ(apps.back().applicationId, (u64)0x0100000000010000);
+    }
+}
+
+TEST_CASE(shop_xci_stream_installs_original_ncas)
+{
+    inst::config::validateNCAs = false;
+    // Larger than the header windows, so the data stream has to carry most of it
+    const Title title = MakeTitle({}, { 0x900000, 0x24000, 0x9000 });
+    const std::vector<u8> xciBytes = MakeXci(TitleFiles(title, false));
+    const std::string xci(xciBytes.begin(), xciBytes.end());
+    host::http::Server server([&](const host::http::Request& request) { return host::http::ServeBytes(request, xci); });
+
+    InstallFromShop({ Item(server, "title.xci") });
+    CheckInstalled(title);
+
+    std::vector<u8> fetched(xci.size(), 0);
+    for (const ByteRange& range : ServedRanges(server, xci.size())) {
+        for (size_t i = range.first; i <= range.last; i++)
+            fetched[i]++;
+    }
+    size_t refetched = 0;
+    for (u8 count : fetched)
+        refetched += count > 1;
+    CHECK_EQ(refetched, (size_t)0);
+}
+
+TEST_CASE(shop_xcz_stream_installs_original_ncas)
+{
+    inst::config::validateNCAs = false;
+    const Title title = MakeTitle({}, { 0x1A2200, 0x24200, 0x9000 });
+    const std::vector<u8> xczBytes = MakeXci(TitleFiles(title, true, NczFormat::Block));
+    const std::string xcz(xczBytes.begin(), xczBytes.end());
+    host::http::Server server([&](const host::http::Request& request) { return host::http::ServeBytes(request, xcz); });
+
+    InstallFromShop({ Item(server, "title.xcz") });
+    CheckInstalled(title);
+}
+
+TEST_CASE(shop_xci_stream_failure_cleans_up)
+{
+    inst::config::validateNCAs = false;
+    const Title title = MakeTitle({}, { 0x900000, 0x9000 });
+    const std::vector<u8> xciBytes = MakeXci(TitleFiles(title, false));
+    const std::string xci(xciBytes.begin(), xciBytes.end());
+    host::http::Server server([&](const host::http::Request& request) { return host::http::ServeBytes(request, xci); });
+
+    // Fails the body of the large content, after the meta has been registered
+    host::ncm::FailWritesAfter(3);
+    InstallFromShop({ Item(server, "title.xci") });
+    CHECK(InstallFailed());
+    CHECK_EQ(host::ncm::LivePlaceholderCount(), (size_t)0);
+    CHECK(!host::ncm::IsRegistered(NcmStorageId_SdCard, title.contents[0].id));
+}
+
+TEST_CASE(shop_queue_prefetch_installs_every_item_once)
+{
+    inst::config::validateNCAs = false;
+    std::vector<Title> titles;
+    const auto packages = MakeDlcQueue(12, titles);
+    host::http::Server server([&](const host::http::Request& request) {
+        auto it = packages.find(request.path);
+        if (it == packages.end()) {
+            host::http::Response response;
+            response.status = 404;
+            return response;
+        }
+        return host::http::ServeBytes(request, it->second);
+    });
+    std::vector<shopInstStuff::ShopItem> items;
+    for (size_t i = 0; i < titles.size(); i++)
+        items.push_back(Item(server, "dlc" + std::to_string(i) + ".nsp"));
+
+    std::map<std::string, size_t> serialRequests;
+    for (int depth : { 0, 2 }) {
+        host::ncm::Reset("ncm-" + std::to_string(depth));
+        host::ui::Reset();
+        inst::config::shopPrefetchDepth = depth;
+        const size_t before = server.RequestCount();
+        InstallFromShop(items);
+
+        CHECK(!InstallFailed());
+        for (const Title& title : titles) {
+            CHECK(host::ncm::ReadRegistered(NcmStorageId_SdCard, title.meta.id) == title.meta.data);
+            CHECK(host::ncm::ReadRegistered(NcmStorageId_SdCard, title.contents[0].id) == title.contents[0].data);
+        }
+        CHECK_EQ(host::ncm::LivePlaceholderCount(), (size_t)0);
+        CHECK_EQ(host::ncm::MetaRecords().size(), titles.size());
+
+        // A prefetched header or cnmt is handed to the install, not downloaded again
+        std::map<std::string, size_t> perItem;
+        const auto requests = server.Requests();
+        for (size_t i = before; i < requests.size(); i++)
+            perItem[requests[i].path]++;
+        if (depth == 0)
+            serialRequests = perItem;
+        else
+            CHECK(perItem == serialRequests);
+    }
+}
+
+TEST_CASE(shop_queue_failure_aborts_stalled_prefetch)
+{
+    inst::config::validateNCAs = false;
+    inst::config::shopPrefetchDepth = 2;
+    std::vector<Title> titles;
+    const auto packages = MakeDlcQueue(3, titles);
+
+    // The header of the second item stalls until the test ends
+    std::mutex mutex;
+    std::condition_variable released;
+    bool release = false;
+    host::http::Server server([&](const host::http::Request& request) {
+        host::http::Response response;
+        if (request.path == "/dlc0.nsp") {
+            response.status = 404;
+            return response;
+        }
+        response = host::http::ServeBytes(request, packages.at(request.path));
+        if (request.path == "/dlc1.nsp") {
+            response.pauseAfter = 0;
+            response.onPause = [&]() {
+                std::unique_lock<std::mutex> lock(mutex);
+                released.wait_for(lock, std::chrono::seconds(30), [&]() { return release; });
+            };
+        }
+        return response;
+    });
+    std::vector<shopInstStuff::ShopItem> items;
+    for (size_t i = 0; i < titles.size(); i++)
+        items.push_back(Item(server, "dlc" + std::to_string(i) + ".nsp"));
+
+    const auto start = std::chrono::steady_clock::now();
+    InstallFromShop(items);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        release = true;
+    }
+    released.notify_all();
+
+    CHECK(InstallFailed());
+    CHECK(seconds < 5.0);
+    CHECK(host::ncm::Registered(NcmStorageId_SdCard).empty());
+    CHECK_EQ(host::ncm::LivePlaceholderCount(), (size_t)0);
+}
@@ -0,0 +1,68 @@
+// Minimal test registry for the host tests. Each TEST_CASE runs in its own forked process
+// from an empty working directory with sdmc:/switch/CyberFoil created, so config globals,
+// crypto caches and the mock content storage start fresh every time.
+#pragma once
+
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace host::test
+{
+    struct Case
+    {
+        const char* name;
+        void (*fn)();
+    };
+
+    std::vector<Case>& Registry();
+
+    struct Registrar
+    {
+        Registrar(const char* name, void (*fn)()) { Registry().push_back({ name, fn }); }
+    };
+
+    // Thrown by REQUIRE to stop the current test
+    struct Abort {};
+
+    void ReportFailure(const char* file, int line, const std::string& message);
+    int FailureCount();
+
+    template<typename A, typename B>
+    std::string DescribeMismatch(const char* expr, const A& a, const B& b)
+    {
+        std::ostringstream out;
+        out << expr << " (" << a << " vs " << b << ")";
+        return out.str();
+    }
+}
+
+#define HOST_TEST_CONCAT2(a, b) a##b
+#define HOST_TEST_CONCAT(a, b) HOST_TEST_CONCAT2(a, b)
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static host::test::Registrar HOST_TEST_CONCAT(name, _registrar)(#name, name); \
+    static void name()
+
+#define CHECK(expr) \
+    do { if (!(expr)) host::test::ReportFailure(__FILE__, __LINE__, #expr); } while (0)
+
+#define REQUIRE(expr) \
+    do { if (!(expr)) { host::test::ReportFailure(__FILE__, __LINE__, #expr); throw host::test::Abort(); } } while (0)
+
+#define CHECK_EQ(a, b) \
+    do { \
+        const auto& host_test_a = (a); const auto& host_test_b = (b); \
+        if (!(host_test_a == host_test_b)) \
+            host::test::ReportFailure(__FILE__, __LINE__, host::test::DescribeMismatch(#a " == " #b, host_test_a, host_test_b)); \
+    } while (0)
+
+#define CHECK_THROWS(expr) \
+    do { \
+        bool host_test_threw = false; \
+        try { expr; } catch (const std::exception&) { host_test_threw = true; } \
+        if (!host_test_threw) host::test::ReportFailure(__FILE__, __LINE__, "expected exception: " #expr); \
+    } while (0)
@@ -0,0 +1,116 @@
+// Runs every registered TEST_CASE (or those whose name contains one of the arguments)
+// in a child process and reports a summary; the exit code is non-zero if any test failed.
+
+#include "test.hpp"
+
+#include "mock_ncm.hpp"
+#include "ui_stub.hpp"
+#include "util/config.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace host::test
+{
+    namespace
+    {
+        int g_failures = 0;
+    }
+
+    std::vector<Case>& Registry()
+    {
+        static std::vector<Case> cases;
+        return cases;
+    }
+
+    void ReportFailure(const char* file, int line, const std::string& message)
+    {
+        g_failures++;
+        std::fprintf(stderr, "    %s:%d: CHECK failed: %s\n", file, line, message.c_str());
+    }
+
+    int FailureCount()
+    {
+        return g_failures;
+    }
+}
+
+namespace
+{
+    bool Selected(const char* name, int argc, char** argv)
+    {
+        if (argc < 2)
+            return true;
+        for (int i = 1; i < argc; i++) {
+            if (std::strstr(name, argv[i]) != nullptr)
+                return true;
+        }
+        return false;
+    }
+
+    int RunInChild(const host::test::Case& testCase, const std::filesystem::path& dir)
+    {
+        std::filesystem::create_directories(dir / "sdmc:/switch/CyberFoil");
+        if (chdir(dir.c_str()) != 0)
+            return 1;
+
+        host::ncm::Reset((dir / "ncm").string());
+        host::ui::Reset();
+
+        try {
+            // Defaults as on a fresh console; there is no config file in the test directory
+            inst::config::parseConfig();
+            testCase.fn();
+        }
+        catch (const host::test::Abort&) {
+        }
+        catch (const std::exception& e) {
+            host::test::ReportFailure(__FILE__, __LINE__, std::string("unexpected exception: ") + e.what());
+        }
+        return host::test::FailureCount() == 0 ? 0 : 1;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    char rootTemplate[] = "/tmp/cyberfoil-host-tests-XXXXXX";
+    if (mkdtemp(rootTemplate) == nullptr) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+    const std::filesystem::path root(rootTemplate);
+
+    int run = 0;
+    int failed = 0;
+    for (const host::test::Case& testCase : host::test::Registry()) {
+        if (!Selected(testCase.name, argc, argv))
+            continue;
+        run++;
+
+        const auto start = std::chrono::steady_clock::now();
+        std::fflush(stdout);
+        std::fflush(stderr);
+        const pid_t pid = fork();
+        if (pid == 0)
+            _exit(RunInChild(testCase, root / testCase.name));
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        const bool passed = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        if (!passed) {
+            failed++;
+            if (WIFSIGNALED(status))
+                std::fprintf(stderr, "    killed by signal %d\n", WTERMSIG(status));
+        }
+        std::printf("[%s] %s (%lld ms)\n", passed ? "  OK  " : " FAIL ", testCase.name, (long long)elapsed);
+    }
+
+    std::filesystem::remove_all(root);
+    std::printf("%d/%d tests passed\n", run - failed, run);
+    return failed == 0 ? 0 : 1;
+}
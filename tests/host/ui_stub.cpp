@@ -0,0 +1,125 @@
+// Host install page and MainApplication. Muting and the per-thread progress sink behave
+// like source/ui/instPage.cpp; everything that would reach the screen is recorded instead.
+
+#include "ui_stub.hpp"
+
+#include "ui/MainApplication.hpp"
+#include "ui/instPage.hpp"
+
+#include <mutex>
+
+namespace
+{
+    std::mutex g_eventsMutex;
+    std::vector<host::ui::Event> g_events;
+    int g_dialogAnswer = 0;
+    std::atomic<bool> g_installCancelRequested(false);
+    thread_local bool g_progressMuted = false;
+    thread_local std::atomic<double>* g_progressSink = nullptr;
+
+    void Record(host::ui::EventKind kind, const std::string& text, double percent = 0.0)
+    {
+        std::lock_guard<std::mutex> lock(g_eventsMutex);
+        g_events.push_back({ kind, text, percent, std::this_thread::get_id() });
+    }
+}
+
+namespace host::ui
+{
+    void Reset()
+    {
+        std::lock_guard<std::mutex> lock(g_eventsMutex);
+        g_events.clear();
+        g_dialogAnswer = 0;
+        g_installCancelRequested.store(false);
+    }
+
+    std::vector<Event> Events()
+    {
+        std::lock_guard<std::mutex> lock(g_eventsMutex);
+        return g_events;
+    }
+
+    void SetDialogAnswer(int answer)
+    {
+        std::lock_guard<std::mutex> lock(g_eventsMutex);
+        g_dialogAnswer = answer;
+    }
+}
+
+namespace inst::ui
+{
+    MainApplication g_hostApp;
+    MainApplication *mainApp = &g_hostApp;
+
+    int MainApplication::CreateShowDialog(const std::string& title, const std::string& content, const std::vector<std::string>& opts, bool useLastOptionAsCancel, const std::string& icon)
+    {
+        (void)content; (void)opts; (void)useLastOptionAsCancel; (void)icon;
+        Record(host::ui::EventKind::Dialog, title);
+        std::lock_guard<std::mutex> lock(g_eventsMutex);
+        return g_dialogAnswer;
+    }
+
+    void MainApplication::CallForRender() {}
+    void MainApplication::RefreshInputDevice(bool force) { (void)force; }
+    void MainApplication::UpdateButtons() {}
+    u64 MainApplication::GetButtonsDown() { return 0; }
+
+    void instPage::setTopInstInfoText(std::string ourText){
+        Record(host::ui::EventKind::TopInfoText, ourText);
+    }
+
+    void instPage::setInstInfoText(std::string ourText){
+        if (g_progressMuted) return;
+        Record(host::ui::EventKind::InfoText, ourText);
+    }
+
+    void instPage::setInstBarPerc(double ourPercent){
+        if (g_progressMuted) {
+            if (g_progressSink != nullptr)
+                g_progressSink->store(ourPercent, std::memory_order_relaxed);
+            return;
+        }
+        Record(host::ui::EventKind::BarPercent, "", ourPercent);
+    }
+
+    void instPage::setProgressDetailText(const std::string& ourText){
+        if (g_progressMuted) return;
+        Record(host::ui::EventKind::DetailText, ourText);
+    }
+
+    void instPage::clearProgressDetailText(){
+        if (g_progressMuted) return;
+        Record(host::ui::EventKind::ClearDetailText, "");
+    }
+
+    void instPage::setInstallIconFromTitleId(u64 titleId){ (void)titleId; }
+    void instPage::setInstallIcon(const std::string& imagePath){ (void)imagePath; }
+    void instPage::setInstallIconData(const void* imageData, std::uint32_t imageSize){ (void)imageData; (void)imageSize; }
+    void instPage::clearInstallIcon(){}
+    void instPage::loadMainMenu(){}
+
+    void instPage::loadInstallScreen(){
+        g_installCancelRequested.store(false);
+    }
+
+    void instPage::requestInstallCancel(){
+        g_installCancelRequested.store(true);
+    }
+
+    bool instPage::isInstallCancelRequested(){
+        return g_installCancelRequested.load();
+    }
+
+    void instPage::clearInstallCancel(){
+        g_installCancelRequested.store(false);
+    }
+
+    void instPage::setProgressMutedOnThisThread(bool muted){
+        g_progressMuted = muted;
+    }
+
+    void instPage::setProgressSinkOnThisThread(std::atomic<double>* sink){
+        g_progressSink = sink;
+    }
+}
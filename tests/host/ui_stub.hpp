@@ -0,0 +1,34 @@
+// Test controls for the host install page and MainApplication (ui_stub.cpp). Every
+// visible progress update is recorded with the thread that made it, so tests can check
+// which thread drives the UI during an install.
+#pragma once
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace host::ui
+{
+    enum class EventKind
+    {
+        TopInfoText,
+        InfoText,
+        BarPercent,
+        DetailText,
+        ClearDetailText,
+        Dialog,
+    };
+
+    struct Event
+    {
+        EventKind kind;
+        std::string text;
+        double percent;
+        std::thread::id thread;
+    };
+
+    void Reset();
+    std::vector<Event> Events();
+    // Answer returned by every CreateShowDialog until the next Reset (default 0)
+    void SetDialogAnswer(int answer);
+}